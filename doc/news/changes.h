@@ -277,6 +277,243 @@ inconvenience this causes.
 <h3>Specific improvements</h3>
 
 <ol>
+  <li> Improved: DataOutFaces and DataOutRotation now generate the faces and cells for which they create patches on the fly rather than collecting them in a list first. On parallel::distributed::Triangulation objects they only create patches for locally owned cells, so their output can be written with DataOutInterface::write_vtu_in_parallel(). Cell data is now looked up without a linear search over all previous cells.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DataOut can now restrict output to selected cells through
+  DataOut::set_cell_selection(), DataOut::select_cells_in_box() and
+  DataOut::select_cells_with_material_id(), produce output on a coarser
+  level of the mesh through DataOut::set_output_level(), and choose the
+  number of subdivisions per cell through DataOut::set_cell_subdivisions().
+  Output on non-active cells, which the documentation of DataOut::first_cell()
+  has always promised, now also works in debug mode.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DataOutBase::Deal_II_IntermediateFlags::binary selects a binary
+  version of the intermediate format that DataOutReader::read() recognizes
+  automatically and reads in contiguous blocks. The new function
+  DataOutReader::write_merged_vtu() combines several intermediate format
+  files into one VTU file with one piece per file, holding only one of
+  them in memory at a time.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: The members DataOutBase::VtkFlags::coordinate_precision,
+  DataOutBase::VtkFlags::data_precision and
+  DataOutBase::VtkFlags::field_precision allow to write point coordinates
+  and all or individual fields to VTU files as 32 bit instead of 64 bit
+  floating point numbers.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DataOut::write_vtu_in_pieces() builds the patches for groups of cells
+  and writes each group as a piece of a VTU file right away, so that only the
+  patches of one group are held in memory at any given time.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: The flag DataOutBase::VtkFlags::filter_duplicate_vertices makes VTU
+  output write points that are shared between neighboring patches only once,
+  and lets the connectivity of the cells refer to these merged points. For
+  continuous fields on patches that are not subdivided, this makes output
+  files about four (2d) to eight (3d) times smaller. The points are merged
+  in the writer, so the memory used by the patches is not reduced.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: The class XDMFTimeSeries writes the output of all time steps of a
+  simulation into a single HDF5 file with chunked and optionally compressed
+  datasets, and keeps one XDMF file describing all of them up to date. The
+  mesh is only written again if it has changed since the previous time step.
+  XDMFEntry::set_hdf5_groups() allows XDMF entries to reference datasets in
+  HDF5 groups.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> Improved: DataOutInterface::write_vtu_in_parallel() now generates the
+  piece of each process in a local buffer, computes the file offsets with a
+  prefix sum, and writes all pieces with one collective MPI-IO call instead
+  of going through the shared file pointer. A new optional argument
+  requests a given number of I/O aggregator processes.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DataOutInterface::write_vtu_in_background() copies the patches and
+  writes them to a VTU file on a separate task, so that the program can
+  prepare the next output or continue its computations while the data is
+  compressed and written. A bounded number of outputs may be in progress at
+  the same time. DataOutInterface::wait_for_background_output() waits for
+  all of them.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DataOutBase::VtkFlags now has a member <code>compression_level</code>
+  that selects the zlib compression level for VTU files. DataOutBase::write_vtu
+  also splits data arrays into blocks of 1 MB that are compressed and
+  base64-encoded in parallel, using the multi-block header of the VTK zlib
+  compressor.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> Improved: KellyErrorEstimator::estimate now stores the face integrals in a
+  flat array indexed by the face index instead of a std::map. The threads
+  write to it directly, without a serialized copier stage, and no longer
+  allocate memory for each face.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> Improved: parallel::distributed::GridRefinement::refine_and_coarsen_fixed_number
+  now computes its thresholds with a histogram-based selection on the
+  binary representation of the indicators. It needs four global reductions
+  instead of up to 50 rounds of broadcasts and reductions, counts the local
+  indicators in parallel, and finds the thresholds exactly.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: parallel::distributed::Triangulation has a new signal cell_weight
+  that allows to assign a weight to each cell. If functions are connected to
+  it, the mesh is partitioned so that all processors receive the same total
+  weight instead of the same number of cells. The weights are used in
+  execute_coarsening_and_refinement(), in load(), and in the new function
+  parallel::distributed::Triangulation::repartition().
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: parallel::distributed::Triangulation has a new setting
+  share_coarse_connectivity_within_node. If it is set, only one process per
+  node builds the p4est connectivity of the coarse mesh and places it into
+  an MPI-3 shared memory window that all other processes of the node use.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: Triangulation::save_snapshot() and Triangulation::load_snapshot()
+  as well as the corresponding functions of DoFHandler write and read the
+  same data as the BOOST serialization functions, but in a flat binary
+  format that stores all arrays as contiguous blocks. This makes
+  checkpointing large meshes and their degree of freedom numbering
+  considerably faster.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: GridReordering::is_consistent() checks in a single, parallel pass
+  whether the cells of a mesh are already consistently oriented.
+  GridReordering<3>::reorder_cells() now uses this check to skip the
+  reordering for meshes that need none, and builds its edge table with
+  per-vertex buckets instead of a std::map.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: GridIn::read_msh() can now read version 2 Gmsh files stored in
+  binary form. Vertex numbers are now translated through a table instead of
+  a std::map when the numbering is not too sparse, which speeds up reading
+  large meshes in both the ASCII and the binary format.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: Manifold::get_new_point() now has a variant that takes the
+  surrounding points and weights as plain arrays, and
+  Manifold::get_new_points() computes many new points from the same
+  surrounding points at once. The default get_new_point_on_line(),
+  get_new_point_on_quad() and get_new_point_on_hex() functions, as well as
+  mesh refinement, use arrays on the stack. For StraightBoundary,
+  SphericalManifold and CylindricalManifold, which opt in to the array
+  interface, no memory is allocated for each new vertex any more. Other
+  classes derived from FlatManifold or ChartManifold can opt in by setting
+  the protected member Manifold::use_array_interface in their constructor.
+  ChartManifold pulls back the surrounding points only once in
+  get_new_points(), and its new functions pull_back_points() and
+  push_forward_points() can be overloaded to transform many points at once.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> Improved: Incrementing an active cell iterator now scans the used
+  flags and children arrays of the triangulation levels directly instead of
+  visiting each skipped object through the accessor, which makes loops over
+  active cells of adaptively refined meshes cheaper.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> Improved: Triangulation::execute_coarsening_and_refinement() now asks the
+  manifold descriptions for the new vertices on refined lines in parallel if
+  all of them declare themselves thread safe, see Manifold::is_thread_safe(),
+  and checks the children of refined cells for distortion in parallel.
+  FlatManifold, StraightBoundary, SphericalManifold and CylindricalManifold
+  are thread safe; other classes can opt in by setting the protected member
+  Manifold::thread_safe in their constructor.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DoFHandler::redistribute_dofs() distributes degrees of freedom after
+  the triangulation has been refined or coarsened while keeping the
+  numbering of all degrees of freedom on cells that did not change, and
+  returns a map from old to new indices. This requires to call
+  DoFHandler::set_incremental_dof_distribution() before the mesh is
+  changed.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> Improved: DoFHandler::distribute_dofs() for sequential and parallel
+  distributed triangulations now enumerates the degrees of freedom on
+  chunks of cells in parallel, using the prefix sum of the number of
+  degrees of freedom per chunk as starting index for each chunk. The
+  resulting numbering is the same as before. Updating the cache of DoF
+  indices on cells after distributing and renumbering degrees of freedom
+  is also done in parallel.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DoFHandler::set_compressed_dof_indices_cache() allows to store
+  the cache of DoF indices on active cells as 32-bit differences to one
+  offset per batch of cells. This halves the memory consumption of the
+  cache when deal.II is configured with 64-bit indices.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> Improved: SparsityTools::reorder_Cuthill_McKee() now determines the
+  next front of the algorithm and the coordination numbers of its members
+  in parallel, and no longer has cost quadratic in the front size when
+  removing already numbered indices. DoFRenumbering::Cuthill_McKee() on
+  distributed triangulations builds the connectivity graph of the locally
+  owned degrees of freedom directly in the local index space. The
+  resulting numberings are unchanged.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
+  <li> New: DoFRenumbering::matrix_free_data_locality() numbers the degrees
+  of freedom in the order in which MatrixFree::cell_loop() first accesses
+  them, and places locally owned degrees of freedom that are ghosts on other
+  processors into one contiguous range. This improves the cache locality of
+  vector access in matrix-free operator evaluation.
+  <br>
+  (agent, 2026/10/19)
+  </li>
+
   <li> Optimize construction of high-order FE_Nedelec by moving out some 
   non-essential computations. Namely, construct restriction and prolongation 
   matrices on first request. This reduces time spent in FE_Nedelec constructor
@@ -23,13 +23,18 @@
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/std_cxx1x/tuple.h>
+#include <deal.II/base/thread_management.h>
 
 #include <vector>
+#include <list>
+#include <map>
 #include <string>
 #include <limits>
 
 #include <deal.II/base/mpi.h>
 
+#include <boost/serialization/version.hpp>
+
 // Only include the Tecplot API header if the appropriate files
 // were detected by configure
 #ifdef DEAL_II_HAVE_TECPLOT
@@ -981,12 +986,135 @@ namespace DataOutBase
       */
     bool print_date_and_time;
 
+    /**
+     * A data type providing the different possible zlib compression
+     * levels. These map directly to constants defined by zlib.
+     */
+    enum ZlibCompressionLevel
+    {
+      /**
+       * Do not use any compression.
+       */
+      no_compression,
+      /**
+       * Use the fastest available compression algorithm.
+       */
+      best_speed,
+      /**
+       * Use the algorithm which results in the smallest compressed
+       * files.
+       */
+      best_compression,
+      /**
+       * Use the default compression algorithm. This is a compromise
+       * between speed and file size.
+       */
+      default_compression
+    };
+
+    /**
+     * Flag determining the compression level at which zlib, if
+     * available, is run when writing VTU files. The data arrays are
+     * cut into blocks of fixed size that are compressed
+     * independently and in parallel, so the choice of level mostly
+     * trades the size of the output file against the time spent in
+     * writing it.
+     *
+     * The default is <tt>best_compression</tt>.
+     */
+    ZlibCompressionLevel compression_level;
+
+    /**
+     * Flag determining whether points that are shared between
+     * neighboring patches are written only once when writing VTU
+     * files. By default, every patch writes all of its points and the
+     * data values there, so that a vertex of the mesh appears once for
+     * each of the cells adjacent to it, i.e., up to eight times in 3d.
+     * If this flag is set, points with identical coordinates are merged
+     * using a DataOutFilter, and the connectivity of the cells refers to
+     * the merged points. If the patches are not subdivided, i.e., if
+     * DataOut::build_patches() was called with
+     * <tt>n_subdivisions==1</tt>, this reduces the number of points and
+     * the size of the point data by a factor of about four in 2d and
+     * eight in 3d. For subdivided patches, only the points on the
+     * boundaries of the patches are shared, and the saving is
+     * correspondingly smaller.
+     *
+     * The points are merged while the file is written. The patches
+     * themselves still store every point once per patch, so this flag
+     * does not reduce the memory used by DataOut::build_patches().
+     *
+     * Since only one value can be written per point, the value of one
+     * of the adjacent patches is chosen arbitrarily at merged points.
+     * This flag should therefore only be set if all output fields are
+     * continuous, as is the case for the solution of FE_Q elements.
+     *
+     * The default is <tt>false</tt>.
+     */
+    bool filter_duplicate_vertices;
+
+    /**
+     * A data type providing the floating point formats in which
+     * coordinates and data values can be written to VTU files.
+     */
+    enum OutputPrecision
+    {
+      /**
+       * Write values as 64 bit floating point numbers
+       * (<tt>Float64</tt>).
+       */
+      double_precision,
+      /**
+       * Write values as 32 bit floating point numbers
+       * (<tt>Float32</tt>). This halves the size of the respective
+       * arrays and is usually sufficient for visualization.
+       */
+      single_precision
+    };
+
+    /**
+     * The precision in which the coordinates of points are written to
+     * VTU files.
+     *
+     * The default is <tt>double_precision</tt>.
+     */
+    OutputPrecision coordinate_precision;
+
+    /**
+     * The precision in which data values are written to VTU files,
+     * unless a different precision is given for a field in
+     * #field_precision.
+     *
+     * The default is <tt>double_precision</tt>.
+     */
+    OutputPrecision data_precision;
+
+    /**
+     * The precision of individual fields, overriding #data_precision.
+     * The keys are the names of the fields as they appear in the output
+     * file, i.e., the name of a scalar field, or the name of a field
+     * that is declared as a vector (see
+     * DataComponentInterpretation).
+     *
+     * The map is empty by default.
+     */
+    std::map<std::string,OutputPrecision> field_precision;
+
+    /**
+     * Return the precision in which the field with the given name is
+     * written, i.e., its entry in #field_precision if there is one, or
+     * #data_precision otherwise.
+     */
+    OutputPrecision get_precision (const std::string &field_name) const;
+
     /**
      * Default constructor.
      */
     VtkFlags (const double       time   = std::numeric_limits<double>::min(),
               const unsigned int cycle  = std::numeric_limits<unsigned int>::min(),
-              const bool print_date_and_time = true);
+              const bool print_date_and_time = true,
+              const ZlibCompressionLevel compression_level = best_compression,
+              const bool filter_duplicate_vertices = false);
 
     /**
      * Declare the flags with name and type as offered by this class,
@@ -1007,9 +1135,10 @@ namespace DataOutBase
      * set the flags for this output format accordingly.
      *
      * The flags thus obtained overwrite all previous contents of this
-     * object.
+     * object, except for #time, #cycle and the per-field precisions in
+     * #field_precision, which are not declared as parameters.
      */
-    void parse_parameters (const ParameterHandler &prm) const;
+    void parse_parameters (const ParameterHandler &prm);
 
     /**
      * Determine an estimate for the memory consumption (in bytes) of
@@ -1106,19 +1235,27 @@ namespace DataOutBase
      */
     static const unsigned int format_version = 3;
 
-  private:
     /**
-     * Dummy entry to suppress compiler warnings when copying an empty
-     * structure. Remove this member when adding the first flag to
-     * this structure (and remove the <tt>private</tt> as well).
+     * Whether to write the patches in a binary rather than a text
+     * representation. Only the first few lines of the file, which
+     * DataOutBase::determine_intermediate_format_dimensions() and
+     * DataOutReader::read() use to identify the file, are written as
+     * text; everything else is written as a sequence of contiguous
+     * blocks of bytes that can be read back without any parsing. This
+     * makes both writing and reading much faster and the files
+     * considerably smaller. On the other hand, binary files can only
+     * be read on machines with the same byte order and sizes of
+     * fundamental types as the one that wrote them, and the streams
+     * used for writing and reading need to be opened in binary mode.
+     *
+     * Default: <tt>false</tt>.
      */
-    int dummy;
+    bool binary;
 
-  public:
     /**
      * Constructor.
      */
-    Deal_II_IntermediateFlags ();
+    Deal_II_IntermediateFlags (const bool binary = false);
 
     /**
      * Declare all flags with name and type as offered by this class,
@@ -1133,7 +1270,7 @@ namespace DataOutBase
      * The flags thus obtained overwrite
      * all previous contents of this object.
      */
-    void parse_parameters (const ParameterHandler &prm) const;
+    void parse_parameters (const ParameterHandler &prm);
 
     /**
      * Determine an estimate for the memory consumption (in bytes) of
@@ -2150,9 +2287,10 @@ public:
   DataOutInterface ();
 
   /**
-   * Destructor. Does nothing, but is
-   * declared virtual since this class has
-   * virtual functions.
+   * Destructor. Waits for all output
+   * started by write_vtu_in_background()
+   * to finish. It is declared virtual since
+   * this class has virtual functions.
    */
   virtual ~DataOutInterface ();
 
@@ -2278,8 +2416,92 @@ public:
    * performance on parallel filesystems.
    * Also see
    * DataOutInterface::write_vtu().
-   */
-  void write_vtu_in_parallel (const char *filename, MPI_Comm comm) const;
+   *
+   * Every process first generates its
+   * part of the file in memory. The
+   * offsets of the parts within the file
+   * are then computed by a prefix sum over
+   * their sizes, and all parts are written
+   * with one collective write operation.
+   * If @p n_aggregators is nonzero, the
+   * MPI-IO implementation is asked to
+   * gather the data on this many processes
+   * before writing it to the file system,
+   * which can be considerably faster on
+   * large machines. The default value of
+   * zero leaves this choice to the MPI
+   * implementation.
+   */
+  void write_vtu_in_parallel (const char *filename,
+                              MPI_Comm comm,
+                              const unsigned int n_aggregators = 0) const;
+
+  /**
+   * Write the data obtained through
+   * get_patches() to the file with the
+   * given name in Vtu format, like
+   * write_vtu(), but do so on a separate
+   * task so that the calling program can
+   * continue its computations while the
+   * data is formatted, compressed and
+   * written to disk.
+   *
+   * To this end, the function copies the
+   * patches and everything else needed for
+   * output into a buffer owned by the
+   * task before it returns. The object can
+   * therefore be reused right away, for
+   * example by calling build_patches() for
+   * the next time step, while the previous
+   * output is still in progress.
+   *
+   * Since every pending output holds a
+   * copy of its patches, the number of
+   * outputs that are in progress at the
+   * same time is limited by
+   * @p max_pending_writes: if that many
+   * are still running when this function is
+   * called, it first waits for the oldest
+   * one to finish. The default of two
+   * amounts to double buffering, where one
+   * output is written while the next one
+   * is being prepared.
+   *
+   * The returned task can be used to wait
+   * for this particular output to finish,
+   * see also
+   * wait_for_background_output(). The
+   * destructor of this class waits for all
+   * outputs that are still in progress.
+   *
+   * The file is opened by this function
+   * on the calling thread, so an
+   * ExcFileNotOpen exception if it can
+   * not be opened is thrown here and can
+   * be caught by the caller. Errors that
+   * occur while the data is written, on
+   * the other hand, happen on the
+   * background task and can not be caught
+   * by the caller: like any exception on a
+   * task, they abort the program.
+   *
+   * @note The output is written by a
+   * thread of this process. To write a
+   * single file from all processes of a
+   * parallel computation, use
+   * write_vtu_in_parallel() instead, which
+   * needs to be called at the same time on
+   * all processes.
+   */
+  Threads::Task<void>
+  write_vtu_in_background (const std::string &filename,
+                           const unsigned int max_pending_writes = 2);
+
+  /**
+   * Wait for all output started by
+   * write_vtu_in_background() to finish.
+   */
+  void wait_for_background_output ();
 
   /**
    * Some visualization programs, such as
@@ -2712,6 +2934,13 @@ protected:
   std::vector<std_cxx1x::tuple<unsigned int, unsigned int, std::string> >
   get_vector_data_ranges () const;
 
+  /**
+   * Return the flags that are used for output in VTK and VTU format.
+   * Derived classes that write VTU output of their own, such as
+   * DataOut::write_vtu_in_pieces(), use them.
+   */
+  const DataOutBase::VtkFlags &get_vtk_flags () const;
+
   /**
    * The default number of subdivisions for patches. This is filled by
    * parse_parameters() and should be obeyed by build_patches() in
@@ -2792,6 +3021,12 @@ private:
    * function.
    */
   DataOutBase::Deal_II_IntermediateFlags     deal_II_intermediate_flags;
+
+  /**
+   * The tasks started by write_vtu_in_background() that may not yet
+   * have finished, in the order in which they were started.
+   */
+  std::list<Threads::Task<void> > background_output;
 };
 
 
@@ -2854,6 +3089,11 @@ public:
    * Read a sequence of patches as written previously by
    * <tt>DataOutBase::write_deal_II_intermediate</tt> and store them
    * in the present object. This overwrites any previous content.
+   *
+   * Both the text and the binary version of the intermediate format
+   * are recognized automatically. In the latter case, the patch data
+   * is read in contiguous blocks directly into its final storage; the
+   * stream then needs to have been opened in binary mode.
    */
   void read (std::istream &in);
 
@@ -2884,6 +3124,26 @@ public:
    */
   void merge (const DataOutReader<dim,spacedim> &other);
 
+  /**
+   * Combine the intermediate format files with the given names into a
+   * single VTU file that is written to @p out. Each of the files, for
+   * example the ones written by the individual processes of a
+   * parallel program, ends up as a separate <tt>Piece</tt> of the
+   * output. In contrast to reading all files and merging them with
+   * merge() before writing the result, only one of the files is held
+   * in memory at any given time, and the patches it contains are
+   * written out exactly as they were read, without renumbering them.
+   *
+   * All files need to have the same data set names and vector data
+   * ranges. They may be written in either the text or the binary
+   * version of the intermediate format (see
+   * DataOutBase::Deal_II_IntermediateFlags::binary).
+   */
+  static
+  void write_merged_vtu (const std::vector<std::string> &filenames,
+                         std::ostream                   &out,
+                         const DataOutBase::VtkFlags    &flags = DataOutBase::VtkFlags());
+
   /**
    * Exception
    */
@@ -2985,6 +3245,8 @@ private:
   bool                                valid;
   /// The name of the HDF5 heavy data solution and/or mesh files this entry references
   std::string                         h5_sol_filename, h5_mesh_filename;
+  /// The HDF5 groups within these files that hold the solution and mesh datasets
+  std::string                         h5_sol_group, h5_mesh_group;
   /// The simulation time associated with this entry
   double                              entry_time;
   /// The number of nodes, cells and dimensionality associated with the data
@@ -3013,6 +3275,21 @@ public:
     attribute_dims[attr_name] = dimension;
   }
 
+  /**
+   * Set the HDF5 groups in which the mesh and solution datasets of this
+   * entry are stored. By default, both are stored at the root of their
+   * files, i.e., the datasets are referenced as <tt>file:/nodes</tt>
+   * etc. If a group <tt>/mesh_0</tt> is given for the mesh, they are
+   * referenced as <tt>file:/mesh_0/nodes</tt> instead. This allows to
+   * store several meshes and time steps in a single file, see
+   * XDMFTimeSeries.
+   */
+  void set_hdf5_groups(const std::string &mesh_group, const std::string &solution_group)
+  {
+    h5_mesh_group = mesh_group;
+    h5_sol_group = solution_group;
+  }
+
   /**
    * Read or write the data of this object for serialization
    */
@@ -3027,6 +3304,17 @@ public:
     &num_cells
     &dimension
     &attribute_dims;
+
+    // the HDF5 groups were added in version 1 of this class. entries
+    // stored by earlier versions reference the roots of their files
+    if (version >= 1)
+      ar &h5_sol_group
+      &h5_mesh_group;
+    else
+      {
+        h5_sol_group.clear();
+        h5_mesh_group.clear();
+      }
   }
 
   /// Get the XDMF content associated with this entry.
@@ -3036,6 +3324,129 @@ public:
 
 
 
+/**
+ * A class that writes a time series of output data to a single HDF5 file
+ * and keeps an XDMF file up to date that describes all time steps
+ * written so far. In contrast to writing one HDF5 file per time step with
+ * DataOutInterface::write_hdf5_parallel(), the mesh is only stored when
+ * it has changed since the previous time step; all other time steps
+ * reference the mesh that was last written. For simulations on a fixed
+ * mesh, the output for every time step thus only consists of the
+ * solution values, which typically are a small fraction of the size of
+ * the mesh data.
+ *
+ * Within the HDF5 file, the mesh is stored in groups <tt>/mesh_0</tt>,
+ * <tt>/mesh_1</tt>, ..., each containing datasets <tt>nodes</tt> and
+ * <tt>cells</tt>, and the data of time step @p n is stored in the
+ * group <tt>/step_n</tt> with one dataset per output field. All datasets
+ * are chunked, and can be compressed using zlib if HDF5 supports this
+ * and the output is written from a single process (parallel HDF5 cannot
+ * write compressed datasets).
+ *
+ * Whether the mesh has changed is determined by comparing a checksum of
+ * the node locations and the connectivity each process writes with the
+ * one of the previous time step. This class can be used as follows:
+ * @code
+ *   XDMFTimeSeries<dim> time_series ("solution.h5", "solution.xdmf",
+ *                                    MPI_COMM_WORLD);
+ *   for (; time<end_time; time+=time_step)
+ *     {
+ *       ...solve...
+ *       DataOut<dim> data_out;
+ *       ...
+ *       data_out.build_patches ();
+ *       time_series.write_time_step (data_out, time);
+ *     }
+ * @endcode
+ *
+ * After each time step, the HDF5 file is closed and the XDMF file is
+ * rewritten, so that the output of all time steps written so far can be
+ * visualized while the simulation is still running, and is not lost if
+ * the program terminates prematurely.
+ *
+ * This class requires that deal.II was configured with HDF5 support.
+ *
+ * @ingroup output
+ */
+template <int dim, int spacedim=dim>
+class XDMFTimeSeries
+{
+public:
+  /**
+   * Constructor. Time steps are written to the HDF5 file @p h5_filename
+   * which is described by the XDMF file @p xdmf_filename. Both files are
+   * created, or overwritten if they exist, upon the first call to
+   * write_time_step().
+   *
+   * @p compression_level is the zlib compression level between 0 (no
+   * compression) and 9 used for all datasets, and @p chunk_size the
+   * number of rows (i.e. nodes or cells) per chunk of the datasets.
+   */
+  XDMFTimeSeries (const std::string  &h5_filename,
+                  const std::string  &xdmf_filename,
+                  MPI_Comm            comm,
+                  const unsigned int  compression_level = 0,
+                  const unsigned int  chunk_size = 65536);
+
+  /**
+   * Write the data in @p data_out for the given simulation @p time. The
+   * mesh is written as well if this is the first time step or if it has
+   * changed since the previous call to this function.
+   *
+   * This function needs to be called on all processes of the
+   * communicator given to the constructor.
+   */
+  void write_time_step (const DataOutInterface<dim,spacedim> &data_out,
+                        const double                          time);
+
+  /**
+   * Return the number of time steps written so far.
+   */
+  unsigned int n_time_steps () const;
+
+  /**
+   * Return how many times the mesh has been written so far.
+   */
+  unsigned int n_meshes () const;
+
+private:
+  /**
+   * The names of the HDF5 and XDMF files.
+   */
+  const std::string h5_filename;
+  const std::string xdmf_filename;
+
+  /**
+   * The communicator of all processes that write data.
+   */
+  MPI_Comm comm;
+
+  /**
+   * Compression level and chunk size of the datasets.
+   */
+  const unsigned int compression_level;
+  const unsigned int chunk_size;
+
+  /**
+   * The entries of all time steps written so far. These only contain
+   * data on the root process.
+   */
+  std::vector<XDMFEntry> entries;
+
+  /**
+   * The number of time steps and meshes written so far.
+   */
+  unsigned int n_written_steps;
+  unsigned int n_written_meshes;
+
+  /**
+   * The checksum of the local part of the mesh that was written last.
+   */
+  std::size_t mesh_checksum;
+};
+
+
+
 /* -------------------- inline functions ------------------- */
 
 namespace DataOutBase
@@ -3083,4 +3494,6 @@ namespace DataOutBase
 
 DEAL_II_NAMESPACE_CLOSE
 
+BOOST_CLASS_VERSION(dealii::XDMFEntry, 1)
+
 #endif
@@ -0,0 +1,570 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef __deal2__flat_binary_archive_h
+#define __deal2__flat_binary_archive_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/types.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits.hpp>
+
+#include <iostream>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <int dim, typename Number> class Point;
+
+namespace internal
+{
+  namespace Triangulation
+  {
+    template <int structdim> class TriaObject;
+  }
+
+
+
+  /**
+   * A minimal archive that writes objects providing a
+   * <tt>serialize()</tt> function in the style of BOOST serialization
+   * to a stream as a flat sequence of bytes. In contrast to the
+   * archives of BOOST, this class does not write any type or tracking
+   * information: arithmetic and enumeration types are written in
+   * their native binary representation, and vectors of these types as
+   * well as of the other types listed in is_flat_binary_block_type are
+   * written as one contiguous block. This makes writing and
+   * reading considerably faster, at the price of a format that can
+   * only be read back on machines with the same byte order and type
+   * sizes as the one that wrote it. These properties are recorded in
+   * a header that FlatBinaryIArchive checks when it is created.
+   *
+   * Pointers are written as a flag followed by the object they point
+   * to. Several pointers to the same object are therefore restored as
+   * pointers to different objects; this is not a restriction for the
+   * classes of this library that use this archive, since none of them
+   * store shared pointers.
+   *
+   * The archive is used for Triangulation::save_snapshot() and
+   * DoFHandler::save_snapshot().
+   */
+  class FlatBinaryOArchive
+  {
+  public:
+    typedef boost::mpl::bool_<true>  is_saving;
+    typedef boost::mpl::bool_<false> is_loading;
+
+    /**
+     * Constructor. Write the header of the archive, consisting of
+     * the string @p tag that identifies the kind of data that
+     * follows, the format version, and a description of the byte
+     * order and the sizes of the fundamental types of this machine.
+     */
+    FlatBinaryOArchive (std::ostream      &out,
+                        const std::string &tag);
+
+    /**
+     * Write an object to the archive.
+     */
+    template <typename T>
+    FlatBinaryOArchive &operator & (const T &t);
+
+    /**
+     * Same as above.
+     */
+    template <typename T>
+    FlatBinaryOArchive &operator << (const T &t);
+
+    /**
+     * Write @p n_bytes bytes starting at @p data to the stream.
+     */
+    void write_bytes (const void        *data,
+                      const std::size_t  n_bytes);
+
+  private:
+    /**
+     * The stream to which we write.
+     */
+    std::ostream &out;
+
+    template <typename T>
+    void save_object (const T &t);
+
+    template <typename T>
+    void save_object (const T &t, const boost::true_type);
+
+    template <typename T>
+    void save_object (const T &t, const boost::false_type);
+
+    template <typename T, std::size_t N>
+    void save_object (const T (&t)[N]);
+
+    template <typename T>
+    void save_object (T *const &t);
+
+    template <typename T>
+    void save_object (const std::vector<T> &t);
+
+    void save_object (const std::vector<bool> &t);
+
+    void save_object (const std::string &t);
+
+    template <typename T1, typename T2>
+    void save_object (const std::pair<T1,T2> &t);
+
+    template <typename Key, typename Value>
+    void save_object (const std::map<Key,Value> &t);
+  };
+
+
+
+  /**
+   * The counterpart of FlatBinaryOArchive: read objects that have
+   * previously been written by that class. Vectors of the types listed
+   * in is_flat_binary_block_type are read as one contiguous block
+   * directly into their final
+   * storage. Pointers that are zero upon reading are set to a newly
+   * allocated object; if they already point to an object, that object
+   * is overwritten.
+   */
+  class FlatBinaryIArchive
+  {
+  public:
+    typedef boost::mpl::bool_<false> is_saving;
+    typedef boost::mpl::bool_<true>  is_loading;
+
+    /**
+     * Constructor. Read the header of the archive and make sure that
+     * it was written with the given @p tag, a format version this
+     * class understands, and on a machine with the same byte order
+     * and sizes of fundamental types. Throw an exception otherwise.
+     */
+    FlatBinaryIArchive (std::istream      &in,
+                        const std::string &tag);
+
+    /**
+     * Read an object from the archive.
+     */
+    template <typename T>
+    FlatBinaryIArchive &operator & (T &t);
+
+    /**
+     * Same as above.
+     */
+    template <typename T>
+    FlatBinaryIArchive &operator >> (T &t);
+
+    /**
+     * Read @p n_bytes bytes from the stream into the memory starting
+     * at @p data.
+     */
+    void read_bytes (void              *data,
+                     const std::size_t  n_bytes);
+
+    /**
+     * Exception
+     */
+    DeclException1 (ExcInvalidHeader,
+                    std::string,
+                    << "The input stream does not contain a valid snapshot: "
+                    << arg1);
+
+  private:
+    /**
+     * The stream from which we read.
+     */
+    std::istream &in;
+
+    template <typename T>
+    void load_object (T &t);
+
+    template <typename T>
+    void load_object (T &t, const boost::true_type);
+
+    template <typename T>
+    void load_object (T &t, const boost::false_type);
+
+    template <typename T, std::size_t N>
+    void load_object (T (&t)[N]);
+
+    template <typename T>
+    void load_object (T *&t);
+
+    template <typename T>
+    void load_object (std::vector<T> &t);
+
+    void load_object (std::vector<bool> &t);
+
+    void load_object (std::string &t);
+
+    template <typename T1, typename T2>
+    void load_object (std::pair<T1,T2> &t);
+
+    template <typename Key, typename Value>
+    void load_object (std::map<Key,Value> &t);
+  };
+
+
+
+  /**
+   * A type trait that determines whether objects of type @p T are
+   * written to a FlatBinaryOArchive in their binary representation.
+   */
+  template <typename T>
+  struct is_flat_binary_raw_type
+    : boost::integral_constant<bool,
+      boost::is_arithmetic<T>::value || boost::is_enum<T>::value>
+  {};
+
+
+
+  /**
+   * A type trait that determines whether vectors and arrays of objects
+   * of type @p T are written to a FlatBinaryOArchive as one block of
+   * bytes. This is the case for the types of is_flat_binary_raw_type,
+   * and for classes that consist of nothing but an array or a pair of
+   * such values without padding: points, the objects that store the
+   * faces of cells, and pairs of two equal types, which are used for
+   * the level and index of neighbors. A block holds the same bytes as
+   * writing its elements one after the other, so the choice does not
+   * change the format.
+   */
+  template <typename T>
+  struct is_flat_binary_block_type
+    : is_flat_binary_raw_type<T>
+  {};
+
+  template <int dim, typename Number>
+  struct is_flat_binary_block_type<Point<dim,Number> >
+    : is_flat_binary_raw_type<Number>
+  {};
+
+  template <int structdim>
+  struct is_flat_binary_block_type<Triangulation::TriaObject<structdim> >
+    : boost::true_type
+  {};
+
+  template <typename T>
+  struct is_flat_binary_block_type<std::pair<T,T> >
+    : is_flat_binary_raw_type<T>
+  {};
+
+
+
+  /* -------------------- inline functions --------------------- */
+
+
+  template <typename T>
+  inline
+  FlatBinaryOArchive &
+  FlatBinaryOArchive::operator & (const T &t)
+  {
+    save_object (t);
+    return *this;
+  }
+
+
+
+  template <typename T>
+  inline
+  FlatBinaryOArchive &
+  FlatBinaryOArchive::operator << (const T &t)
+  {
+    save_object (t);
+    return *this;
+  }
+
+
+
+  inline
+  void
+  FlatBinaryOArchive::write_bytes (const void        *data,
+                                   const std::size_t  n_bytes)
+  {
+    if (n_bytes > 0)
+      out.write (static_cast<const char *>(data), n_bytes);
+    AssertThrow (out, ExcIO());
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryOArchive::save_object (const T &t)
+  {
+    save_object (t, is_flat_binary_raw_type<T>());
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryOArchive::save_object (const T &t, const boost::true_type)
+  {
+    write_bytes (&t, sizeof(T));
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryOArchive::save_object (const T &t, const boost::false_type)
+  {
+    // like BOOST, call the serialize function through a non-const
+    // reference. it does not modify the object when saving
+    const_cast<T &>(t).serialize (*this, 0);
+  }
+
+
+
+  template <typename T, std::size_t N>
+  inline
+  void
+  FlatBinaryOArchive::save_object (const T (&t)[N])
+  {
+    if (is_flat_binary_block_type<T>::value)
+      write_bytes (&t[0], N*sizeof(T));
+    else
+      for (std::size_t i=0; i<N; ++i)
+        save_object (t[i]);
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryOArchive::save_object (T *const &t)
+  {
+    const unsigned char is_set = (t != 0 ? 1 : 0);
+    write_bytes (&is_set, 1);
+    if (t != 0)
+      save_object (*t);
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryOArchive::save_object (const std::vector<T> &t)
+  {
+    const boost::uint64_t size = t.size();
+    write_bytes (&size, sizeof(size));
+    if (is_flat_binary_block_type<T>::value)
+      {
+        if (size > 0)
+          write_bytes (&t[0], size*sizeof(T));
+      }
+    else
+      for (std::size_t i=0; i<t.size(); ++i)
+        save_object (t[i]);
+  }
+
+
+
+  template <typename T1, typename T2>
+  inline
+  void
+  FlatBinaryOArchive::save_object (const std::pair<T1,T2> &t)
+  {
+    save_object (t.first);
+    save_object (t.second);
+  }
+
+
+
+  template <typename Key, typename Value>
+  inline
+  void
+  FlatBinaryOArchive::save_object (const std::map<Key,Value> &t)
+  {
+    const boost::uint64_t size = t.size();
+    write_bytes (&size, sizeof(size));
+    for (typename std::map<Key,Value>::const_iterator p=t.begin();
+         p!=t.end(); ++p)
+      {
+        save_object (p->first);
+        save_object (p->second);
+      }
+  }
+
+
+
+  template <typename T>
+  inline
+  FlatBinaryIArchive &
+  FlatBinaryIArchive::operator & (T &t)
+  {
+    load_object (t);
+    return *this;
+  }
+
+
+
+  template <typename T>
+  inline
+  FlatBinaryIArchive &
+  FlatBinaryIArchive::operator >> (T &t)
+  {
+    load_object (t);
+    return *this;
+  }
+
+
+
+  inline
+  void
+  FlatBinaryIArchive::read_bytes (void              *data,
+                                  const std::size_t  n_bytes)
+  {
+    if (n_bytes > 0)
+      in.read (static_cast<char *>(data), n_bytes);
+    AssertThrow (in, ExcIO());
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryIArchive::load_object (T &t)
+  {
+    load_object (t, is_flat_binary_raw_type<T>());
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryIArchive::load_object (T &t, const boost::true_type)
+  {
+    read_bytes (&t, sizeof(T));
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryIArchive::load_object (T &t, const boost::false_type)
+  {
+    t.serialize (*this, 0);
+  }
+
+
+
+  template <typename T, std::size_t N>
+  inline
+  void
+  FlatBinaryIArchive::load_object (T (&t)[N])
+  {
+    if (is_flat_binary_block_type<T>::value)
+      read_bytes (&t[0], N*sizeof(T));
+    else
+      for (std::size_t i=0; i<N; ++i)
+        load_object (t[i]);
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryIArchive::load_object (T *&t)
+  {
+    unsigned char is_set;
+    read_bytes (&is_set, 1);
+    if (is_set != 0)
+      {
+        if (t == 0)
+          t = new T();
+        load_object (*t);
+      }
+    else
+      {
+        delete t;
+        t = 0;
+      }
+  }
+
+
+
+  template <typename T>
+  inline
+  void
+  FlatBinaryIArchive::load_object (std::vector<T> &t)
+  {
+    boost::uint64_t size;
+    read_bytes (&size, sizeof(size));
+    t.resize (size);
+    if (is_flat_binary_block_type<T>::value)
+      {
+        if (size > 0)
+          read_bytes (&t[0], size*sizeof(T));
+      }
+    else
+      for (std::size_t i=0; i<t.size(); ++i)
+        load_object (t[i]);
+  }
+
+
+
+  template <typename T1, typename T2>
+  inline
+  void
+  FlatBinaryIArchive::load_object (std::pair<T1,T2> &t)
+  {
+    load_object (t.first);
+    load_object (t.second);
+  }
+
+
+
+  template <typename Key, typename Value>
+  inline
+  void
+  FlatBinaryIArchive::load_object (std::map<Key,Value> &t)
+  {
+    t.clear ();
+    boost::uint64_t size;
+    read_bytes (&size, sizeof(size));
+    for (boost::uint64_t i=0; i<size; ++i)
+      {
+        std::pair<Key,Value> entry;
+        load_object (entry.first);
+        load_object (entry.second);
+        t.insert (t.end(), entry);
+      }
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -81,6 +81,13 @@ namespace parallel
        *
        * The same is true for the fraction of
        * cells that is coarsened.
+       *
+       * The thresholds are computed exactly by a selection algorithm
+       * on the binary representation of the indicators that needs a
+       * fixed number of four global reductions, independent of the
+       * number of processors and of the distribution of the
+       * indicators. The local part of the work is done in parallel
+       * on the present machine.
        */
       template <int dim, class Vector, int spacedim>
       void
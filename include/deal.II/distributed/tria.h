@@ -28,6 +28,8 @@
 #include <deal.II/base/std_cxx1x/tuple.h>
 
 #include <set>
+#include <numeric>
+#include <limits>
 #include <vector>
 #include <list>
 #include <utility>
@@ -373,12 +375,33 @@ namespace parallel
        * the geometric multigrid functionality. This option requires
        * additional computation and communication. Note: geometric
        * multigrid is still a work in progress.
+       *
+       * If share_coarse_connectivity_within_node is set, the p4est
+       * connectivity that describes the coarse mesh is only built by
+       * the first of all processes that run on the same node (i.e.,
+       * that can share memory) and is then placed into an MPI shared
+       * memory window. All other processes on this node refer to this
+       * one copy instead of building and storing one of their own. For
+       * coarse meshes with many cells and many processes per node,
+       * this saves both memory and setup time. Only the p4est
+       * connectivity is shared, however: the deal.II coarse mesh, i.e.,
+       * the level-0 cells, vertices and boundary information of the
+       * dealii::Triangulation base class, is still replicated on every
+       * process since all algorithms of this class rely on the entire
+       * coarse mesh being available. The flag is also honored by
+       * load(): every process first reads the connectivity from the
+       * file, and all but the first process of a node release their
+       * copy right away. The flag requires an MPI library that supports
+       * the MPI-3 standard and is ignored otherwise. If it is set,
+       * clear(), load() and the destructor of this class need to be
+       * called at the same time on all processes of a node.
        */
       enum Settings
       {
         default_setting = 0x0,
         mesh_reconstruction_after_repartitioning = 0x1,
-        construct_multigrid_hierarchy = 0x2
+        construct_multigrid_hierarchy = 0x2,
+        share_coarse_connectivity_within_node = 0x4
       };
 
 
@@ -469,6 +492,20 @@ namespace parallel
        */
       virtual void execute_coarsening_and_refinement ();
 
+      /**
+       * Redistribute the active cells between processors without
+       * refining or coarsening any of them. This is useful if the work
+       * associated with cells has changed since the last call to
+       * execute_coarsening_and_refinement(), see the #cell_weight
+       * signal. As for execute_coarsening_and_refinement(), data
+       * attached to cells with register_data_attach() is transferred to
+       * the new owner of each cell and can be retrieved with
+       * notify_ready_to_unpack() afterwards; all cells then have the
+       * status CELL_PERSIST. Refinement and coarsening flags that are
+       * set on any cell are cleared.
+       */
+      void repartition ();
+
       /**
        * Return the subdomain id of those cells that are owned by the
        * current processor. All cells in the triangulation that do not
@@ -635,6 +672,67 @@ namespace parallel
 	CELL_INVALID
       };
 
+      /**
+       * A combiner for the #cell_weight signal: if several functions
+       * are connected to the signal, the weight of a cell is the sum
+       * of the values they return. The sum saturates at the largest
+       * value of type @p T rather than wrapping around.
+       */
+      template <typename T>
+      struct CellWeightSum
+      {
+        typedef T result_type;
+
+        template <typename InputIterator>
+        T operator() (InputIterator first,
+                      InputIterator last) const
+        {
+          T sum = T();
+          for (; first != last; ++first)
+            {
+              const T value = *first;
+              sum = (value > std::numeric_limits<T>::max() - sum
+                     ?
+                     std::numeric_limits<T>::max()
+                     :
+                     sum + value);
+            }
+          return sum;
+        }
+      };
+
+      /**
+       * A signal that is used to determine the amount of work associated
+       * with each cell when the mesh is partitioned between processors.
+       * By default, every processor receives the same number of cells.
+       * If one or more functions are connected to this signal, the
+       * processors instead receive contiguous ranges of cells of equal
+       * total weight, where the weight of a cell is the sum of the
+       * values these functions return for it. This is useful if the
+       * cost of cells differs a lot, for example because they use
+       * finite elements of different degree or hold different numbers
+       * of particles.
+       *
+       * The signal is triggered for every locally owned cell of the new
+       * mesh in execute_coarsening_and_refinement(), in repartition(),
+       * and in load(), right before the mesh is partitioned. The
+       * CellStatus argument has the same meaning as for
+       * register_data_attach(): for cells that will be refined, the
+       * function is called with the parent cell, and the value it
+       * returns is used as the weight of each of the future children;
+       * for cells whose children will be coarsened, it is called with
+       * the future parent cell, whose children are still active. Weights
+       * may be zero, but not all cells of the mesh should have a zero
+       * weight. p4est stores the weight of a cell as an <tt>int</tt>:
+       * the weight of a cell must therefore not exceed
+       * <tt>std::numeric_limits<int>::max()</tt>. This is checked in
+       * debug mode; in optimized mode, larger weights are reduced to
+       * this value.
+       */
+      boost::signals2::signal<unsigned int (const cell_iterator &,
+                                            const CellStatus),
+            CellWeightSum<unsigned int> > cell_weight;
+
       /**
        * Register a function with the current Triangulation object
        * that will be used to attach data to active cells before
@@ -778,6 +876,26 @@ namespace parallel
        */
       typename dealii::internal::p4est::types<dim>::connectivity *connectivity;
 
+      /**
+       * If the coarse connectivity is shared between the processes of a
+       * node (see the share_coarse_connectivity_within_node flag), a
+       * communicator that contains all processes of the current node,
+       * and the MPI window that holds the arrays of the
+       * connectivity. Both are null otherwise.
+       */
+      MPI_Comm node_communicator;
+      MPI_Win  connectivity_window;
+
+      /**
+       * If the coarse connectivity is shared, the object #connectivity
+       * points to has been created with empty arrays by p4est and the
+       * pointers to its arrays have then been replaced by pointers
+       * into #connectivity_window. This variable stores the original
+       * content of the object, which needs to be restored before it
+       * can be handed back to p4est for destruction.
+       */
+      typename dealii::internal::p4est::types<dim>::connectivity connectivity_shell;
+
       /**
        * A data structure that holds the local part of the global
        * triangulation.
@@ -876,6 +994,30 @@ namespace parallel
       void copy_new_triangulation_to_p4est (dealii::internal::int2type<2>);
       void copy_new_triangulation_to_p4est (dealii::internal::int2type<3>);
 
+      /**
+       * Determine whether the current process needs to build the p4est
+       * connectivity in copy_new_triangulation_to_p4est(). This is the
+       * case unless the share_coarse_connectivity_within_node flag is
+       * set and another process of the same node builds it. In the
+       * latter case, this function also sets up #node_communicator.
+       */
+      bool setup_node_communicator ();
+
+      /**
+       * If #node_communicator has been set up, move the connectivity
+       * built by the first process of the node into a shared memory
+       * window and let #connectivity point to it on all processes of
+       * the node. Otherwise do nothing. This function needs to be
+       * called on all processes.
+       */
+      void share_connectivity_within_node ();
+
+      /**
+       * Release the p4est connectivity, including the shared memory
+       * window if there is one.
+       */
+      void destroy_connectivity ();
+
       /**
        * Copy the local part of the refined forest from p4est into the
        * attached triangulation.
@@ -896,6 +1038,16 @@ namespace parallel
        */
       void attach_mesh_data();
 
+      /**
+       * Partition the forest between all processors. If functions are
+       * connected to the #cell_weight signal, use them to compute the
+       * weights of the locally owned cells of the forest first. This
+       * requires that the locally owned part of the forest and the
+       * triangulation are either identical or differ by at most one
+       * level of refinement or coarsening.
+       */
+      void partition_forest ();
+
       /**
        * fills a map that, for each vertex, lists all the processors whose
        * subdomains are adjacent to that vertex.  Used by
@@ -975,7 +1127,8 @@ namespace parallel
       {
         default_setting = 0x0,
         mesh_reconstruction_after_repartitioning = 0x1,
-        construct_multigrid_hierarchy = 0x2
+        construct_multigrid_hierarchy = 0x2,
+        share_coarse_connectivity_within_node = 0x4
       };
 
 
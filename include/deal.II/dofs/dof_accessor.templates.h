@@ -2375,6 +2375,14 @@ namespace internal
                            dofs_per_line   = accessor.get_fe().dofs_per_line,
                            dofs_per_cell   = accessor.get_fe().dofs_per_cell;
 
+        // if the cache has been compressed,
+        // go back to the uncompressed form
+        // before writing into it. the
+        // DoFHandler compresses it again
+        // once all cells are updated
+        accessor.dof_handler->levels[accessor.present_level]
+        ->uncompress_cell_dof_indices_cache ();
+
         // make sure the cache is at least
         // as big as we need it when
         // writing to the last element of
@@ -2421,6 +2429,14 @@ namespace internal
                            dofs_per_quad   = accessor.get_fe().dofs_per_quad,
                            dofs_per_cell   = accessor.get_fe().dofs_per_cell;
 
+        // if the cache has been compressed,
+        // go back to the uncompressed form
+        // before writing into it. the
+        // DoFHandler compresses it again
+        // once all cells are updated
+        accessor.dof_handler->levels[accessor.present_level]
+        ->uncompress_cell_dof_indices_cache ();
+
         // make sure the cache is at least
         // as big as we need it when
         // writing to the last element of
@@ -2470,6 +2486,14 @@ namespace internal
                            dofs_per_hex    = accessor.get_fe().dofs_per_hex,
                            dofs_per_cell   = accessor.get_fe().dofs_per_cell;
 
+        // if the cache has been compressed,
+        // go back to the uncompressed form
+        // before writing into it. the
+        // DoFHandler compresses it again
+        // once all cells are updated
+        accessor.dof_handler->levels[accessor.present_level]
+        ->uncompress_cell_dof_indices_cache ();
+
         // make sure the cache is at least
         // as big as we need it when
         // writing to the last element of
@@ -2830,8 +2854,10 @@ namespace internal
 
         const unsigned int n_dofs = local_source_end - local_source_begin;
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        dealii::internal::DoFHandler::CellDoFIndicesScratch scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell vector
         global_destination.add(n_dofs, dofs, local_source_begin);
@@ -2895,8 +2921,10 @@ namespace internal
 
         const unsigned int n_dofs = local_source_end - local_source_begin;
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        dealii::internal::DoFHandler::CellDoFIndicesScratch scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell vector
         constraints.distribute_local_to_global (local_source_begin, local_source_end,
@@ -2965,8 +2993,10 @@ namespace internal
 
         const unsigned int n_dofs = local_source.m();
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        dealii::internal::DoFHandler::CellDoFIndicesScratch scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell matrix
         for (unsigned int i=0; i<n_dofs; ++i)
@@ -3043,8 +3073,10 @@ namespace internal
                 ExcMessage ("Cell must be active."));
 
         const unsigned int n_dofs = accessor.get_fe().dofs_per_cell;
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index *n_dofs];
+        dealii::internal::DoFHandler::CellDoFIndicesScratch scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell matrices
         for (unsigned int i=0; i<n_dofs; ++i)
@@ -3265,11 +3297,18 @@ DoFCellAccessor<DH,level_dof_access>::get_dof_indices (std::vector<types::global
           ExcMessage ("Can't ask for DoF indices on artificial cells."));
   AssertDimension (dof_indices.size(), this->get_fe().dofs_per_cell);
 
+  if (dof_indices.size() == 0)
+    return;
+
+  // if the cache is compressed, the indices are unpacked directly into
+  // the output array
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
-  for (unsigned int i=0; i<this->get_fe().dofs_per_cell; ++i, ++cache)
-    dof_indices[i] = *cache;
+      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell,
+                              &dof_indices[0]);
+  if (cache != &dof_indices[0])
+    for (unsigned int i=0; i<this->get_fe().dofs_per_cell; ++i, ++cache)
+      dof_indices[i] = *cache;
 }
 
 
@@ -3335,9 +3374,11 @@ DoFCellAccessor<DH,level_dof_access>::get_dof_values (const InputVector &values,
   Assert (values.size() == this->get_dof_handler().n_dofs(),
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
 
+  dealii::internal::DoFHandler::CellDoFIndicesScratch scratch;
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
+      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell,
+                              scratch);
 
   values.extract_subvector_to (cache,
                                cache + this->get_fe().dofs_per_cell,
@@ -3367,9 +3408,11 @@ DoFCellAccessor<DH,level_dof_access>::get_dof_values (const ConstraintMatrix &co
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
 
 
+  dealii::internal::DoFHandler::CellDoFIndicesScratch scratch;
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
+      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell,
+                              scratch);
 
   constraints.get_dof_values(values, *cache, local_values_begin,
                              local_values_end);
@@ -3396,9 +3439,11 @@ DoFCellAccessor<DH,level_dof_access>::set_dof_values (const Vector<number> &loca
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
 
 
+  dealii::internal::DoFHandler::CellDoFIndicesScratch scratch;
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
+      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell,
+                              scratch);
 
   for (unsigned int i=0; i<this->get_fe().dofs_per_cell; ++i, ++cache)
     values(*cache) = local_values(i);
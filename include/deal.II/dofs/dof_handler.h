@@ -29,8 +29,10 @@
 #include <deal.II/dofs/dof_iterator_selector.h>
 #include <deal.II/dofs/number_cache.h>
 #include <deal.II/dofs/function_map.h>
+#include <deal.II/grid/cell_id.h>
 
 #include <boost/serialization/split_member.hpp>
+#include <boost/signals2/connection.hpp>
 
 #include <vector>
 #include <map>
@@ -410,6 +412,68 @@ public:
    */
   void initialize_local_block_info();
 
+  /**
+   * Select whether the cache of DoF indices on active cells, which is used
+   * by DoFCellAccessor::get_dof_indices() and the related functions that
+   * read from or write into global vectors and matrices, is to be stored in
+   * compressed form. In compressed form, the indices of each batch of a few
+   * cells are stored as 32-bit differences to the smallest index of the
+   * batch. This reduces the memory consumption of the cache by half if
+   * deal.II is configured to use 64-bit indices, but makes accessing the
+   * indices of a cell slightly more expensive. If types::global_dof_index
+   * is a 32-bit type, there is no benefit in compressing the cache.
+   *
+   * The setting applies immediately to the present data and is retained by
+   * subsequent calls to distribute_dofs() and renumber_dofs(). The default
+   * is to not compress the cache.
+   */
+  void set_compressed_dof_indices_cache (const bool compress);
+
+  /**
+   * Return whether the cache of DoF indices on active cells is presently
+   * stored in compressed form on all levels. This may be false even after
+   * set_compressed_dof_indices_cache() was called with a true argument,
+   * for example before distribute_dofs() is called or if the DoF indices
+   * on a level are too far apart to be compressed.
+   */
+  bool dof_indices_cache_is_compressed () const;
+
+  /**
+   * Select whether this object is to remember the DoF indices of all active
+   * cells whenever the triangulation is about to be refined or coarsened, so
+   * that redistribute_dofs() can keep them for the cells that are not
+   * changed. The indices are recorded only if they are up to date at that
+   * time, i.e. if distribute_dofs() or redistribute_dofs() has been called
+   * after the last change of the triangulation.
+   *
+   * This is only implemented for sequential triangulations. The default is to
+   * not record anything.
+   */
+  void set_incremental_dof_distribution (const bool incremental);
+
+  /**
+   * Distribute degrees of freedom for the finite element last given to
+   * distribute_dofs() after the triangulation has been refined or coarsened,
+   * changing as little of the previous numbering as possible. This requires
+   * that set_incremental_dof_distribution() has been called before the
+   * triangulation was changed.
+   *
+   * All degrees of freedom located on active cells that were active already
+   * before the change keep their relative order and are numbered first, i.e.
+   * the numbers of degrees of freedom that were removed are squeezed out. All
+   * degrees of freedom that only live on new cells are numbered afterwards,
+   * in the same way as distribute_dofs() would do it.
+   *
+   * On return, @p old_to_new_dofs has as many entries as there were degrees
+   * of freedom before the change, and contains for each of them either its
+   * new index or invalid_dof_index if it no longer exists. This can be used to
+   * move vectors to the new numbering or to update sparsity patterns instead
+   * of recomputing them. If no DoF indices have been recorded, all degrees of
+   * freedom are numbered anew as in distribute_dofs() and all entries of @p
+   * old_to_new_dofs are invalid_dof_index.
+   */
+  void redistribute_dofs (std::vector<types::global_dof_index> &old_to_new_dofs);
+
   /**
    * Clear all data of this object and
    * especially delete the lock this object
@@ -1015,6 +1079,26 @@ public:
 
   BOOST_SERIALIZATION_SPLIT_MEMBER()
 
+  /**
+   * Write the same data as the save() function to @p out, but in the
+   * flat binary format described in Triangulation::save_snapshot().
+   * The degrees of freedom are stored as contiguous arrays, which
+   * makes checkpointing a DoFHandler considerably faster than going
+   * through a BOOST archive.
+   */
+  void save_snapshot (std::ostream &out) const;
+
+  /**
+   * Read the numbering of degrees of freedom from a snapshot written
+   * by save_snapshot(). As for load(), this object must already be
+   * associated with a triangulation and a finite element that match
+   * the ones that were used when the snapshot was written; an
+   * exception is thrown if this is not the case, or if the snapshot
+   * was written on a machine with a different binary representation
+   * of data.
+   */
+  void load_snapshot (std::istream &in);
+
   /**
    * We are trying to renumber the
    * degrees of freedom, but
@@ -1280,6 +1364,73 @@ private:
 
   dealii::internal::DoFHandler::DoFFaces<dim> *mg_faces;
 
+  /**
+   * Whether the DoF indices cache on the levels is to be kept in compressed
+   * form. See set_compressed_dof_indices_cache().
+   */
+  bool compressed_dof_indices_cache;
+
+  /**
+   * Compress the DoF indices cache on all levels if so requested by
+   * set_compressed_dof_indices_cache().
+   */
+  void compress_dof_indices_cache ();
+
+  /**
+   * Whether set_incremental_dof_distribution() has been called with a true
+   * argument.
+   */
+  bool incremental_dof_distribution;
+
+  /**
+   * Whether the DoF indices stored in this object describe the current state
+   * of the triangulation, i.e. whether no change of the triangulation
+   * happened since the last call to distribute_dofs() or
+   * redistribute_dofs().
+   */
+  bool dof_indices_up_to_date;
+
+  /**
+   * Connections to the signals of the triangulation, used if the DoF indices
+   * are to be recorded for redistribute_dofs().
+   */
+  std::vector<boost::signals2::connection> tria_listeners;
+
+  /**
+   * The ids of the active cells whose DoF indices have been recorded by
+   * record_dof_indices(), sorted by their id, together with the position of
+   * the indices of each cell in recorded_dof_indices.
+   */
+  std::vector<std::pair<CellId,unsigned int> > recorded_cells;
+
+  /**
+   * The DoF indices recorded by record_dof_indices(), cell by cell.
+   */
+  std::vector<types::global_dof_index> recorded_dof_indices;
+
+  /**
+   * The number of degrees of freedom at the time the DoF indices were
+   * recorded.
+   */
+  types::global_dof_index recorded_n_dofs;
+
+  /**
+   * Record the DoF indices of all active cells, if they are up to date and
+   * have not yet been recorded. Called before the triangulation is refined.
+   */
+  void record_dof_indices ();
+
+  /**
+   * Note that the triangulation has changed and the stored DoF indices no
+   * longer describe it.
+   */
+  void mark_dof_indices_out_of_date ();
+
+  /**
+   * Discard recorded DoF indices.
+   */
+  void clear_recorded_dof_indices ();
+
   std::vector<MGVertexDoFs> mg_vertex_dofs;
 
   /**
@@ -1502,6 +1653,9 @@ void DoFHandler<dim,spacedim>::load (Archive &ar,
                                         "DoFHandler previously stored (")
                            + policy_name
                            + ")."));
+
+  // the DoF indices cache is always stored in uncompressed form
+  compress_dof_indices_cache ();
 }
 
 
@@ -72,6 +72,23 @@ namespace internal
         NumberCache
         distribute_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler) const = 0;
 
+        /**
+         * Distribute degrees of freedom on
+         * all vertices, lines, quads and
+         * cells of the object given as
+         * first argument that do not yet
+         * have any, numbering them
+         * consecutively starting at @p
+         * offset. Indices that are already
+         * present are left untouched and
+         * need to be smaller than @p
+         * offset.
+         */
+        virtual
+        NumberCache
+        distribute_additional_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler,
+                                    const types::global_dof_index offset) const = 0;
+
         /**
          * Distribute the multigrid dofs on each level
          */
@@ -109,6 +126,16 @@ namespace internal
         NumberCache
         distribute_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler) const;
 
+        /**
+         * Distribute degrees of freedom on
+         * the objects that do not have any
+         * yet, starting at @p offset.
+         */
+        virtual
+        NumberCache
+        distribute_additional_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler,
+                                    const types::global_dof_index offset) const;
+
         /**
          * Distribute multigrid DoFs.
          */
@@ -147,6 +174,16 @@ namespace internal
         NumberCache
         distribute_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler) const;
 
+        /**
+         * Distribute degrees of freedom on
+         * the objects that do not have any
+         * yet, starting at @p offset.
+         */
+        virtual
+        NumberCache
+        distribute_additional_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler,
+                                    const types::global_dof_index offset) const;
+
         /**
          * Distribute multigrid DoFs.
          */
@@ -22,6 +22,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/dofs/dof_objects.h>
+#include <algorithm>
 #include <vector>
 
 
@@ -35,6 +36,31 @@ namespace internal
 {
   namespace DoFHandler
   {
+    /**
+     * Storage into which DoFLevel::get_cell_cache_start() unpacks the DoF
+     * indices of a cell if the cache is compressed. Up to #max_stack_dofs
+     * indices are kept in an array that is part of the object, so that
+     * creating an object of this type as a local variable does not
+     * allocate memory. Only for elements with more degrees of freedom per
+     * cell, a vector is allocated when the indices are unpacked.
+     */
+    class CellDoFIndicesScratch
+    {
+    public:
+      /**
+       * The number of indices for which no memory is allocated.
+       */
+      static const unsigned int max_stack_dofs = 128;
+
+      /**
+       * Return a pointer to storage for @p n_dofs indices.
+       */
+      types::global_dof_index *get (const unsigned int n_dofs);
+
+    private:
+      types::global_dof_index              stack_storage[max_stack_dofs];
+      std::vector<types::global_dof_index> heap_storage;
+    };
 
 
     /**
@@ -74,6 +100,11 @@ namespace internal
     class DoFLevel
     {
     public:
+      /**
+       * Constructor. Initializes the cache to be empty and uncompressed.
+       */
+      DoFLevel ();
+
       /**
        * Cache for the DoF indices
        * on cells. The size of this
@@ -84,6 +115,29 @@ namespace internal
        */
       std::vector<types::global_dof_index> cell_dof_indices_cache;
 
+      /**
+       * Compressed form of #cell_dof_indices_cache, see
+       * compress_cell_dof_indices_cache(). For each cell, this array stores
+       * the differences of its DoF indices to the offset of the batch of
+       * cells it belongs to. Invalid DoF indices are stored as
+       * numbers::invalid_unsigned_int. This array is empty if the cache is
+       * not compressed.
+       */
+      std::vector<unsigned int> compressed_cell_dof_indices;
+
+      /**
+       * For each batch of #cells_per_batch consecutive cells, the smallest
+       * valid DoF index on any of these cells. This array is empty if the
+       * cache is not compressed.
+       */
+      std::vector<types::global_dof_index> compressed_cell_dof_offsets;
+
+      /**
+       * Number of consecutive cells that share one entry of
+       * #compressed_cell_dof_offsets.
+       */
+      static const unsigned int cells_per_batch = 16;
+
       /**
        * The object containing dof-indices
        * and related access-functions
@@ -92,7 +146,7 @@ namespace internal
 
       /**
        * Return a pointer to the beginning of the DoF indices cache
-       * for a given cell.
+       * for a given cell. The cache must not be compressed.
        *
        * @param obj_index The number of the cell we are looking at.
        * @param dofs_per_cell The number of DoFs per cell for this cell.
@@ -103,6 +157,52 @@ namespace internal
       get_cell_cache_start (const unsigned int obj_index,
                             const unsigned int dofs_per_cell) const;
 
+      /**
+       * Same as above, but also works if the cache is compressed. In that
+       * case, the indices of the cell are unpacked into @p scratch, which
+       * must have room for @p dofs_per_cell elements, and @p scratch is
+       * returned. Otherwise, @p scratch is not touched.
+       */
+      const types::global_dof_index *
+      get_cell_cache_start (const unsigned int       obj_index,
+                            const unsigned int       dofs_per_cell,
+                            types::global_dof_index *scratch) const;
+
+      /**
+       * Same as above, with the storage for the unpacked indices taken from
+       * @p scratch. No memory is requested from @p scratch if the cache is
+       * not compressed.
+       */
+      const types::global_dof_index *
+      get_cell_cache_start (const unsigned int     obj_index,
+                            const unsigned int     dofs_per_cell,
+                            CellDoFIndicesScratch &scratch) const;
+
+      /**
+       * Return whether the DoF indices cache is currently stored in
+       * compressed form.
+       */
+      bool cell_dof_indices_cache_is_compressed () const;
+
+      /**
+       * Replace #cell_dof_indices_cache by its compressed form: the cells
+       * are grouped into batches of #cells_per_batch cells, and the indices
+       * are stored as 32-bit differences to the smallest index within the
+       * batch. This reduces the memory of the cache by half if
+       * types::global_dof_index is a 64-bit type, at the cost of one
+       * addition per index on access.
+       *
+       * If the differences within one batch do not fit into 32 bits, the
+       * cache is left uncompressed.
+       */
+      void compress_cell_dof_indices_cache (const unsigned int dofs_per_cell);
+
+      /**
+       * Restore #cell_dof_indices_cache from its compressed form. Does
+       * nothing if the cache is not compressed.
+       */
+      void uncompress_cell_dof_indices_cache ();
+
       /**
        * Determine an estimate for the
        * memory consumption (in bytes)
@@ -117,16 +217,38 @@ namespace internal
       template <class Archive>
       void serialize(Archive &ar,
                      const unsigned int version);
+
+    private:
+      /**
+       * The number of DoFs per cell the compressed cache was built with.
+       */
+      unsigned int compressed_dofs_per_cell;
+
+      /**
+       * Write the uncompressed form of the compressed cache into @p cache.
+       */
+      void unpack_cell_dof_indices_cache (std::vector<types::global_dof_index> &cache) const;
     };
 
 
 
+    template <int dim>
+    inline
+    DoFLevel<dim>::DoFLevel ()
+      :
+      compressed_dofs_per_cell (0)
+    {}
+
+
+
     template <int dim>
     inline
     const types::global_dof_index *
     DoFLevel<dim>::get_cell_cache_start (const unsigned int obj_index,
                                          const unsigned int dofs_per_cell) const
     {
+      Assert (compressed_cell_dof_offsets.empty(),
+              ExcInternalError());
       Assert (obj_index*dofs_per_cell+dofs_per_cell
               <=
               cell_dof_indices_cache.size(),
@@ -137,12 +259,171 @@ namespace internal
 
 
 
+    inline
+    types::global_dof_index *
+    CellDoFIndicesScratch::get (const unsigned int n_dofs)
+    {
+      if (n_dofs <= max_stack_dofs)
+        return stack_storage;
+
+      heap_storage.resize (n_dofs);
+      return &heap_storage[0];
+    }
+
+
+
+    template <int dim>
+    inline
+    const types::global_dof_index *
+    DoFLevel<dim>::get_cell_cache_start (const unsigned int       obj_index,
+                                         const unsigned int       dofs_per_cell,
+                                         types::global_dof_index *scratch) const
+    {
+      if (compressed_cell_dof_offsets.empty())
+        return get_cell_cache_start (obj_index, dofs_per_cell);
+
+      const std::size_t start = static_cast<std::size_t>(obj_index) * dofs_per_cell;
+      Assert (start+dofs_per_cell <= compressed_cell_dof_indices.size(),
+              ExcInternalError());
+
+      const types::global_dof_index offset
+        = compressed_cell_dof_offsets[obj_index/cells_per_batch];
+      const unsigned int *compressed
+        = &compressed_cell_dof_indices[start];
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        scratch[i] = (compressed[i] == numbers::invalid_unsigned_int
+                      ?
+                      numbers::invalid_dof_index
+                      :
+                      offset + compressed[i]);
+      return scratch;
+    }
+
+
+
+    template <int dim>
+    inline
+    const types::global_dof_index *
+    DoFLevel<dim>::get_cell_cache_start (const unsigned int     obj_index,
+                                         const unsigned int     dofs_per_cell,
+                                         CellDoFIndicesScratch &scratch) const
+    {
+      if (compressed_cell_dof_offsets.empty())
+        return get_cell_cache_start (obj_index, dofs_per_cell);
+      else
+        return get_cell_cache_start (obj_index, dofs_per_cell,
+                                     scratch.get (dofs_per_cell));
+    }
+
+
+
+    template <int dim>
+    inline
+    bool
+    DoFLevel<dim>::cell_dof_indices_cache_is_compressed () const
+    {
+      return (compressed_cell_dof_offsets.empty() == false);
+    }
+
+
+
+    template <int dim>
+    void
+    DoFLevel<dim>::compress_cell_dof_indices_cache (const unsigned int dofs_per_cell)
+    {
+      if (cell_dof_indices_cache_is_compressed() || (dofs_per_cell == 0))
+        return;
+
+      const std::size_t n_cells = cell_dof_indices_cache.size() / dofs_per_cell;
+      const std::size_t n_batches = (n_cells + cells_per_batch - 1) / cells_per_batch;
+
+      std::vector<types::global_dof_index> offsets (n_batches);
+      for (std::size_t batch=0; batch<n_batches; ++batch)
+        {
+          const std::size_t begin = batch * cells_per_batch * dofs_per_cell,
+                            end = std::min<std::size_t> ((batch+1) * cells_per_batch,
+                                                         n_cells) * dofs_per_cell;
+
+          types::global_dof_index min_index = numbers::invalid_dof_index,
+                                  max_index = 0;
+          for (std::size_t i=begin; i<end; ++i)
+            if (cell_dof_indices_cache[i] != numbers::invalid_dof_index)
+              {
+                min_index = std::min (min_index, cell_dof_indices_cache[i]);
+                max_index = std::max (max_index, cell_dof_indices_cache[i]);
+              }
+
+          if (min_index == numbers::invalid_dof_index)
+            min_index = 0;
+          // the largest difference must be representable and must not
+          // collide with the marker for invalid indices
+          else if (max_index - min_index >=
+                   static_cast<types::global_dof_index>(numbers::invalid_unsigned_int))
+            return;
+
+          offsets[batch] = min_index;
+        }
+
+      std::vector<unsigned int> compressed (cell_dof_indices_cache.size());
+      for (std::size_t i=0; i<cell_dof_indices_cache.size(); ++i)
+        compressed[i] = (cell_dof_indices_cache[i] == numbers::invalid_dof_index
+                         ?
+                         numbers::invalid_unsigned_int
+                         :
+                         static_cast<unsigned int>
+                         (cell_dof_indices_cache[i]
+                          - offsets[i/(cells_per_batch*dofs_per_cell)]));
+
+      compressed_cell_dof_indices.swap (compressed);
+      compressed_cell_dof_offsets.swap (offsets);
+      compressed_dofs_per_cell = dofs_per_cell;
+
+      // release the memory of the uncompressed cache
+      std::vector<types::global_dof_index>().swap (cell_dof_indices_cache);
+    }
+
+
+
+    template <int dim>
+    void
+    DoFLevel<dim>::unpack_cell_dof_indices_cache (std::vector<types::global_dof_index> &cache) const
+    {
+      cache.resize (compressed_cell_dof_indices.size());
+      for (std::size_t i=0; i<compressed_cell_dof_indices.size(); ++i)
+        cache[i]
+          = (compressed_cell_dof_indices[i] == numbers::invalid_unsigned_int
+             ?
+             numbers::invalid_dof_index
+             :
+             compressed_cell_dof_offsets[i/(cells_per_batch*compressed_dofs_per_cell)]
+             + compressed_cell_dof_indices[i]);
+    }
+
+
+
+    template <int dim>
+    void
+    DoFLevel<dim>::uncompress_cell_dof_indices_cache ()
+    {
+      if (cell_dof_indices_cache_is_compressed() == false)
+        return;
+
+      unpack_cell_dof_indices_cache (cell_dof_indices_cache);
+
+      std::vector<unsigned int>().swap (compressed_cell_dof_indices);
+      std::vector<types::global_dof_index>().swap (compressed_cell_dof_offsets);
+    }
+
+
+
     template <int dim>
     inline
     std::size_t
     DoFLevel<dim>::memory_consumption () const
     {
       return (MemoryConsumption::memory_consumption (cell_dof_indices_cache) +
+              MemoryConsumption::memory_consumption (compressed_cell_dof_indices) +
+              MemoryConsumption::memory_consumption (compressed_cell_dof_offsets) +
               MemoryConsumption::memory_consumption (dof_object));
     }
 
@@ -154,7 +435,22 @@ namespace internal
     DoFLevel<dim>::serialize (Archive &ar,
                               const unsigned int)
     {
-      ar &cell_dof_indices_cache;
+      // always write the cache in uncompressed form, so that the format
+      // does not depend on whether the cache was compressed
+      if (Archive::is_saving::value && cell_dof_indices_cache_is_compressed())
+        {
+          std::vector<types::global_dof_index> cache;
+          unpack_cell_dof_indices_cache (cache);
+          ar &cache;
+        }
+      else
+        ar &cell_dof_indices_cache;
+
+      if (Archive::is_loading::value)
+        {
+          std::vector<unsigned int>().swap (compressed_cell_dof_indices);
+          std::vector<types::global_dof_index>().swap (compressed_cell_dof_offsets);
+        }
       ar &dof_object;
     }
   }
@@ -29,6 +29,8 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+template <int dim, typename Number> class MatrixFree;
+
 /**
  * Implementation of a number of renumbering algorithms for the degrees of
  * freedom on a triangulation.
@@ -208,6 +210,13 @@ DEAL_II_NAMESPACE_OPEN
  * clock_wise_dg(). The first orders the cells according to a
  * downstream direction and then applies cell_wise().
  *
+ * A related scheme is implemented in matrix_free_data_locality(), which
+ * uses the order in which MatrixFree::cell_loop() visits the cells,
+ * including the vectorization over several cells and the partitioning into
+ * colors used for parallelism, as the cell order. This improves the cache
+ * reuse when reading from and writing into vectors in operator
+ * evaluation.
+ *
  * @note For DG elements, the internal numbering in each cell remains
  * unaffected. This cannot be guaranteed for continuous elements
  * anymore, since degrees of freedom shared with an earlier cell will
@@ -577,7 +586,10 @@ namespace DoFRenumbering
    * If the given DoFHandler uses a distributed triangulation (i.e., if
    * dof_handler.locally_owned() is not the complete index set), the
    * renumbering is performed on each processor's degrees of freedom
-   * individually.
+   * individually. Unless @p use_constraints is set, the connectivity graph
+   * is then only built for the locally owned degrees of freedom and in the
+   * processor-local index space, so that the memory and time needed by this
+   * function only depend on the size of the locally owned part of the mesh.
    */
   template <class DH>
   void
@@ -844,6 +856,52 @@ namespace DoFRenumbering
                      const unsigned int         level,
                      const std::vector<typename DH::level_cell_iterator> &cell_order);
 
+  /**
+   * Renumber the degrees of freedom in the order in which they are first
+   * accessed by MatrixFree::cell_loop(). The macro cells of @p matrix_free
+   * are visited in the order of the loop, i.e., respecting the partitioning
+   * of the cells into colors and vectorization batches set up by
+   * MatrixFree::reinit(), and within each macro cell the lanes of the
+   * vectorized array are visited one after the other. Each locally owned
+   * degree of freedom is assigned the next free number the first time it is
+   * encountered. Consequently, the degrees of freedom read by
+   * FEEvaluation::read_dof_values() on consecutive cell batches are close in
+   * memory.
+   *
+   * In a parallel computation, the locally owned degrees of freedom that are
+   * also located on ghost cells (i.e., those that other processors import
+   * as ghost entries) are enumerated in a contiguous range after all other
+   * locally owned degrees of freedom. This keeps the entries sent in
+   * parallel::distributed::Vector::update_ghost_values() and
+   * parallel::distributed::Vector::compress() together.
+   *
+   * The argument @p fe_component selects the DoFHandler within
+   * @p matrix_free, in case several DoFHandler objects were given to
+   * MatrixFree::reinit(). It must be the same object as @p dof_handler.
+   *
+   * @note Since the renumbering changes the indices stored inside
+   * @p matrix_free, MatrixFree::reinit() must be called again after this
+   * function.
+   */
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>                &dof_handler,
+                             const MatrixFree<dim,Number>   &matrix_free,
+                             const unsigned int              fe_component = 0);
+
+  /**
+   * Computes the renumbering vector needed by the matrix_free_data_locality()
+   * function. Does not perform the renumbering on the DoFHandler dofs but
+   * returns the renumbering vector. The vector @p new_indices must have as
+   * many entries as there are locally owned degrees of freedom.
+   */
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free,
+                                     const unsigned int                    fe_component = 0);
+
   /**
    * @}
    */
@@ -149,7 +149,9 @@ struct SubCellData;
  *
  * <li> <tt>Gmsh 2.0 mesh</tt> format: this is a variant of the above format.
  * The read_msh() function automatically determines whether an input file
- * is version 1 or version 2.
+ * is version 1 or version 2, and whether a version 2 file is stored in ASCII
+ * or in binary form. Binary files are considerably faster to read for large
+ * meshes.
  *
  * <li> <tt>Tecplot</tt> format: this format is used by @p TECPLOT and often
  * serves as a basis for data exchange between different applications. Note,
@@ -423,6 +425,11 @@ public:
    * format. The GMSH formats are
    * documented at
    * http://www.geuz.org/gmsh/ .
+   * Files of version 2 can be
+   * stored in ASCII or binary
+   * form; binary files must have
+   * been written on a machine with
+   * the same byte order.
    *
    * @note The input function of
    * deal.II does not distinguish
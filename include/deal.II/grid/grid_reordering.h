@@ -676,6 +676,34 @@ public:
   static void reorder_cells (std::vector<CellData<dim> > &original_cells,
                              const bool use_new_style_ordering = false);
 
+  /**
+   * Check whether the given cells
+   * are already oriented
+   * consistently, i.e., whether
+   * all cells that share an edge
+   * agree on its direction. In
+   * that case, reorder_cells()
+   * leaves the cells unchanged.
+   *
+   * This check only needs a
+   * single pass over the cells
+   * and is much cheaper than
+   * reorder_cells(), so it can be
+   * used to confirm that a large
+   * mesh does not need to be
+   * reordered. The check of the
+   * edges runs in parallel if
+   * deal.II is configured to use
+   * threads. In 1d, this function
+   * always returns true.
+   *
+   * The second argument has the
+   * same meaning as for
+   * reorder_cells().
+   */
+  static bool is_consistent (const std::vector<CellData<dim> > &cells,
+                             const bool use_new_style_ordering = false);
+
   /**
    * Grids generated by grid
    * generators may have an
@@ -728,6 +756,36 @@ void
 GridReordering<3>::reorder_cells (std::vector<CellData<3> > &original_cells,
                                   const bool);
 
+template<>
+bool
+GridReordering<1>::is_consistent (const std::vector<CellData<1> > &cells,
+                                  const bool);
+
+template<>
+bool
+GridReordering<1,2>::is_consistent (const std::vector<CellData<1> > &cells,
+                                    const bool);
+
+template<>
+bool
+GridReordering<1,3>::is_consistent (const std::vector<CellData<1> > &cells,
+                                    const bool);
+
+template<>
+bool
+GridReordering<2>::is_consistent (const std::vector<CellData<2> > &cells,
+                                  const bool);
+
+template<>
+bool
+GridReordering<2,3>::is_consistent (const std::vector<CellData<2> > &cells,
+                                    const bool);
+
+template<>
+bool
+GridReordering<3>::is_consistent (const std::vector<CellData<3> > &cells,
+                                  const bool);
+
 template<>
 void
 GridReordering<2>::invert_all_cells_of_negative_grid(const std::vector<Point<2> > &all_vertices,
@@ -25,6 +25,7 @@
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/table.h>
 #include <deal.II/grid/tria.h>
 
 DEAL_II_NAMESPACE_OPEN
@@ -57,6 +58,41 @@ namespace Manifolds
   template <typename OBJECT, int spacedim>
   Quadrature<spacedim>
   get_default_quadrature(const OBJECT &obj, bool with_laplace = false);
+
+  /**
+   * The largest number of points get_default_points_and_weights()
+   * returns, i.e., the size the arrays passed to it need to have.
+   */
+  const unsigned int max_default_points
+    = GeometryInfo<3>::vertices_per_cell +
+      GeometryInfo<3>::lines_per_cell +
+      GeometryInfo<3>::faces_per_cell;
+
+  /**
+   * Same as get_default_quadrature(), but write the points and
+   * weights into the given arrays instead of creating a Quadrature
+   * object, so that no memory needs to be allocated. The arrays must
+   * have room for at least #max_default_points entries. The return
+   * value is the number of points written.
+   */
+  unsigned int
+  get_default_points_and_weights(const TriaIterator<CellAccessor<3, 3> > &hex,
+                                 Point<3> *points,
+                                 double   *weights);
+
+  /**
+   * Same as get_default_quadrature(), but write the points and
+   * weights into the given arrays instead of creating a Quadrature
+   * object, so that no memory needs to be allocated. The arrays must
+   * have room for at least #max_default_points entries. The return
+   * value is the number of points written.
+   */
+  template <typename OBJECT, int spacedim>
+  unsigned int
+  get_default_points_and_weights(const OBJECT    &obj,
+                                 Point<spacedim> *points,
+                                 double          *weights,
+                                 const bool       with_laplace = false);
 }
 
 
@@ -88,6 +124,15 @@ namespace Manifolds
  *   FlatManifold is the specialization from which StraigthBoundary is
  *   derived, where the project_to_manifold() function is the identity.
  *
+ *   Triangulation::execute_coarsening_and_refinement() computes the
+ *   midpoints of all lines that are refined in parallel if all the
+ *   manifolds involved declare themselves thread safe, see
+ *   is_thread_safe(), and one after the other otherwise. Only for
+ *   thread safe manifolds may get_new_point_on_line(), and through it
+ *   get_new_point() and the functions these call, such as
+ *   project_to_manifold(), pull_back() and push_forward(), therefore be
+ *   called concurrently from several threads.
+ *
  * @ingroup manifold
  * @author Luca Heltai, 2014
  */
@@ -95,7 +140,10 @@ template <int dim, int spacedim=dim>
 class Manifold : public Subscriptor
 {
 public:
-
+  /**
+   * Constructor.
+   */
+  Manifold ();
 
   /**
    * Destructor. Does nothing here, but needs to be declared to make it
@@ -117,6 +165,47 @@ public:
   Point<spacedim>
   get_new_point(const Quadrature<spacedim> &quad) const;
 
+  /**
+   * Same as above, but with the surrounding points and their weights
+   * given as plain arrays of length @p n_points. This avoids the
+   * construction of a Quadrature object, and the memory allocation
+   * that comes with it, for each new point. The default
+   * implementations of the get_new_point_on_line(),
+   * get_new_point_on_quad() and get_new_point_on_hex() functions call
+   * this function with arrays on the stack.
+   *
+   * The default implementation copies the arrays into a Quadrature
+   * object and calls the function above, so that derived classes
+   * which only overload that one keep working. The classes of the
+   * library that compute the new point on the arrays directly only do
+   * so if #use_array_interface is set, and otherwise also go through
+   * the function above.
+   */
+  virtual
+  Point<spacedim>
+  get_new_point(const Point<spacedim> *surrounding_points,
+                const double          *weights,
+                const unsigned int     n_points) const;
+
+  /**
+   * Compute several new points from the same set of surrounding
+   * points. Row <tt>i</tt> of @p weights holds the weights of all the
+   * @p surrounding_points for the point <tt>new_points[i]</tt>, i.e.,
+   * the table needs to have as many columns as there are surrounding
+   * points. @p new_points is resized to the number of rows of the
+   * table.
+   *
+   * The default implementation calls get_new_point() once for each
+   * row. Derived classes can overload it to share work between the
+   * new points, as ChartManifold does by pulling back the surrounding
+   * points only once.
+   */
+  virtual
+  void
+  get_new_points(const std::vector<Point<spacedim> > &surrounding_points,
+                 const Table<2,double>               &weights,
+                 std::vector<Point<spacedim> >       &new_points) const;
+
   /**
    * Given a point which lies close to the given manifold, it modifies
    * it and projects it to manifold itself.
@@ -224,6 +313,54 @@ public:
    */
   Point<spacedim>
   get_new_point_on_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
+  /**
+   * Return whether get_new_point_on_line() may be called concurrently
+   * from several threads, i.e., the value of #thread_safe.
+   */
+  bool is_thread_safe () const;
+
+protected:
+  /**
+   * Whether the classes of the library that overload the variant of
+   * get_new_point() taking arrays may compute the new point directly
+   * from the arrays, rather than by calling the virtual function
+   * get_new_point(const Quadrature<spacedim>&). The direct computation
+   * avoids the memory allocation for the Quadrature object, but it
+   * bypasses any overload of that function, or of
+   * project_to_manifold(), in a derived class.
+   *
+   * This flag is false by default, so that classes derived from
+   * FlatManifold or ChartManifold which only overload
+   * get_new_point(const Quadrature<spacedim>&) or project_to_manifold()
+   * keep working. It is set to true by the constructors of classes that
+   * opt in explicitly, namely StraightBoundary, SphericalManifold and
+   * CylindricalManifold. Classes derived from one of these that
+   * overload get_new_point(const Quadrature<spacedim>&) or
+   * project_to_manifold() need to set it back to false in their
+   * constructor. Conversely, a class derived from FlatManifold or
+   * ChartManifold that overloads neither may set it to true.
+   */
+  bool use_array_interface;
+
+  /**
+   * Whether get_new_point_on_line(), and all the functions it calls,
+   * may be called concurrently from several threads for different
+   * lines. Triangulation::execute_coarsening_and_refinement() only
+   * computes the midpoints of the lines to be refined in parallel if
+   * this flag is set for all the manifolds involved.
+   *
+   * This flag is false by default, since derived classes may change
+   * their state in these functions. It is set to true by the
+   * constructors of FlatManifold, StraightBoundary, SphericalManifold
+   * and CylindricalManifold, which do not, and so also holds for the
+   * classes of the library derived from StraightBoundary. The
+   * constructor of Boundary sets it back to false for all other boundary
+   * classes. Classes derived from one of these that change member
+   * variables in any of these functions without protecting them with a
+   * Threads::Mutex need to set it back to false in their constructor.
+   */
+  bool thread_safe;
 };
 
 
@@ -300,6 +437,19 @@ public:
   virtual Point<spacedim>
   get_new_point(const Quadrature<spacedim> &quad) const;
 
+  /**
+   * Same as above, with the surrounding points and weights given as
+   * arrays. If Manifold::use_array_interface is set, the weighted
+   * average is returned without allocating any memory and without
+   * calling project_to_manifold(). Otherwise, this function falls back
+   * to the implementation in the base class, which calls the function
+   * above.
+   */
+  virtual Point<spacedim>
+  get_new_point(const Point<spacedim> *surrounding_points,
+                const double          *weights,
+                const unsigned int     n_points) const;
+
 
   /**
    *  Project to FlatManifold. This is the identity function for flat,
@@ -312,6 +462,16 @@ public:
   Point<spacedim> project_to_manifold (const std::vector<Point<spacedim> > &points,
                                        const Point<spacedim> &candidate) const;
 private:
+  /**
+   * Compute the weighted average of the given points, taking into
+   * account the periodicity of this manifold. This is what
+   * get_new_point() does before projecting to the manifold.
+   */
+  Point<spacedim>
+  compute_weighted_average(const Point<spacedim> *surrounding_points,
+                           const double          *weights,
+                           const unsigned int     n_points) const;
+
   /**
    * The periodicity of this Manifold. Periodicity affects the way a
    * middle point is computed. It is assumed that if two points are
@@ -338,6 +498,8 @@ private:
    * in double precision.
    */
   const double tolerance;
+
+  template <int, int, int> friend class ChartManifold;
 };
 
 
@@ -377,7 +539,16 @@ private:
  *
  *   Derived classes are required to implement the push_forward() and
  *   the pull_back() methods. All other functions required by mappings
- *   will then be provided by this class.
+ *   will then be provided by this class. Both variants of
+ *   get_new_point() as well as get_new_points() are implemented in
+ *   terms of pull_back() and push_forward(). Unless a derived class
+ *   sets Manifold::use_array_interface, the variants taking arrays go
+ *   through get_new_point(const Quadrature<spacedim>&), so that
+ *   derived classes only need to overload that one function if they
+ *   want to compute new points differently. The functions
+ *   pull_back_points() and push_forward_points() transform many points
+ *   at once and can be overloaded if this can be done faster than point
+ *   by point.
  *
  *   The dimension arguments #chartdim, #dim and #spacedim must
  *   satisfy the following relationships:
@@ -447,6 +618,32 @@ public:
   virtual Point<spacedim>
   get_new_point(const Quadrature<spacedim> &quad) const;
 
+  /**
+   * Same as above, with the surrounding points and weights given as
+   * arrays. If Manifold::use_array_interface is set, the new point is
+   * computed directly from the arrays, keeping the pulled back points on
+   * the stack for up to #max_stack_points surrounding points. Otherwise,
+   * this function falls back to the implementation in the base class,
+   * which calls the function above.
+   */
+  virtual Point<spacedim>
+  get_new_point(const Point<spacedim> *surrounding_points,
+                const double          *weights,
+                const unsigned int     n_points) const;
+
+  /**
+   * Compute several new points from the same surrounding points, see
+   * Manifold::get_new_points(). If Manifold::use_array_interface is set,
+   * the surrounding points are pulled back only once for all new points,
+   * and all new points are pushed forward at once, using
+   * pull_back_points() and push_forward_points(). Otherwise, this
+   * function falls back to the implementation in the base class.
+   */
+  virtual void
+  get_new_points(const std::vector<Point<spacedim> > &surrounding_points,
+                 const Table<2,double>               &weights,
+                 std::vector<Point<spacedim> >       &new_points) const;
+
   /**
    * Pull back the given point in spacedim to the Euclidean chartdim
    * dimensional space.
@@ -468,6 +665,47 @@ public:
   virtual Point<spacedim>
   push_forward(const Point<chartdim> &chart_point) const = 0;
 
+  /**
+   * Pull back the @p n_points points in @p space_points and write
+   * the results into @p chart_points. The default implementation
+   * calls pull_back() for each point; derived classes can overload
+   * this function if they can transform many points at once more
+   * efficiently.
+   */
+  virtual void
+  pull_back_points(const Point<spacedim> *space_points,
+                   const unsigned int     n_points,
+                   Point<chartdim>       *chart_points) const;
+
+  /**
+   * Push forward the @p n_points points in @p chart_points and write
+   * the results into @p space_points. The default implementation
+   * calls push_forward() for each point; derived classes can overload
+   * this function if they can transform many points at once more
+   * efficiently.
+   */
+  virtual void
+  push_forward_points(const Point<chartdim> *chart_points,
+                      const unsigned int     n_points,
+                      Point<spacedim>       *space_points) const;
+
+  /**
+   * The number of surrounding points up to which get_new_point()
+   * keeps the pulled back points in an array on the stack.
+   */
+  static const unsigned int max_stack_points = 32;
+
+protected:
+  /**
+   * Compute the new point by pulling back the surrounding points,
+   * averaging them in the chart, and pushing the average forward. This
+   * is what both variants of get_new_point() do.
+   */
+  Point<spacedim>
+  compute_new_point(const Point<spacedim> *surrounding_points,
+                    const double          *weights,
+                    const unsigned int     n_points) const;
+
 private:
   /**
    * The sub_manifold object is used to compute the average of the
@@ -528,12 +766,12 @@ namespace Manifolds
 {
 
   template <typename OBJECT, int spacedim>
-  Quadrature<spacedim>
-  get_default_quadrature(const OBJECT &obj, bool with_laplace)
+  unsigned int
+  get_default_points_and_weights(const OBJECT    &obj,
+                                 Point<spacedim> *sp,
+                                 double          *wp,
+                                 const bool       with_laplace)
   {
-    std::vector<Point<spacedim> > sp;
-    std::vector<double> wp;
-
     const int dim = OBJECT::AccessorType::structure_dimension;
 
     // note that the exact weights are chosen such as to minimize the
@@ -544,16 +782,12 @@ namespace Manifolds
     switch (dim)
       {
       case 1:
-        sp.resize(2);
-        wp.resize(2);
         sp[0] = obj->vertex(0);
         wp[0] = .5;
         sp[1] = obj->vertex(1);
         wp[1] = .5;
-        break;
+        return 2;
       case 2:
-        sp.resize(8);
-        wp.resize(8);
         sp[0] = obj->vertex(0);
         sp[1] = obj->vertex(1);
         sp[2] = obj->vertex(2);
@@ -573,17 +807,32 @@ namespace Manifolds
                 obj->line(3)->get_manifold().get_new_point_on_line(obj->line(3));
         if (with_laplace)
           {
-            std::fill(wp.begin(), wp.begin()+4, 1.0/16.0);
-            std::fill(wp.begin()+4, wp.end(), 3.0/16.0);
+            std::fill(wp, wp+4, 1.0/16.0);
+            std::fill(wp+4, wp+8, 3.0/16.0);
           }
         else
-          std::fill(wp.begin(), wp.end(), 1.0/8.0);
-        break;
+          std::fill(wp, wp+8, 1.0/8.0);
+        return 8;
       default:
         Assert(false, ExcInternalError());
         break;
       }
-    return Quadrature<spacedim>(sp,wp);
+    return 0;
+  }
+
+
+
+  template <typename OBJECT, int spacedim>
+  Quadrature<spacedim>
+  get_default_quadrature(const OBJECT &obj, bool with_laplace)
+  {
+    Point<spacedim> sp[max_default_points];
+    double          wp[max_default_points];
+    const unsigned int n_points
+      = get_default_points_and_weights<OBJECT,spacedim>(obj, sp, wp, with_laplace);
+
+    return Quadrature<spacedim>(std::vector<Point<spacedim> >(sp, sp+n_points),
+                                std::vector<double>(wp, wp+n_points));
   }
 }
 
@@ -95,6 +95,26 @@ public:
   virtual Point<spacedim>
   get_new_point(const Quadrature<spacedim> &quad) const;
 
+  /**
+   * Same as above, with the surrounding points and weights given as
+   * arrays.
+   */
+  virtual Point<spacedim>
+  get_new_point(const Point<spacedim> *surrounding_points,
+                const double          *weights,
+                const unsigned int     n_points) const;
+
+  /**
+   * Compute several new points from the same surrounding points. In
+   * two dimensions, this uses the batched pull_back and push_forward of
+   * the base class; in three dimensions, it calls get_new_point() for
+   * each new point.
+   */
+  virtual void
+  get_new_points(const std::vector<Point<spacedim> > &surrounding_points,
+                 const Table<2,double>               &weights,
+                 std::vector<Point<spacedim> >       &new_points) const;
+
   /**
    * The center of the spherical coordinate system.
    */
@@ -105,6 +125,16 @@ private:
       this coordinate system, according to dim, chartdim, and
       spacedim. */
   static Point<spacedim> get_periodicity();
+
+  /**
+   * Compute the new point as described in get_new_point(). Both
+   * variants of get_new_point() call this function, so that a derived
+   * class overriding only one of them does not end up in the other.
+   */
+  Point<spacedim>
+  compute_new_point(const Point<spacedim> *surrounding_points,
+                    const double          *weights,
+                    const unsigned int     n_points) const;
 };
 
 
@@ -159,6 +189,15 @@ public:
   virtual Point<spacedim>
   get_new_point(const Quadrature<spacedim> &quad) const;
 
+  /**
+   * Same as above, with the surrounding points and weights given as
+   * arrays.
+   */
+  virtual Point<spacedim>
+  get_new_point(const Point<spacedim> *surrounding_points,
+                const double          *weights,
+                const unsigned int     n_points) const;
+
 protected:
   /**
    * The direction vector of the axis.
@@ -172,9 +211,13 @@ protected:
 
 private:
   /**
-   * Helper FlatManifold to compute temptative midpoints.
+   * Compute the new point as described in get_new_point(). Both
+   * variants of get_new_point() call this function.
    */
-  FlatManifold<dim,spacedim> flat_manifold;
+  Point<spacedim>
+  compute_new_point(const Point<spacedim> *surrounding_points,
+                    const double          *weights,
+                    const unsigned int     n_points) const;
 
   /**
    * Relative tolerance to measure zero distances.
@@ -3126,6 +3126,45 @@ public:
 
   BOOST_SERIALIZATION_SPLIT_MEMBER()
 
+  /**
+   * Write the same data as the save() function to @p out, but in a
+   * flat binary format instead of through a BOOST archive. No type or
+   * tracking information is written. The arrays of the triangulation
+   * that hold integers or points, i.e., the vertices, the faces,
+   * children, parents and neighbors of cells, the subdomain and
+   * manifold ids, are stored as contiguous blocks of bytes, and flags
+   * as packed bits. The few remaining arrays, such as the refinement
+   * cases and the material and boundary indicators, are written
+   * element by element. Writing and reading such a snapshot
+   * is therefore much faster than going through BOOST's binary
+   * archives, which makes it suitable for checkpointing large meshes.
+   *
+   * The snapshot starts with a header that contains a format version,
+   * the space dimensions of the triangulation, and a description of
+   * the byte order and the sizes of fundamental data types of the
+   * machine that wrote it. load_snapshot() checks this header; a
+   * snapshot can only be read on a machine with the same byte order
+   * and data type sizes, and with the same setting of
+   * DEAL_II_WITH_64BIT_INDICES.
+   *
+   * @p out should have been opened in binary mode.
+   */
+  void save_snapshot (std::ostream &out) const;
+
+  /**
+   * Read a snapshot written by save_snapshot() and replace the current
+   * content of the triangulation by it. As for load(), the previous
+   * content is thrown away, the "clear" signal is triggered before and
+   * the "create" signal after reading. Boundary and manifold
+   * descriptions are not part of a snapshot and need to be attached
+   * again afterwards.
+   *
+   * An exception is thrown if @p in does not contain a snapshot of a
+   * triangulation of the same dimensions, or if it was written on a
+   * machine with a different binary representation of data.
+   */
+  void load_snapshot (std::istream &in);
+
   /**
    *  @name Exceptions
    */
@@ -406,6 +406,25 @@ protected:
    */
   void operator ++ ();
 
+  /**
+   *  Advance the iterator to the
+   *  next active cell, or to the
+   *  past-the-end state if there is
+   *  none. This scans the used flags
+   *  and children arrays of the
+   *  levels directly instead of
+   *  going through operator++ and
+   *  the used() and has_children()
+   *  queries for each skipped
+   *  object, and is what
+   *  TriaActiveIterator uses to
+   *  move between cells.
+   *
+   *  Only implemented for cells,
+   *  i.e. for <tt>structdim==dim</tt>.
+   */
+  void next_active_cell ();
+
   /**
    *  This operator moves the
    *  iterator to the previous
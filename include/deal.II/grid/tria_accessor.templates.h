@@ -247,6 +247,43 @@ TriaAccessorBase<structdim,dim,spacedim>::operator ++ ()
 }
 
 
+template <int structdim, int dim, int spacedim>
+inline
+void
+TriaAccessorBase<structdim,dim,spacedim>::next_active_cell ()
+{
+  Assert (structdim == dim, ExcImpossibleInDim(structdim));
+
+  // each set of two children is stored consecutively, so a cell is active
+  // if the first entry of its set is not set
+  const unsigned int n_sets_of_two = GeometryInfo<structdim>::max_children_per_cell/2;
+
+  int level = this->present_level;
+  int index = this->present_index + 1;
+  const int n_levels = static_cast<int>(this->tria->levels.size());
+  for (; level < n_levels; ++level, index = 0)
+    {
+      const internal::Triangulation::TriaObjects<internal::Triangulation::TriaObject<dim> > &
+      cells = this->tria->levels[level]->cells;
+      const int n_cells = static_cast<int>(cells.cells.size());
+
+      for (; index < n_cells; ++index)
+        if ((cells.used[index] == true)
+            &&
+            (cells.children[n_sets_of_two * index] == -1))
+          {
+            this->present_level = level;
+            this->present_index = index;
+            return;
+          }
+    }
+
+  // no more active cells: return with past the end pointer
+  this->present_level = this->present_index = -1;
+}
+
+
+
 template <int structdim, int dim, int spacedim>
 inline
 void
@@ -79,6 +79,17 @@ template <int dim, int space_dim> class Triangulation;
  *   HyperBallBoundary creating a hyperball with given radius
  *   around a given center point.
  *
+ *   The constructor of this class resets Manifold::thread_safe, so the
+ *   midpoints of lines on a boundary described by a class derived from
+ *   this one are computed one after the other. Derived classes whose
+ *   get_new_point_on_line() may be called concurrently for different
+ *   lines from several threads, i.e., which do not change member
+ *   variables in it or protect them like this class does for the
+ *   cached quadrature points it uses, can set the flag again in their
+ *   constructor, as StraightBoundary does. The midpoints of all lines
+ *   that are refined are then computed in parallel. The midpoints of
+ *   quads and hexes are always computed one after the other.
+ *
  * @ingroup boundary
  * @author Wolfgang Bangerth, 1999, 2001, 2009, Ralf Hartmann, 2001, 2008, Luca Heltai, 2014
  */
@@ -100,6 +111,11 @@ public:
    */
   typedef Tensor<1,spacedim> FaceVertexNormals[GeometryInfo<dim>::vertices_per_face];
 
+  /**
+   * Constructor. Resets Manifold::thread_safe, which FlatManifold sets.
+   */
+  Boundary ();
+
   /**
    * Destructor. Does nothing here, but needs to be declared to make it
    * virtual.
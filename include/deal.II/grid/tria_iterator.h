@@ -25,6 +25,7 @@
 #include <deal.II/base/exceptions.h>
 
 #include <deal.II/base/point.h>
+#include <deal.II/base/template_constraints.h>
 #include <deal.II/grid/tria_iterator_base.h>
 
 #include <iterator>
@@ -1021,6 +1022,21 @@ public:
    *  Exception
    */
   DeclException0 (ExcAssignmentOfInactiveObject);
+
+private:
+  /**
+   * Implementation of the prefix <tt>++</tt> operator for iterators to
+   * cells: skip inactive and unused cells in one scan over the level
+   * arrays of the triangulation.
+   */
+  void advance_to_next_active (const internal::int2type<true>);
+
+  /**
+   * Implementation of the prefix <tt>++</tt> operator for all other
+   * objects: visit the following objects one by one until an active one
+   * is found.
+   */
+  void advance_to_next_active (const internal::int2type<false>);
 };
 
 
@@ -570,12 +570,35 @@ template <typename Accessor>
 inline
 TriaActiveIterator<Accessor> &
 TriaActiveIterator<Accessor>::operator ++ ()
+{
+  // for cells, skip inactive and unused objects in one scan over the level
+  // arrays rather than visiting each of them through the accessor
+  advance_to_next_active (internal::int2type<Accessor::structure_dimension ==
+                                             Accessor::dimension>());
+  return *this;
+}
+
+
+template <typename Accessor>
+inline
+void
+TriaActiveIterator<Accessor>::advance_to_next_active (const internal::int2type<true>)
+{
+  Assert (this->state() == IteratorState::valid,
+          typename TriaRawIterator<Accessor>::ExcAdvanceInvalidObject());
+  this->accessor.next_active_cell ();
+}
+
+
+template <typename Accessor>
+inline
+void
+TriaActiveIterator<Accessor>::advance_to_next_active (const internal::int2type<false>)
 {
   while (TriaIterator<Accessor>::operator++(),
          (this->state() == IteratorState::valid))
     if (this->accessor.has_children() == false)
-      return *this;
-  return *this;
+      return;
 }
 
 
@@ -35,6 +35,10 @@ namespace hp
 
 namespace internal
 {
+  namespace DoFHandler
+  {
+    class CellDoFIndicesScratch;
+  }
   namespace hp
   {
     namespace DoFHandler
@@ -267,6 +271,24 @@ namespace internal
       get_cell_cache_start (const unsigned int obj_index,
                             const unsigned int dofs_per_cell) const;
 
+      /**
+       * Same as above. The last argument is not used since the hp
+       * DoF indices cache is never compressed, but it is necessary to keep
+       * the interface the same as for the non-hp case.
+       */
+      const types::global_dof_index *
+      get_cell_cache_start (const unsigned int       obj_index,
+                            const unsigned int       dofs_per_cell,
+                            types::global_dof_index *scratch) const;
+
+      /**
+       * Same as above.
+       */
+      const types::global_dof_index *
+      get_cell_cache_start (const unsigned int                                 obj_index,
+                            const unsigned int                                 dofs_per_cell,
+                            dealii::internal::DoFHandler::CellDoFIndicesScratch &scratch) const;
+
       /**
        * Determine an estimate for the
        * memory consumption (in bytes)
@@ -423,6 +445,28 @@ namespace internal
 
       return &cell_dof_indices_cache[cell_cache_offsets[obj_index]];
     }
+
+
+
+    inline
+    const types::global_dof_index *
+    DoFLevel::get_cell_cache_start (const unsigned int       obj_index,
+                                    const unsigned int       dofs_per_cell,
+                                    types::global_dof_index *) const
+    {
+      return get_cell_cache_start (obj_index, dofs_per_cell);
+    }
+
+
+
+    inline
+    const types::global_dof_index *
+    DoFLevel::get_cell_cache_start (const unsigned int                                 obj_index,
+                                    const unsigned int                                 dofs_per_cell,
+                                    dealii::internal::DoFHandler::CellDoFIndicesScratch &) const
+    {
+      return get_cell_cache_start (obj_index, dofs_per_cell);
+    }
   } // namespace hp
 
 } // namespace internal
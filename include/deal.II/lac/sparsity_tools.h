@@ -128,6 +128,11 @@ namespace SparsityTools
    * exception if starting indices are given, taking the latter as an
    * indication that the caller of the function would like to override the
    * part of the algorithm that chooses starting indices.
+   *
+   * The algorithm proceeds front by front. If deal.II is configured with
+   * threads, the neighbors of the last front and their coordination numbers
+   * are determined in parallel for large fronts. The result does not depend
+   * on the number of threads.
    */
   void
   reorder_Cuthill_McKee (const SparsityPattern     &sparsity,
@@ -22,6 +22,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/numerics/data_out_dof_data.h>
 
+#include <deal.II/base/std_cxx1x/function.h>
 #include <deal.II/base/std_cxx1x/shared_ptr.h>
 
 DEAL_II_NAMESPACE_OPEN
@@ -148,6 +149,30 @@ namespace internal
  * this pair of functions and they return a non-active cell, then an exception
  * will be thrown.
  *
+ * For the most common of these cases, there is no need to write a derived
+ * class: the default implementations of first_cell() and next_cell() honor
+ * the selection made by the functions set_cell_selection(),
+ * select_cells_in_box(), select_cells_with_material_id() and
+ * set_output_level(). The first three restrict output to the cells that
+ * satisfy a condition, for example to the part of the domain one is
+ * interested in, while the last one produces output on the cells of a
+ * coarser level of the mesh, using interpolated values of the solution on
+ * all cells that are refined beyond this level. In addition,
+ * set_cell_subdivisions() allows to choose the number of subdivisions of
+ * the patch of each cell individually, for example depending on the size
+ * of the cell. Used together, these functions allow to produce output for
+ * frequent monitoring of a computation at a small fraction of the cost and
+ * size of the full output:
+ * @code
+ *   DataOut<dim> data_out;
+ *   data_out.attach_dof_handler (dof_handler);
+ *   data_out.add_data_vector (solution, "solution");
+ *
+ *   data_out.select_cells_in_box (Point<dim>(0,0), Point<dim>(0.5,0.5));
+ *   data_out.set_output_level (3);
+ *   data_out.build_patches ();
+ * @endcode
+ *
  * @pre This class only makes sense if the first template
  * argument, <code>dim</code> equals the dimension of the
  * DoFHandler type given as the second template argument, i.e., if
@@ -180,6 +205,11 @@ public:
     curved_inner_cells
   };
 
+  /**
+   * Constructor.
+   */
+  DataOut ();
+
   /**
    * This is the central function of this class since it builds the list of
    * patches to be written by the low-level functions of the base class. See
@@ -219,10 +249,110 @@ public:
                               const unsigned int n_subdivisions = 0,
                               const CurvedCellRegion curved_region = curved_boundary);
 
+  /**
+   * Build the patches for the cells selected by first_cell() and
+   * next_cell() in groups of @p n_cells_per_piece cells, and write each
+   * group to @p out as a separate <tt>Piece</tt> of a VTU file as soon
+   * as its patches have been built. Visualization programs show the
+   * resulting file just like the one produced by calling
+   * build_patches() followed by DataOutInterface::write_vtu(). However,
+   * only the patches of one group of cells are held in memory at any
+   * given time. Since the patches may need several times the memory of
+   * the solution vectors themselves if many subdivisions are used, this
+   * function allows to write output for meshes for which the patches
+   * of all cells would not fit into memory at once.
+   *
+   * The arguments @p mapping, @p n_subdivisions and @p curved_region
+   * have the same meaning as for build_patches(). The output is
+   * controlled by the flags set by DataOutInterface::set_flags() for
+   * the VTK formats. This function does not change the patches stored
+   * by this object, so functions like DataOutInterface::write_vtk()
+   * still output the patches created by the last call to
+   * build_patches().
+   */
+  void write_vtu_in_pieces (std::ostream &out,
+                            const Mapping<DH::dimension,DH::space_dimension> &mapping,
+                            const unsigned int n_subdivisions = 0,
+                            const unsigned int n_cells_per_piece = 4096,
+                            const CurvedCellRegion curved_region = curved_boundary);
+
+  /**
+   * Only create patches for the cells for which @p predicate returns
+   * <tt>true</tt>. This replaces any selection made previously by this
+   * function, select_cells_in_box() or select_cells_with_material_id(),
+   * but may be combined with set_output_level().
+   *
+   * The selection is evaluated by the default implementations of
+   * first_cell() and next_cell(), and consequently has no effect if a
+   * derived class overloads these functions.
+   */
+  void set_cell_selection (const std_cxx1x::function<bool (const cell_iterator &)> &predicate);
+
+  /**
+   * Only create patches for the cells that intersect the box with the
+   * opposite corners @p p1 and @p p2, i.e., for the cells whose vertices
+   * are not all on one side of any of the faces of the box. See
+   * set_cell_selection() for how this interacts with other selections.
+   */
+  void select_cells_in_box (const Point<DH::space_dimension> &p1,
+                            const Point<DH::space_dimension> &p2);
+
+  /**
+   * Only create patches for the cells with the given material id. See
+   * set_cell_selection() for how this interacts with other selections.
+   */
+  void select_cells_with_material_id (const types::material_id material_id);
+
+  /**
+   * Create patches for the cells on the given @p level of the mesh and
+   * for the active cells on all coarser levels, rather than for the
+   * active cells. The solution on cells that are refined beyond
+   * @p level is interpolated to the cell on this level, so the output
+   * is that of the solution on a coarser mesh. Passing
+   * numbers::invalid_unsigned_int restores the default of creating
+   * patches for all active cells.
+   *
+   * Since cell data cannot be interpolated to coarser cells, this
+   * function can not be used if cell data has been added, unless the
+   * mesh has no active cells beyond @p level. Likewise, it requires
+   * DoFHandler objects with a single finite element, and
+   * triangulations that are not distributed across processors.
+   */
+  void set_output_level (const unsigned int level);
+
+  /**
+   * Use the number of subdivisions returned by @p n_subdivisions for
+   * the patch of each cell, rather than the same number for all cells.
+   * The argument given to build_patches() or write_vtu_in_pieces() is
+   * then ignored. This allows, for example, to resolve large cells with
+   * more subdivisions than small ones so that the output has a
+   * resolution that is roughly uniform across the domain:
+   * @code
+   *   unsigned int subdivisions_by_size (const DataOut<dim>::cell_iterator &cell)
+   *   {
+   *     return std::max (1, static_cast<int>(cell->diameter() / h_output));
+   *   }
+   *
+   *   data_out.set_cell_subdivisions (&subdivisions_by_size);
+   * @endcode
+   *
+   * Patches are only marked as neighbors of each other if they have the
+   * same number of subdivisions.
+   */
+  void set_cell_subdivisions (const std_cxx1x::function<unsigned int (const cell_iterator &)> &n_subdivisions);
+
+  /**
+   * Reset the choices made by the functions above, so that patches with
+   * the number of subdivisions given to build_patches() are created for
+   * all active cells again.
+   */
+  void clear_cell_selection ();
+
   /**
    * Return the first cell which we want output for. The default
-   * implementation returns the first active cell, but you might want to
-   * return other cells in a derived class.
+   * implementation returns the first active cell, or the first cell
+   * selected by the functions above, but you might want to return other
+   * cells in a derived class.
    */
   virtual cell_iterator first_cell ();
 
@@ -230,12 +360,12 @@ public:
    * Return the next cell after @p cell which we want output for.  If there
    * are no more cells, <tt>#dofs->end()</tt> shall be returned.
    *
-   * The default implementation returns the next active cell, but you might
-   * want to return other cells in a derived class. Note that the default
-   * implementation assumes that the given @p cell is active, which is
-   * guaranteed as long as first_cell() is also used from the default
-   * implementation. Overloading only one of the two functions might not be a
-   * good idea.
+   * The default implementation returns the next active cell, or the next
+   * cell selected by the functions above, but you might want to return
+   * other cells in a derived class. Note that the default implementation
+   * assumes that the given @p cell has been produced by the default
+   * implementation of first_cell(). Overloading only one of the two
+   * functions might not be a good idea.
    */
   virtual cell_iterator next_cell (const cell_iterator &cell);
 
@@ -248,6 +378,41 @@ public:
                   << ", is not valid.");
 
 private:
+  /**
+   * The selection of cells set by set_cell_selection(),
+   * select_cells_in_box() or select_cells_with_material_id(). Empty if
+   * all cells are to be output.
+   */
+  std_cxx1x::function<bool (const cell_iterator &)> cell_selection;
+
+  /**
+   * The level set by set_output_level(), or
+   * numbers::invalid_unsigned_int if output is to be produced on the
+   * active cells.
+   */
+  unsigned int output_level;
+
+  /**
+   * The function set by set_cell_subdivisions(). Empty if all cells use
+   * the same number of subdivisions.
+   */
+  std_cxx1x::function<unsigned int (const cell_iterator &)> cell_subdivisions;
+
+  /**
+   * Return whether @p cell is one of the cells selected by the
+   * functions above.
+   */
+  bool is_selected (const cell_iterator &cell) const;
+
+  /**
+   * The predicates used by select_cells_in_box() and
+   * select_cells_with_material_id().
+   */
+  static bool cell_intersects_box (const cell_iterator &cell,
+                                   const Point<DH::space_dimension> &lower,
+                                   const Point<DH::space_dimension> &upper);
+  static bool cell_has_material_id (const cell_iterator &cell,
+                                    const types::material_id material_id);
 
   /**
    * Return the first cell produced by the first_cell()/next_cell() function
@@ -263,15 +428,51 @@ private:
    */
   cell_iterator next_locally_owned_cell (const cell_iterator &cell);
 
+  /**
+   * Collect the locally owned cells for which we create patches, along
+   * with their index among the active cells of the triangulation, in
+   * @p all_cells. The position of a cell in this list is the number of
+   * its patch. @p cell_to_patch_index_map maps level and index of each
+   * of these cells to this number.
+   *
+   * @p subdivisions receives the number of subdivisions of the patch of
+   * each cell: @p n_subdivisions, or the value returned by the function
+   * set by set_cell_subdivisions(). In the latter case, the cells are
+   * sorted by this number so that cells with the same number form
+   * contiguous ranges that can be given to build_patches_for_cells().
+   */
+  void get_cells_and_patch_indices (const unsigned int n_subdivisions,
+                                    std::vector<std::pair<cell_iterator, unsigned int> > &all_cells,
+                                    std::vector<std::vector<unsigned int> > &cell_to_patch_index_map,
+                                    std::vector<unsigned int> &subdivisions);
+
+  /**
+   * Build the patches for the range <tt>[begin,end)</tt> of the list of
+   * cells created by get_cells_and_patch_indices(). The first of these
+   * cells has the patch number @p first_patch_index, and @p patches must
+   * have as many elements as there are cells in the range.
+   */
+  void build_patches_for_cells (const std::pair<cell_iterator, unsigned int> *begin,
+                                const std::pair<cell_iterator, unsigned int> *end,
+                                const unsigned int first_patch_index,
+                                const Mapping<DH::dimension,DH::space_dimension> &mapping,
+                                const unsigned int n_subdivisions,
+                                const CurvedCellRegion curved_region,
+                                const std::vector<std::vector<unsigned int> > &cell_to_patch_index_map,
+                                std::vector<dealii::DataOutBase::Patch<DH::dimension, DH::space_dimension> > &patches);
+
   /**
    * Build one patch. This function is called in a WorkStream context.
    *
-   * The result is written into the patch variable.
+   * The result is written into the element of @p patches that
+   * corresponds to the patch number of the cell, minus
+   * @p first_patch_index.
    */
   void build_one_patch (const std::pair<cell_iterator, unsigned int> *cell_and_index,
                         internal::DataOut::ParallelData<DH::dimension, DH::space_dimension> &data,
                         ::dealii::DataOutBase::Patch<DH::dimension, DH::space_dimension> &patch,
                         const CurvedCellRegion curved_cell_region,
+                        const unsigned int first_patch_index,
                         std::vector<dealii::DataOutBase::Patch<DH::dimension, DH::space_dimension> > &patches);
 };
 
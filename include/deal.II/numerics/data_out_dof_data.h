@@ -24,6 +24,8 @@
 #include <deal.II/base/data_out_base.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/hp/q_collection.h>
 #include <deal.II/hp/fe_collection.h>
@@ -248,6 +250,104 @@ namespace internal
       std::vector<std_cxx1x::shared_ptr<dealii::hp::FEValues<dim,spacedim> > > x_fe_values;
       std::vector<std_cxx1x::shared_ptr<dealii::hp::FEFaceValues<dim,spacedim> > > x_fe_face_values;
     };
+
+
+
+    /**
+     * A forward iterator over the objects for which one of the DataOut*
+     * classes creates patches, i.e., cells or pairs of a cell and a face
+     * number. The objects are not collected beforehand but produced one
+     * after the other by calling a member function of the @p Owner class,
+     * such as DataOutFaces::next_face(), whenever the iterator is
+     * incremented. This way, the WorkStream that builds the patches
+     * starts working on the first objects right away, and no list of
+     * all objects needs to be held in memory.
+     *
+     * In addition, the iterator can keep track of the position of the
+     * cell of the present object among the active cells of the
+     * triangulation, which is needed to look up cell data. As long as
+     * the objects are produced in the order of the cells, this costs a
+     * constant amount of work per increment. If there is no cell data,
+     * the position is not tracked at all.
+     */
+    template <typename Owner, typename Descriptor>
+    class OutputObjectIterator
+    {
+    public:
+      /**
+       * The type of the member function that produces the object
+       * following a given one.
+       */
+      typedef Descriptor (Owner::*NextFunction) (const Descriptor &);
+
+      /**
+       * Constructor. Point to @p object, and produce the following
+       * objects by calling @p next on @p owner. The end iterator does
+       * not need an owner. The position of the cell among the active
+       * cells is only tracked if @p track_active_cell_index is true.
+       */
+      OutputObjectIterator (const Descriptor   &object,
+                            Owner              *owner = 0,
+                            const NextFunction  next = 0,
+                            const bool          track_active_cell_index = true);
+
+      /**
+       * Advance to the next object.
+       */
+      OutputObjectIterator &operator ++ ();
+
+      /**
+       * Compare the objects two iterators point to.
+       */
+      bool operator != (const OutputObjectIterator &other) const;
+
+      /**
+       * Access the object this iterator points to.
+       */
+      const Descriptor &operator * () const;
+
+      /**
+       * Same as above.
+       */
+      const Descriptor *operator -> () const;
+
+      /**
+       * Return the position of the cell of the present object among the
+       * active cells of the triangulation. The cell must be active, and
+       * the iterator must have been created with @p
+       * track_active_cell_index set to true.
+       */
+      unsigned int active_cell_index () const;
+
+    private:
+      typedef typename Owner::cell_iterator cell_iterator;
+      typedef TriaActiveIterator<typename cell_iterator::AccessorType> active_cell_iterator;
+
+      Descriptor   object;
+      Owner       *owner;
+      NextFunction next;
+      bool         track_active_cell_index;
+
+      /**
+       * The active cell at position #active_index, or past the end if
+       * the cell of the present object is not active.
+       */
+      active_cell_iterator active_cell;
+      unsigned int         active_index;
+
+      /**
+       * Move #active_cell forward to the cell of the present object,
+       * starting over from the first active cell if the present cell
+       * precedes it.
+       */
+      void update_active_cell ();
+
+      /**
+       * Return the cell of an object.
+       */
+      static const cell_iterator &get_cell (const cell_iterator &cell);
+      static const cell_iterator &get_cell (const std::pair<cell_iterator,unsigned int> &face);
+    };
   }
 }
 
@@ -915,6 +1015,143 @@ merge_patches (const DataOut_DoFData<DH2,patch_dim,patch_space_dim> &source,
 }
 
 
+
+namespace internal
+{
+  namespace DataOut
+  {
+    template <typename Owner, typename Descriptor>
+    inline
+    OutputObjectIterator<Owner,Descriptor>::
+    OutputObjectIterator (const Descriptor   &object,
+                          Owner              *owner,
+                          const NextFunction  next,
+                          const bool          track_active_cell_index)
+      :
+      object (object),
+      owner (owner),
+      next (next),
+      track_active_cell_index (track_active_cell_index),
+      active_index (0)
+    {
+      if (owner != 0)
+        update_active_cell ();
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    OutputObjectIterator<Owner,Descriptor> &
+    OutputObjectIterator<Owner,Descriptor>::operator ++ ()
+    {
+      Assert (owner != 0, ExcInternalError());
+      object = (owner->*next) (object);
+      update_active_cell ();
+      return *this;
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    bool
+    OutputObjectIterator<Owner,Descriptor>::
+    operator != (const OutputObjectIterator &other) const
+    {
+      // all objects whose cell is past the end are the end
+      if ((get_cell(object).state() == IteratorState::past_the_end)
+          &&
+          (get_cell(other.object).state() == IteratorState::past_the_end))
+        return false;
+      return (object != other.object);
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    const Descriptor &
+    OutputObjectIterator<Owner,Descriptor>::operator * () const
+    {
+      return object;
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    const Descriptor *
+    OutputObjectIterator<Owner,Descriptor>::operator -> () const
+    {
+      return &object;
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    unsigned int
+    OutputObjectIterator<Owner,Descriptor>::active_cell_index () const
+    {
+      Assert (track_active_cell_index, ExcInternalError());
+      Assert (get_cell(object)->active(),
+              ExcMessage ("Cell data can only be output on active cells."));
+      return active_index;
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    void
+    OutputObjectIterator<Owner,Descriptor>::update_active_cell ()
+    {
+      if (track_active_cell_index == false)
+        return;
+
+      const cell_iterator &cell = get_cell (object);
+      if ((cell.state() != IteratorState::valid) || !cell->active())
+        return;
+
+      if ((active_cell.state() != IteratorState::valid)
+          ||
+          (cell < cell_iterator(active_cell)))
+        {
+          active_cell = cell->get_triangulation().begin_active();
+          active_index = 0;
+        }
+      while (cell_iterator(active_cell) != cell)
+        {
+          ++active_cell;
+          ++active_index;
+        }
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    const typename OutputObjectIterator<Owner,Descriptor>::cell_iterator &
+    OutputObjectIterator<Owner,Descriptor>::get_cell (const cell_iterator &cell)
+    {
+      return cell;
+    }
+
+
+
+    template <typename Owner, typename Descriptor>
+    inline
+    const typename OutputObjectIterator<Owner,Descriptor>::cell_iterator &
+    OutputObjectIterator<Owner,Descriptor>::
+    get_cell (const std::pair<cell_iterator,unsigned int> &face)
+    {
+      return face.first;
+    }
+  }
+}
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
@@ -108,6 +108,21 @@ namespace internal
  * applications certainly exist, for which the author is not
  * imaginative enough.
  *
+ * The faces are not collected into a list before the patches are built;
+ * rather, first_face() and next_face() are called on the fly while the
+ * patches are built.
+ *
+ * <h3>Parallel computations</h3>
+ *
+ * For triangulations of type parallel::distributed::Triangulation, the
+ * default implementations of first_face() and next_face() only produce the
+ * faces of locally owned cells, so that every processor creates patches
+ * for its own part of the boundary only. The patches of all processors can
+ * then be written into a single file using
+ * DataOutInterface::write_vtu_in_parallel(), or into one file per
+ * processor that is tied together by DataOutInterface::write_pvtu_record(),
+ * just as for the DataOut class.
+ *
  * @pre This class only makes sense if the first template
  * argument, <code>dim</code> equals the dimension of the
  * DoFHandler type given as the second template argument, i.e., if
@@ -238,9 +253,12 @@ public:
    * Return the first face which we
    * want output for. The default
    * implementation returns the
-   * first face of an active cell
-   * or the first such on the
-   * boundary.
+   * first face of a locally owned
+   * active cell or the first such
+   * on the boundary. If there is
+   * no such face, the first
+   * component of the return value
+   * is <tt>dofs->end()</tt>.
    *
    * For more general sets,
    * overload this function in a
@@ -257,13 +275,14 @@ public:
    * component of the return value.
    *
    * The default implementation
-   * returns the next face of an
-   * active cell, or the next such
-   * on the boundary.
+   * returns the next face of a
+   * locally owned active cell, or
+   * the next such on the boundary.
    *
    * This function traverses the
-   * mesh cell by cell (active
-   * only), and then through all
+   * mesh cell by cell (locally
+   * owned active cells only), and
+   * then through all
    * faces of the cell. As a
    * result, interior faces are
    * output twice.
@@ -304,12 +323,20 @@ private:
    */
   const bool surface_only;
 
+  /**
+   * The iterator over the faces
+   * produced by first_face() and
+   * next_face() that is handed to
+   * WorkStream.
+   */
+  typedef internal::DataOut::OutputObjectIterator<DataOutFaces<dim,DH>,FaceDescriptor> FaceIterator;
+
   /**
    * Build one patch. This function
    * is called in a WorkStream
    * context.
    */
-  void build_one_patch (const FaceDescriptor *cell_and_face,
+  void build_one_patch (const FaceIterator &cell_and_face,
                         internal::DataOutFaces::ParallelData<dimension, dimension> &data,
                         DataOutBase::Patch<dimension-1,space_dimension> &patch);
 };
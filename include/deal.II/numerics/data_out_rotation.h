@@ -114,6 +114,19 @@ namespace internal
  * It is in the responsibility of the user to make sure that the
  * radial variable attains only non-negative values.
  *
+ *
+ * <h3>Parallel computations</h3>
+ *
+ * For triangulations of type parallel::distributed::Triangulation, the
+ * default implementations of first_cell() and next_cell() only produce
+ * locally owned cells, so that every processor creates patches for its own
+ * part of the domain only. As for the DataOut class, the patches of all
+ * processors can then be written using
+ * DataOutInterface::write_vtu_in_parallel() or
+ * DataOutInterface::write_pvtu_record(). The cells are not collected into a
+ * list before the patches are built; rather, first_cell() and next_cell()
+ * are called on the fly while the patches are built.
+ *
  * @pre This class only makes sense if the first template
  * argument, <code>dim</code> equals the dimension of the
  * DoFHandler type given as the second template argument, i.e., if
@@ -178,7 +191,8 @@ public:
    * Return the first cell which we
    * want output for. The default
    * implementation returns the
-   * first @ref GlossActive "active cell",
+   * first locally owned
+   * @ref GlossActive "active cell",
    * but you might want to
    * return other cells in a
    * derived class.
@@ -193,7 +207,8 @@ public:
    *
    * The default
    * implementation returns the next
-   * active cell, but you might want
+   * locally owned active cell, but
+   * you might want
    * to return other cells in a derived
    * class. Note that the default
    * implementation assumes that
@@ -221,6 +236,14 @@ public:
                   << "The radial variable attains a negative value of " << arg1);
 
 private:
+  /**
+   * The iterator over the cells
+   * produced by first_cell() and
+   * next_cell() that is handed to
+   * WorkStream.
+   */
+  typedef internal::DataOut::OutputObjectIterator<DataOutRotation<dim,DH>,cell_iterator> CellIterator;
+
   /**
    * Builds every @p n_threads's
    * patch. This function may be
@@ -230,7 +253,7 @@ private:
    * once and generates all patches.
    */
   void
-  build_one_patch (const cell_iterator *cell,
+  build_one_patch (const CellIterator &cell,
                    internal::DataOutRotation::ParallelData<dimension, space_dimension> &data,
                    std::vector<DataOutBase::Patch<dimension+1,space_dimension+1> > &patches);
 };
@@ -33,10 +33,13 @@
 //////////////////////////////////////////////////////////////////////
 
 #include <deal.II/base/data_out_base.h>
+#include <deal.II/base/flat_binary_archive.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx1x/bind.h>
 #include <deal.II/base/std_cxx1x/shared_ptr.h>
 #include <deal.II/base/mpi.h>
 
@@ -225,50 +228,186 @@ namespace
 
 #ifdef DEAL_II_WITH_ZLIB
   /**
-   * Do a zlib compression followed
-   * by a base64 encoding of the
-   * given data. The result is then
-   * written to the given stream.
+   * The number of bytes of uncompressed data that are compressed
+   * into one zlib block by write_compressed_block(), and the number
+   * of bytes of compressed data that are base64-encoded in one
+   * piece. The latter needs to be a multiple of three so that the
+   * encoded pieces can simply be concatenated.
+   */
+  const std::size_t compression_block_size = (1U << 20);
+  const std::size_t encoding_chunk_size    = 3 * (1U << 18);
+
+
+  /**
+   * Convert the compression level given in the flags to the
+   * corresponding zlib constant.
+   */
+  int
+  get_zlib_compression_level (const DataOutBase::VtkFlags::ZlibCompressionLevel level)
+  {
+    switch (level)
+      {
+      case (DataOutBase::VtkFlags::no_compression):
+        return Z_NO_COMPRESSION;
+      case (DataOutBase::VtkFlags::best_speed):
+        return Z_BEST_SPEED;
+      case (DataOutBase::VtkFlags::best_compression):
+        return Z_BEST_COMPRESSION;
+      case (DataOutBase::VtkFlags::default_compression):
+        return Z_DEFAULT_COMPRESSION;
+      default:
+        Assert (false, ExcNotImplemented());
+        return Z_NO_COMPRESSION;
+      }
+  }
+
+
+  /**
+   * Compress the blocks with numbers in the range [begin,end) of
+   * the @p data_size bytes starting at @p data, each into its own
+   * element of @p compressed_blocks.
+   */
+  void compress_blocks (const unsigned int               begin,
+                        const unsigned int               end,
+                        const char                      *data,
+                        const std::size_t                data_size,
+                        const int                        compression_level,
+                        std::vector<std::vector<char> > &compressed_blocks)
+  {
+    for (unsigned int block=begin; block<end; ++block)
+      {
+        const std::size_t offset = block * compression_block_size;
+        const std::size_t size   = std::min (compression_block_size,
+                                             data_size - offset);
+
+        uLongf compressed_length = compressBound (size);
+        compressed_blocks[block].resize (compressed_length);
+        const int err = compress2 ((Bytef *) &compressed_blocks[block][0],
+                                   &compressed_length,
+                                   (const Bytef *) (data + offset),
+                                   size,
+                                   compression_level);
+        Assert (err == Z_OK, ExcInternalError());
+        (void)err;
+        compressed_blocks[block].resize (compressed_length);
+      }
+  }
+
+
+  /**
+   * Base64-encode the chunks of @p encoding_chunk_size bytes with
+   * numbers in the range [begin,end) of the @p data_size bytes
+   * starting at @p data. Since the chunk size is a multiple of three,
+   * every chunk but the last one is encoded into exactly 4/3 as many
+   * characters, and the result can be written directly into its final
+   * place in @p encoded_data. The last chunk also gets the padding and
+   * the terminating zero.
+   */
+  void encode_chunks (const unsigned int begin,
+                      const unsigned int end,
+                      const char        *data,
+                      const std::size_t  data_size,
+                      char              *encoded_data)
+  {
+    for (unsigned int chunk=begin; chunk<end; ++chunk)
+      {
+        const std::size_t offset = chunk * encoding_chunk_size;
+        const std::size_t size   = std::min (encoding_chunk_size,
+                                             data_size - offset);
+        char *encoded_chunk = encoded_data + offset / 3 * 4;
+
+        base64::base64_encodestate state;
+        base64::base64_init_encodestate(&state);
+        const int encoded_length
+          = base64::base64_encode_block (data + offset, size,
+                                         encoded_chunk, &state);
+        if (offset + size == data_size)
+          base64::base64_encode_blockend (encoded_chunk + encoded_length,
+                                          &state);
+      }
+  }
+
+
+  /**
+   * Do a zlib compression followed by a base64 encoding of the given
+   * data. The result is then written to the given stream.
+   *
+   * The data is cut into blocks of compression_block_size bytes that
+   * are compressed independently and in parallel, and the compressed
+   * data is then encoded in parallel as well. The output uses the
+   * multi-block header of the VTK zlib compressor, consisting of the
+   * number of blocks, the uncompressed size of a block, the
+   * uncompressed size of the last block, and the compressed sizes of
+   * all blocks.
    */
   template <typename T>
-  void write_compressed_block (const std::vector<T> &data,
-                               std::ostream         &output_stream)
+  void write_compressed_block (const std::vector<T>                            &data,
+                               const DataOutBase::VtkFlags::ZlibCompressionLevel level,
+                               std::ostream                                    &output_stream)
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing
-        // data and do so
-        uLongf compressed_data_length
-          = compressBound (data.size() * sizeof(T));
-        char *compressed_data = new char[compressed_data_length];
-        int err = compress2 ((Bytef *) compressed_data,
-                             &compressed_data_length,
-                             (const Bytef *) &data[0],
-                             data.size() * sizeof(T),
-                             Z_BEST_COMPRESSION);
-        Assert (err == Z_OK, ExcInternalError());
+        const std::size_t data_size = data.size() * sizeof(T);
+        const unsigned int n_blocks
+          = (data_size + compression_block_size - 1) / compression_block_size;
+
+        // compress all blocks
+        std::vector<std::vector<char> > compressed_blocks (n_blocks);
+        parallel::apply_to_subranges (0U, n_blocks,
+                                      std_cxx1x::bind (&compress_blocks,
+                                                       std_cxx1x::_1,
+                                                       std_cxx1x::_2,
+                                                       (const char *) &data[0],
+                                                       data_size,
+                                                       get_zlib_compression_level (level),
+                                                       std_cxx1x::ref(compressed_blocks)),
+                                      1);
 
         // now encode the compression header
-        const uint32_t compression_header[4]
-          = { 1,                                   /* number of blocks */
-              (uint32_t)(data.size() * sizeof(T)), /* size of block */
-              (uint32_t)(data.size() * sizeof(T)), /* size of last block */
-              (uint32_t)compressed_data_length
-            }; /* list of compressed sizes of blocks */
+        std::vector<uint32_t> compression_header (3 + n_blocks);
+        compression_header[0] = n_blocks;
+        compression_header[1] = (uint32_t)std::min (compression_block_size,
+                                                    data_size);
+        compression_header[2] = (uint32_t)(data_size -
+                                           (n_blocks-1) * compression_block_size);
+        std::size_t compressed_data_size = 0;
+        for (unsigned int block=0; block<n_blocks; ++block)
+          {
+            compression_header[3+block] = compressed_blocks[block].size();
+            compressed_data_size += compressed_blocks[block].size();
+          }
 
         char *encoded_header = encode_block ((char *)&compression_header[0],
-                                             4 * sizeof(compression_header[0]));
+                                             compression_header.size() *
+                                             sizeof(compression_header[0]));
         output_stream << encoded_header;
         delete[] encoded_header;
 
-        // next do the compressed
-        // data encoding in base64
-        char *encoded_data = encode_block (compressed_data,
-                                           compressed_data_length);
-        delete[] compressed_data;
+        // next collect the compressed blocks and do their encoding in
+        // base64 as one stream of data
+        std::vector<char> compressed_data;
+        compressed_data.reserve (compressed_data_size);
+        for (unsigned int block=0; block<n_blocks; ++block)
+          {
+            compressed_data.insert (compressed_data.end(),
+                                    compressed_blocks[block].begin(),
+                                    compressed_blocks[block].end());
+            std::vector<char>().swap (compressed_blocks[block]);
+          }
 
-        output_stream << encoded_data;
-        delete[] encoded_data;
+        const unsigned int n_chunks
+          = (compressed_data_size + encoding_chunk_size - 1) / encoding_chunk_size;
+        std::vector<char> encoded_data ((compressed_data_size + 2) / 3 * 4 + 1);
+        parallel::apply_to_subranges (0U, n_chunks,
+                                      std_cxx1x::bind (&encode_chunks,
+                                                       std_cxx1x::_1,
+                                                       std_cxx1x::_2,
+                                                       (const char *) &compressed_data[0],
+                                                       compressed_data_size,
+                                                       &encoded_data[0]),
+                                      1);
+
+        output_stream << &encoded_data[0];
       }
   }
 #endif
@@ -1235,10 +1374,123 @@ namespace
      * Int32)
      */
     std::vector<double>  vertices;
+    std::vector<float>   single_precision_vertices;
     std::vector<int32_t> cells;
   };
 
 
+
+  /**
+   * Return the name under which the components given by @p range are
+   * written as a vector to VTK and VTU files. Unless a name has been
+   * given for the vector, this is the concatenation of the names of all
+   * components with double underscores.
+   */
+  std::string
+  get_vtk_vector_name (const std::vector<std::string> &data_names,
+                       const std_cxx1x::tuple<unsigned int, unsigned int, std::string> &range)
+  {
+    if (std_cxx1x::get<2>(range) != "")
+      return std_cxx1x::get<2>(range);
+
+    std::string name;
+    for (unsigned int i=std_cxx1x::get<0>(range); i<std_cxx1x::get<1>(range); ++i)
+      name += data_names[i] + "__";
+    name += data_names[std_cxx1x::get<1>(range)];
+    return name;
+  }
+
+
+
+  /**
+   * Return the name of the VTK data type that corresponds to the given
+   * precision.
+   */
+  const char *
+  get_vtk_data_type (const DataOutBase::VtkFlags::OutputPrecision precision)
+  {
+    return (precision == DataOutBase::VtkFlags::single_precision
+            ?
+            "Float32"
+            :
+            "Float64");
+  }
+
+
+
+  /**
+   * Write the components [first_component, first_component+n_components)
+   * of @p data_vectors as a vector field with three components per point
+   * to @p vtu_out, padding with zeros, using the floating point type
+   * @p Number.
+   */
+  template <typename Number>
+  void
+  write_vtu_vector_field (const Table<2,double> &data_vectors,
+                          const unsigned int     first_component,
+                          const unsigned int     n_components,
+                          const unsigned int     n_nodes,
+                          VtuStream             &vtu_out)
+  {
+    Assert (n_components <= 3, ExcInternalError());
+
+    std::vector<Number> data;
+    data.reserve (3*n_nodes);
+    for (unsigned int n=0; n<n_nodes; ++n)
+      for (unsigned int c=0; c<3; ++c)
+        data.push_back (c < n_components
+                        ?
+                        static_cast<Number>(data_vectors(first_component+c, n))
+                        :
+                        0);
+    vtu_out << data;
+  }
+
+
+
+  /**
+   * Write the coordinates of points, given as @p node_dim consecutive
+   * values per point in @p node_data, to @p vtu_out using the floating
+   * point type @p Number. VTU files always need three coordinates per
+   * point, so missing ones are filled with zeros.
+   */
+  template <typename Number>
+  void
+  write_vtu_points (const std::vector<double> &node_data,
+                    const unsigned int         node_dim,
+                    VtuStream                 &vtu_out)
+  {
+    const unsigned int n_nodes = node_data.size() / node_dim;
+    std::vector<Number> vertices;
+    vertices.reserve (3*n_nodes);
+    for (unsigned int n=0; n<n_nodes; ++n)
+      for (unsigned int d=0; d<3; ++d)
+        vertices.push_back (d < node_dim
+                            ?
+                            static_cast<Number>(node_data[n*node_dim+d])
+                            :
+                            0);
+    vtu_out << vertices;
+  }
+
+
+
+  /**
+   * Write component @p data_set of @p data_vectors as a scalar field to
+   * @p vtu_out, using the floating point type @p Number.
+   */
+  template <typename Number>
+  void
+  write_vtu_scalar_field (const Table<2,double> &data_vectors,
+                          const unsigned int     data_set,
+                          VtuStream             &vtu_out)
+  {
+    const std::vector<Number> data (data_vectors[data_set].begin(),
+                                    data_vectors[data_set].end());
+    vtu_out << data;
+  }
+
+
 //----------------------------------------------------------------------//
 
   DXStream::DXStream(std::ostream &out,
@@ -1639,10 +1891,20 @@ namespace
     // if we want to compress, then
     // first collect all the data in
     // an array
-    for (unsigned int i=0; i<dim; ++i)
-      vertices.push_back(p[i]);
-    for (unsigned int i=dim; i<3; ++i)
-      vertices.push_back(0);
+    if (flags.coordinate_precision == DataOutBase::VtkFlags::single_precision)
+      {
+        for (unsigned int i=0; i<dim; ++i)
+          single_precision_vertices.push_back(p[i]);
+        for (unsigned int i=dim; i<3; ++i)
+          single_precision_vertices.push_back(0);
+      }
+    else
+      {
+        for (unsigned int i=0; i<dim; ++i)
+          vertices.push_back(p[i]);
+        for (unsigned int i=dim; i<3; ++i)
+          vertices.push_back(0);
+      }
 #endif
   }
 
@@ -1654,8 +1916,16 @@ namespace
     // compress the data we have in
     // memory and write them to the
     // stream. then release the data
-    *this << vertices << '\n';
-    vertices.clear ();
+    if (flags.coordinate_precision == DataOutBase::VtkFlags::single_precision)
+      {
+        *this << single_precision_vertices << '\n';
+        single_precision_vertices.clear ();
+      }
+    else
+      {
+        *this << vertices << '\n';
+        vertices.clear ();
+      }
 #endif
   }
 
@@ -1726,7 +1996,7 @@ namespace
     // compress the data we have in
     // memory and write them to the
     // stream. then release the data
-    write_compressed_block (data, stream);
+    write_compressed_block (data, flags.compression_level, stream);
 #else
     for (unsigned int i=0; i<data.size(); ++i)
       stream << data[i] << ' ';
@@ -2395,48 +2665,123 @@ namespace DataOutBase
 
   VtkFlags::VtkFlags (const double time,
                       const unsigned int cycle,
-                      const bool print_date_and_time)
+                      const bool print_date_and_time,
+                      const ZlibCompressionLevel compression_level,
+                      const bool filter_duplicate_vertices)
     :
     time (time),
     cycle (cycle),
-    print_date_and_time (print_date_and_time)
+    print_date_and_time (print_date_and_time),
+    compression_level (compression_level),
+    filter_duplicate_vertices (filter_duplicate_vertices),
+    coordinate_precision (double_precision),
+    data_precision (double_precision)
   {}
 
 
 
-  void VtkFlags::declare_parameters (ParameterHandler &/*prm*/)
-  {}
+  VtkFlags::OutputPrecision
+  VtkFlags::get_precision (const std::string &field_name) const
+  {
+    const std::map<std::string,OutputPrecision>::const_iterator
+    p = field_precision.find (field_name);
+    return (p != field_precision.end() ? p->second : data_precision);
+  }
 
 
 
-  void VtkFlags::parse_parameters (const ParameterHandler &/*prm*/) const
-  {}
+  void VtkFlags::declare_parameters (ParameterHandler &prm)
+  {
+    prm.declare_entry ("Print date and time", "true",
+                       Patterns::Bool(),
+                       "Whether the date and time of creation should be "
+                       "written as a comment into the output file.");
+    prm.declare_entry ("Compression level", "best compression",
+                       Patterns::Selection ("no compression|best speed|"
+                                            "best compression|default compression"),
+                       "The level at which zlib, if available, compresses "
+                       "the data of VTU files.");
+    prm.declare_entry ("Filter duplicate vertices", "false",
+                       Patterns::Bool(),
+                       "Whether points shared between neighboring patches "
+                       "are written only once to VTU files. Only set this "
+                       "if all output fields are continuous.");
+    prm.declare_entry ("Coordinate precision", "Float64",
+                       Patterns::Selection ("Float32|Float64"),
+                       "The floating point format in which the coordinates "
+                       "of points are written to VTU files.");
+    prm.declare_entry ("Data precision", "Float64",
+                       Patterns::Selection ("Float32|Float64"),
+                       "The floating point format in which data values "
+                       "are written to VTU files.");
+  }
+
+
+
+  void VtkFlags::parse_parameters (const ParameterHandler &prm)
+  {
+    print_date_and_time = prm.get_bool ("Print date and time");
+
+    const std::string level = prm.get ("Compression level");
+    if (level == "no compression")
+      compression_level = no_compression;
+    else if (level == "best speed")
+      compression_level = best_speed;
+    else if (level == "best compression")
+      compression_level = best_compression;
+    else if (level == "default compression")
+      compression_level = default_compression;
+    else
+      Assert (false, ExcInternalError());
+
+    filter_duplicate_vertices = prm.get_bool ("Filter duplicate vertices");
+
+    coordinate_precision = (prm.get ("Coordinate precision") == "Float32"
+                            ?
+                            single_precision
+                            :
+                            double_precision);
+    data_precision = (prm.get ("Data precision") == "Float32"
+                      ?
+                      single_precision
+                      :
+                      double_precision);
+  }
 
 
 
   std::size_t
   VtkFlags::memory_consumption () const
   {
-    // only simple data elements, so
-    // use sizeof operator
-    return sizeof (*this);
+    std::size_t mem = sizeof (*this);
+    for (std::map<std::string,OutputPrecision>::const_iterator
+         p = field_precision.begin(); p != field_precision.end(); ++p)
+      mem += MemoryConsumption::memory_consumption (p->first) + sizeof (p->second);
+    return mem;
   }
 
 
-  Deal_II_IntermediateFlags::Deal_II_IntermediateFlags ()
+  Deal_II_IntermediateFlags::Deal_II_IntermediateFlags (const bool binary)
     :
-    dummy (0)
+    binary (binary)
   {}
 
 
 
-  void Deal_II_IntermediateFlags::declare_parameters (ParameterHandler &/*prm*/)
-  {}
+  void Deal_II_IntermediateFlags::declare_parameters (ParameterHandler &prm)
+  {
+    prm.declare_entry ("Binary", "false",
+                       Patterns::Bool(),
+                       "Whether to write the patches in binary rather than "
+                       "text representation.");
+  }
 
 
 
-  void Deal_II_IntermediateFlags::parse_parameters (const ParameterHandler &/*prm*/) const
-  {}
+  void Deal_II_IntermediateFlags::parse_parameters (const ParameterHandler &prm)
+  {
+    binary = prm.get_bool ("Binary");
+  }
 
 
   std::size_t
@@ -5472,18 +5817,11 @@ namespace DataOutBase
             // component names with double
             // underscores unless a vector
             // name has been specified
-            out << "    <DataArray type=\"Float64\" Name=\"";
-
-            if (std_cxx1x::get<2>(vector_data_ranges[n_th_vector]) != "")
-              out << std_cxx1x::get<2>(vector_data_ranges[n_th_vector]);
-            else
-              {
-                for (unsigned int i=std_cxx1x::get<0>(vector_data_ranges[n_th_vector]);
-                     i<std_cxx1x::get<1>(vector_data_ranges[n_th_vector]);
-                     ++i)
-                  out << data_names[i] << "__";
-                out << data_names[std_cxx1x::get<1>(vector_data_ranges[n_th_vector])];
-              }
+            const std::string vector_name
+              = get_vtk_vector_name (data_names, vector_data_ranges[n_th_vector]);
+            out << "    <DataArray type=\""
+                << get_vtk_data_type (flags.get_precision (vector_name))
+                << "\" Name=\"" << vector_name;
 
             out << "\" NumberOfComponents=\"3\"></DataArray>\n";
           }
@@ -5491,7 +5829,9 @@ namespace DataOutBase
         for (unsigned int data_set=0; data_set<data_names.size(); ++data_set)
           if (data_set_written[data_set] == false)
             {
-              out << "    <DataArray type=\"Float64\" Name=\""
+              out << "    <DataArray type=\""
+                  << get_vtk_data_type (flags.get_precision (data_names[data_set]))
+                  << "\" Name=\""
                   << data_names[data_set]
                   << "\"></DataArray>\n";
             }
@@ -5594,6 +5934,21 @@ namespace DataOutBase
     Threads::Task<> reorder_task = Threads::new_task (fun_ptr, patches,
                                                       data_vectors);
 
+    // if so requested, merge the points shared between patches. the
+    // filter then provides the merged points and the connectivity in
+    // terms of them
+    DataOutFilter filter (DataOutFilterFlags (true, false));
+    if (flags.filter_duplicate_vertices)
+      {
+        write_nodes(patches, filter);
+        write_cells(patches, filter);
+      }
+    const unsigned int n_output_nodes = (flags.filter_duplicate_vertices
+                                         ?
+                                         filter.n_nodes()
+                                         :
+                                         n_nodes);
+
     ///////////////////////////////
     // first make up a list of used
     // vertices along with their
@@ -5602,12 +5957,26 @@ namespace DataOutBase
     // note that according to the standard, we
     // have to print d=1..3 dimensions, even if
     // we are in reality in 2d, for example
-    out << "<Piece NumberOfPoints=\"" << n_nodes
+    out << "<Piece NumberOfPoints=\"" << n_output_nodes
         <<"\" NumberOfCells=\"" << n_cells << "\" >\n";
     out << "  <Points>\n";
-    out << "    <DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\""
+    out << "    <DataArray type=\""
+        << get_vtk_data_type (flags.coordinate_precision)
+        << "\" NumberOfComponents=\"3\" format=\""
         << ascii_or_binary << "\">\n";
-    write_nodes(patches, vtu_out);
+    if (flags.filter_duplicate_vertices)
+      {
+        std::vector<double> node_data;
+        filter.fill_node_data (node_data);
+
+        if (flags.coordinate_precision == VtkFlags::single_precision)
+          write_vtu_points<float> (node_data, spacedim, vtu_out);
+        else
+          write_vtu_points<double> (node_data, spacedim, vtu_out);
+        out << '\n';
+      }
+    else
+      write_nodes(patches, vtu_out);
     out << "    </DataArray>\n";
     out << "  </Points>\n\n";
     /////////////////////////////////
@@ -5615,7 +5984,15 @@ namespace DataOutBase
     out << "  <Cells>\n";
     out << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\""
         << ascii_or_binary << "\">\n";
-    write_cells(patches, vtu_out);
+    if (flags.filter_duplicate_vertices)
+      {
+        std::vector<unsigned int> cell_data;
+        filter.fill_cell_data (0, cell_data);
+        vtu_out << std::vector<int32_t> (cell_data.begin(), cell_data.end());
+        out << '\n';
+      }
+    else
+      write_cells(patches, vtu_out);
     out << "    </DataArray>\n";
 
     // XML VTU format uses offsets; this is
@@ -5665,6 +6042,22 @@ namespace DataOutBase
     // data is in place
     reorder_task.join ();
 
+    // if points were merged, only keep one value per merged point
+    if (flags.filter_duplicate_vertices)
+      {
+        Table<2,double> filtered_data_vectors (n_data_sets, n_output_nodes);
+        for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
+          {
+            filter.write_data_set (data_names[data_set], 1, data_set,
+                                   data_vectors);
+            const double *values = filter.get_data_set (data_set);
+            for (unsigned int n=0; n<n_output_nodes; ++n)
+              filtered_data_vectors(data_set, n) = values[n];
+          }
+        data_vectors.swap (filtered_data_vectors);
+        n_nodes = n_output_nodes;
+      }
+
     // then write data.  the
     // 'POINT_DATA' means: node data
     // (as opposed to cell data, which
@@ -5704,18 +6097,11 @@ namespace DataOutBase
         // component names with double
         // underscores unless a vector
         // name has been specified
-        out << "    <DataArray type=\"Float64\" Name=\"";
-
-        if (std_cxx1x::get<2>(vector_data_ranges[n_th_vector]) != "")
-          out << std_cxx1x::get<2>(vector_data_ranges[n_th_vector]);
-        else
-          {
-            for (unsigned int i=std_cxx1x::get<0>(vector_data_ranges[n_th_vector]);
-                 i<std_cxx1x::get<1>(vector_data_ranges[n_th_vector]);
-                 ++i)
-              out << data_names[i] << "__";
-            out << data_names[std_cxx1x::get<1>(vector_data_ranges[n_th_vector])];
-          }
+        const std::string vector_name
+          = get_vtk_vector_name (data_names, vector_data_ranges[n_th_vector]);
+        out << "    <DataArray type=\""
+            << get_vtk_data_type (flags.get_precision (vector_name))
+            << "\" Name=\"" << vector_name;
 
         out << "\" NumberOfComponents=\"3\" format=\""
             << ascii_or_binary << "\">\n";
@@ -5723,42 +6109,15 @@ namespace DataOutBase
         // now write data. pad all
         // vectors to have three
         // components
-        std::vector<double> data;
-        data.reserve (n_nodes*dim);
-
-        for (unsigned int n=0; n<n_nodes; ++n)
-          {
-            switch (std_cxx1x::get<1>(vector_data_ranges[n_th_vector]) -
-                    std_cxx1x::get<0>(vector_data_ranges[n_th_vector]))
-              {
-              case 0:
-                data.push_back (data_vectors(std_cxx1x::get<0>(vector_data_ranges[n_th_vector]), n));
-                data.push_back (0);
-                data.push_back (0);
-                break;
-
-              case 1:
-                data.push_back (data_vectors(std_cxx1x::get<0>(vector_data_ranges[n_th_vector]),   n));
-                data.push_back (data_vectors(std_cxx1x::get<0>(vector_data_ranges[n_th_vector])+1, n));
-                data.push_back (0);
-                break;
-              case 2:
-                data.push_back (data_vectors(std_cxx1x::get<0>(vector_data_ranges[n_th_vector]),   n));
-                data.push_back (data_vectors(std_cxx1x::get<0>(vector_data_ranges[n_th_vector])+1, n));
-                data.push_back (data_vectors(std_cxx1x::get<0>(vector_data_ranges[n_th_vector])+2, n));
-                break;
-
-              default:
-                // VTK doesn't
-                // support
-                // anything else
-                // than vectors
-                // with 1, 2, or
-                // 3 components
-                Assert (false, ExcInternalError());
-              }
-          }
-        vtu_out << data;
+        const unsigned int first_component = std_cxx1x::get<0>(vector_data_ranges[n_th_vector]);
+        const unsigned int n_components = (std_cxx1x::get<1>(vector_data_ranges[n_th_vector])
+                                           - first_component + 1);
+        if (flags.get_precision (vector_name) == VtkFlags::single_precision)
+          write_vtu_vector_field<float> (data_vectors, first_component, n_components,
+                                         n_nodes, vtu_out);
+        else
+          write_vtu_vector_field<double> (data_vectors, first_component, n_components,
+                                          n_nodes, vtu_out);
         out << "    </DataArray>\n";
       }
 
@@ -5766,14 +6125,19 @@ namespace DataOutBase
     for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
       if (data_set_written[data_set] == false)
         {
-          out << "    <DataArray type=\"Float64\" Name=\""
+          const VtkFlags::OutputPrecision precision
+            = flags.get_precision (data_names[data_set]);
+          out << "    <DataArray type=\""
+              << get_vtk_data_type (precision)
+              << "\" Name=\""
               << data_names[data_set]
               << "\" format=\""
               << ascii_or_binary << "\">\n";
 
-          std::vector<double> data (data_vectors[data_set].begin(),
-                                    data_vectors[data_set].end());
-          vtu_out << data;
+          if (precision == VtkFlags::single_precision)
+            write_vtu_scalar_field<float> (data_vectors, data_set, vtu_out);
+          else
+            write_vtu_scalar_field<double> (data_vectors, data_set, vtu_out);
           out << "    </DataArray>\n";
         }
 
@@ -6442,12 +6806,86 @@ namespace DataOutBase
 
 
 
+  namespace
+  {
+    /**
+     * The header line that distinguishes the binary from the text
+     * version of the intermediate format.
+     */
+    const char binary_intermediate_format_header[]
+      = "[deal.II intermediate format binary graphics data]";
+
+    /**
+     * The tag of the FlatBinaryOArchive that holds the data of a
+     * binary intermediate format file.
+     */
+    template <int dim, int spacedim>
+    std::string
+    binary_intermediate_format_tag ()
+    {
+      std::ostringstream s;
+      s << "DataOutBase::Patch<" << dim << ',' << spacedim << ">, version "
+        << Deal_II_IntermediateFlags::format_version;
+      return s.str();
+    }
+
+
+    /**
+     * Write a patch to a binary archive. The vertices are written in
+     * the same order as in the text format, and the data table is
+     * written as a single block of bytes.
+     */
+    template <int dim, int spacedim>
+    void
+    save_patch (internal::FlatBinaryOArchive &archive,
+                const Patch<dim,spacedim>    &patch)
+    {
+      for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
+        archive << patch.vertices[GeometryInfo<dim>::ucd_to_deal[i]];
+      archive << patch.neighbors
+              << patch.patch_index
+              << patch.n_subdivisions
+              << patch.points_are_available;
+
+      const unsigned int n_rows = patch.data.n_rows(),
+                         n_cols = patch.data.n_cols();
+      archive << n_rows << n_cols;
+      if (n_rows * n_cols > 0)
+        archive.write_bytes (&patch.data[0][0], n_rows * n_cols * sizeof(float));
+    }
+
+
+    /**
+     * Read a patch written by save_patch().
+     */
+    template <int dim, int spacedim>
+    void
+    load_patch (internal::FlatBinaryIArchive &archive,
+                Patch<dim,spacedim>          &patch)
+    {
+      for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
+        archive >> patch.vertices[GeometryInfo<dim>::ucd_to_deal[i]];
+      archive >> patch.neighbors
+              >> patch.patch_index
+              >> patch.n_subdivisions
+              >> patch.points_are_available;
+
+      unsigned int n_rows, n_cols;
+      archive >> n_rows >> n_cols;
+      patch.data.reinit (n_rows, n_cols);
+      if (n_rows * n_cols > 0)
+        archive.read_bytes (&patch.data[0][0], n_rows * n_cols * sizeof(float));
+    }
+  }
+
+
+
   template <int dim, int spacedim>
   void
   write_deal_II_intermediate (const std::vector<Patch<dim,spacedim> > &patches,
                               const std::vector<std::string>          &data_names,
                               const std::vector<std_cxx1x::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
-                              const Deal_II_IntermediateFlags         &/*flags*/,
+                              const Deal_II_IntermediateFlags         &flags,
                               std::ostream                            &out)
   {
     AssertThrow (out, ExcIO());
@@ -6460,10 +6898,39 @@ namespace DataOutBase
     out << dim << ' ' << spacedim << '\n';
 
     // then write a header
-    out << "[deal.II intermediate format graphics data]" << '\n'
-        << "[written by " << DEAL_II_PACKAGE_NAME << " " << DEAL_II_PACKAGE_VERSION << "]" << '\n'
+    if (flags.binary)
+      out << binary_intermediate_format_header << '\n';
+    else
+      out << "[deal.II intermediate format graphics data]" << '\n';
+    out << "[written by " << DEAL_II_PACKAGE_NAME << " " << DEAL_II_PACKAGE_VERSION << "]" << '\n'
         << "[Version: " << Deal_II_IntermediateFlags::format_version << "]" << '\n';
 
+    // in binary mode, the rest of the file is a flat binary
+    // archive. write the vector data ranges first so that all
+    // information about the data sets precedes the bulk of the data
+    if (flags.binary)
+      {
+        internal::FlatBinaryOArchive
+        archive (out, binary_intermediate_format_tag<dim,spacedim>());
+
+        archive << data_names;
+
+        const unsigned int n_vector_data_ranges = vector_data_ranges.size();
+        archive << n_vector_data_ranges;
+        for (unsigned int i=0; i<n_vector_data_ranges; ++i)
+          archive << std_cxx1x::get<0>(vector_data_ranges[i])
+                  << std_cxx1x::get<1>(vector_data_ranges[i])
+                  << std_cxx1x::get<2>(vector_data_ranges[i]);
+
+        const unsigned int n_patches = patches.size();
+        archive << n_patches;
+        for (unsigned int i=0; i<n_patches; ++i)
+          save_patch (archive, patches[i]);
+
+        out.flush ();
+        return;
+      }
+
     out << data_names.size() << '\n';
     for (unsigned int i=0; i<data_names.size(); ++i)
       out << data_names[i] << '\n';
@@ -6512,7 +6979,9 @@ DataOutInterface<dim,spacedim>::DataOutInterface ()
 
 template <int dim, int spacedim>
 DataOutInterface<dim,spacedim>::~DataOutInterface ()
-{}
+{
+  wait_for_background_output ();
+}
 
 
 
@@ -6613,6 +7082,13 @@ void DataOutInterface<dim,spacedim>::write_vtu (std::ostream &out) const
                           vtk_flags, out);
 }
 
+template <int dim, int spacedim>
+const DataOutBase::VtkFlags &
+DataOutInterface<dim,spacedim>::get_vtk_flags () const
+{
+  return vtk_flags;
+}
+
 template <int dim, int spacedim>
 void DataOutInterface<dim,spacedim>::write_svg (std::ostream &out) const
 {
@@ -6621,12 +7097,59 @@ void DataOutInterface<dim,spacedim>::write_svg (std::ostream &out) const
                           svg_flags, out);
 }
 
+#ifdef DEAL_II_WITH_MPI
+namespace
+{
+  /**
+   * A stream buffer that appends everything written to it to a
+   * std::vector<char>. write_vtu_in_parallel() uses it to collect the
+   * piece of the output of the current processor in memory that can be
+   * handed to MPI directly, without the copy that
+   * std::stringstream::str() would create.
+   */
+  class VectorStreamBuffer : public std::streambuf
+  {
+  public:
+    VectorStreamBuffer (std::vector<char> &buffer)
+      :
+      buffer (buffer)
+    {}
+
+  protected:
+    virtual
+    std::streamsize
+    xsputn (const char *s, std::streamsize n)
+    {
+      buffer.insert (buffer.end(), s, s+n);
+      return n;
+    }
+
+    virtual
+    int_type
+    overflow (int_type c)
+    {
+      if (traits_type::eq_int_type (c, traits_type::eof()) == false)
+        buffer.push_back (traits_type::to_char_type (c));
+      return traits_type::not_eof (c);
+    }
+
+  private:
+    std::vector<char> &buffer;
+  };
+}
+#endif
+
+
+
 template <int dim, int spacedim>
-void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename, MPI_Comm comm) const
+void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename,
+                                                            MPI_Comm comm,
+                                                            const unsigned int n_aggregators) const
 {
 #ifndef DEAL_II_WITH_MPI
   //without MPI fall back to the normal way to write a vtu file:
   (void)comm;
+  (void)n_aggregators;
 
   std::ofstream f(filename);
   write_vtu (f);
@@ -6638,6 +7161,15 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
 
   MPI_Info info;
   MPI_Info_create(&info);
+  if (n_aggregators > 0)
+    {
+      // ask the MPI-IO layer to funnel the collective write through the
+      // given number of processes
+      MPI_Info_set(info, const_cast<char *>("romio_cb_write"),
+                   const_cast<char *>("enable"));
+      MPI_Info_set(info, const_cast<char *>("cb_nodes"),
+                   const_cast<char *>(Utilities::int_to_string(n_aggregators).c_str()));
+    }
   MPI_File fh;
   err = MPI_File_open(comm, const_cast<char *>(filename),
                       MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
@@ -6650,38 +7182,150 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
   MPI_Barrier(comm);
   MPI_Info_free(&info);
 
-  unsigned int header_size;
+  // generate the piece of this processor in memory. the first processor
+  // also writes the header, the last one the footer
+  std::vector<char> piece;
+  {
+    VectorStreamBuffer stream_buffer (piece);
+    std::ostream out (&stream_buffer);
 
-  //write header
+    if (myrank==0)
+      DataOutBase::write_vtu_header(out, vtk_flags);
+    DataOutBase::write_vtu_main (get_patches(), get_dataset_names(),
+                                 get_vector_data_ranges(),
+                                 vtk_flags, out);
+    if (myrank==nproc-1)
+      DataOutBase::write_vtu_footer(out);
+    out.flush();
+  }
+
+  // the offset of each piece in the file is the sum of the sizes of the
+  // pieces of all processors with lower rank. MPI_Exscan leaves the
+  // result on the first processor undefined
+  unsigned long long int piece_size = piece.size(),
+                         piece_offset = 0;
+  MPI_Exscan(&piece_size, &piece_offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
   if (myrank==0)
+    piece_offset = 0;
+
+  // then write all pieces with one collective call. the count argument
+  // of MPI is an int, so very large pieces need to be written in
+  // several steps, and all processors need to take part in all of them
+  const unsigned long long int max_write_size = (1ULL << 30);
+  const unsigned int n_writes
+    = Utilities::MPI::max (static_cast<unsigned int>
+                           ((piece_size + max_write_size - 1) / max_write_size),
+                           comm);
+  for (unsigned int w=0; w<n_writes; ++w)
     {
-      std::stringstream ss;
-      DataOutBase::write_vtu_header(ss, vtk_flags);
-      header_size = ss.str().size();
-      MPI_File_write(fh, const_cast<char *>(ss.str().c_str()), header_size, MPI_CHAR, NULL);
+      const unsigned long long int begin = std::min (w * max_write_size, piece_size),
+                                   end   = std::min ((w+1) * max_write_size, piece_size);
+      MPI_File_write_at_all(fh, piece_offset + begin,
+                            (end > begin ? &piece[begin] : NULL),
+                            static_cast<int>(end - begin), MPI_CHAR,
+                            MPI_STATUS_IGNORE);
     }
 
-  MPI_Bcast(&header_size, 1, MPI_INT, 0, comm);
+  MPI_File_close( &fh );
+#endif
+}
+
+
 
-  MPI_File_seek_shared( fh, header_size, MPI_SEEK_SET );
+namespace
+{
+  /**
+   * Everything write_vtu_in_background() needs to know to write the
+   * output of one DataOutInterface object, copied so that the object
+   * can be changed while the output is being written.
+   */
+  template <int dim, int spacedim>
+  struct VtuOutputBuffer
   {
-    std::stringstream ss;
-    DataOutBase::write_vtu_main (get_patches(), get_dataset_names(),
-                                 get_vector_data_ranges(),
-                                 vtk_flags, ss);
-    MPI_File_write_ordered(fh, const_cast<char *>(ss.str().c_str()), ss.str().size(), MPI_CHAR, NULL);
+    std::vector<DataOutBase::Patch<dim,spacedim> > patches;
+    std::vector<std::string>                       data_names;
+    std::vector<std_cxx1x::tuple<unsigned int, unsigned int, std::string> >
+    vector_data_ranges;
+    DataOutBase::VtkFlags                          flags;
+    std_cxx1x::shared_ptr<std::ofstream>           out;
+  };
+
+
+  /**
+   * Write the contents of the given buffer. This is the function that
+   * write_vtu_in_background() runs on a separate task. The buffer is
+   * passed by value so that it lives as long as the task needs it. The
+   * file has already been opened by the calling thread, and is closed
+   * when the last reference to the buffer goes away.
+   */
+  template <int dim, int spacedim>
+  void
+  write_vtu_buffer (const std_cxx1x::shared_ptr<const VtuOutputBuffer<dim,spacedim> > buffer)
+  {
+    DataOutBase::write_vtu (buffer->patches, buffer->data_names,
+                            buffer->vector_data_ranges,
+                            buffer->flags, *buffer->out);
   }
+}
 
-  //write footer
-  if (myrank==0)
+
+
+template <int dim, int spacedim>
+Threads::Task<void>
+DataOutInterface<dim,spacedim>::
+write_vtu_in_background (const std::string &filename,
+                         const unsigned int max_pending_writes)
+{
+  Assert (max_pending_writes > 0,
+          ExcMessage ("At least one output needs to be allowed to be "
+                      "in progress at any given time."));
+
+  // make room in the queue of pending outputs. outputs finish in about
+  // the order in which they were started, so waiting for the oldest one
+  // is the best we can do
+  while (background_output.size() >= max_pending_writes)
     {
-      std::stringstream ss;
-      DataOutBase::write_vtu_footer(ss);
-      unsigned int footer_size = ss.str().size();
-      MPI_File_write_shared(fh, const_cast<char *>(ss.str().c_str()), footer_size, MPI_CHAR, NULL);
+      background_output.front().join ();
+      background_output.pop_front ();
+    }
+
+  // open the file here rather than on the task, so that the caller
+  // can catch the exception if this fails. exceptions thrown on a task
+  // abort the program
+  std_cxx1x::shared_ptr<std::ofstream>
+  out (new std::ofstream (filename.c_str()));
+  AssertThrow (*out, ExcFileNotOpen (filename.c_str()));
+
+  // take a snapshot of the data and hand it over to a new task
+  std_cxx1x::shared_ptr<VtuOutputBuffer<dim,spacedim> >
+  buffer (new VtuOutputBuffer<dim,spacedim>());
+  buffer->patches            = get_patches();
+  buffer->data_names         = get_dataset_names();
+  buffer->vector_data_ranges = get_vector_data_ranges();
+  buffer->flags              = vtk_flags;
+  buffer->out                = out;
+
+  const std_cxx1x::shared_ptr<const VtuOutputBuffer<dim,spacedim> >
+  const_buffer = buffer;
+  background_output.push_back
+  (Threads::new_task (std_cxx1x::function<void ()>
+                      (std_cxx1x::bind (&write_vtu_buffer<dim,spacedim>,
+                                        const_buffer))));
+
+  return background_output.back();
+}
+
+
+
+template <int dim, int spacedim>
+void
+DataOutInterface<dim,spacedim>::wait_for_background_output ()
+{
+  while (background_output.size() > 0)
+    {
+      background_output.front().join ();
+      background_output.pop_front ();
     }
-  MPI_File_close( &fh );
-#endif
 }
 
 
@@ -6784,18 +7428,11 @@ DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
       // component names with double
       // underscores unless a vector
       // name has been specified
-      out << "    <PDataArray type=\"Float64\" Name=\"";
-
-      if (std_cxx1x::get<2>(vector_data_ranges[n_th_vector]) != "")
-        out << std_cxx1x::get<2>(vector_data_ranges[n_th_vector]);
-      else
-        {
-          for (unsigned int i=std_cxx1x::get<0>(vector_data_ranges[n_th_vector]);
-               i<std_cxx1x::get<1>(vector_data_ranges[n_th_vector]);
-               ++i)
-            out << data_names[i] << "__";
-          out << data_names[std_cxx1x::get<1>(vector_data_ranges[n_th_vector])];
-        }
+      const std::string vector_name
+        = get_vtk_vector_name (data_names, vector_data_ranges[n_th_vector]);
+      out << "    <PDataArray type=\""
+          << get_vtk_data_type (vtk_flags.get_precision (vector_name))
+          << "\" Name=\"" << vector_name;
 
       out << "\" NumberOfComponents=\"3\" format=\"ascii\"/>\n";
     }
@@ -6803,7 +7440,9 @@ DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
   for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
     if (data_set_written[data_set] == false)
       {
-        out << "    <PDataArray type=\"Float64\" Name=\""
+        out << "    <PDataArray type=\""
+            << get_vtk_data_type (vtk_flags.get_precision (data_names[data_set]))
+            << "\" Name=\""
             << data_names[data_set]
             << "\" format=\"ascii\"/>\n";
       }
@@ -6811,7 +7450,9 @@ DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
   out << "    </PPointData>\n";
 
   out << "    <PPoints>\n";
-  out << "      <PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n";
+  out << "      <PDataArray type=\""
+      << get_vtk_data_type (vtk_flags.coordinate_precision)
+      << "\" NumberOfComponents=\"3\"/>\n";
   out << "    </PPoints>\n";
 
   for (unsigned int i=0; i<piece_names.size(); ++i)
@@ -7012,7 +7653,7 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
   ss << indent(indent_level+1) << "<Time Value=\"" << entry_time << "\"/>\n";
   ss << indent(indent_level+1) << "<Geometry GeometryType=\"" << (dimension == 2 ? "XY" : "XYZ" ) << "\">\n";
   ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << dimension << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
-  ss << indent(indent_level+3) << h5_mesh_filename << ":/nodes\n";
+  ss << indent(indent_level+3) << h5_mesh_filename << ":" << h5_mesh_group << "/nodes\n";
   ss << indent(indent_level+2) << "</DataItem>\n";
   ss << indent(indent_level+1) << "</Geometry>\n";
   // If we have cells defined, use a quadrilateral (2D) or hexahedron (3D) topology
@@ -7020,7 +7661,7 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
     {
       ss << indent(indent_level+1) << "<Topology TopologyType=\"" << (dimension == 2 ? "Quadrilateral" : "Hexahedron") << "\" NumberOfElements=\"" << num_cells << "\">\n";
       ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_cells << " " << (2 << (dimension-1)) << "\" NumberType=\"UInt\" Format=\"HDF\">\n";
-      ss << indent(indent_level+3) << h5_mesh_filename << ":/cells\n";
+      ss << indent(indent_level+3) << h5_mesh_filename << ":" << h5_mesh_group << "/cells\n";
       ss << indent(indent_level+2) << "</DataItem>\n";
       ss << indent(indent_level+1) << "</Topology>\n";
     }
@@ -7036,7 +7677,7 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
       ss << indent(indent_level+1) << "<Attribute Name=\"" << it->first << "\" AttributeType=\"" << (it->second > 1 ? "Vector" : "Scalar") << "\" Center=\"Node\">\n";
       // Vectors must have 3 elements even for 2D models
       ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << (it->second > 1 ? 3 : 1) << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
-      ss << indent(indent_level+3) << h5_sol_filename << ":/" << it->first << "\n";
+      ss << indent(indent_level+3) << h5_sol_filename << ":" << h5_sol_group << "/" << it->first << "\n";
       ss << indent(indent_level+2) << "</DataItem>\n";
       ss << indent(indent_level+1) << "</Attribute>\n";
     }
@@ -7468,6 +8109,352 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
 
 
 
+namespace
+{
+#ifdef DEAL_II_WITH_HDF5
+  /**
+   * Compute a checksum of the node locations and the connectivity of a
+   * mesh, used to find out whether the mesh has changed between two time
+   * steps. This is the FNV-1a hash of the binary representation of the
+   * data.
+   */
+  std::size_t
+  compute_mesh_checksum (const std::vector<double>       &node_data,
+                         const std::vector<unsigned int> &cell_data)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+
+    const std::pair<const char *, std::size_t> blocks[2]
+      = { std::make_pair (node_data.size() > 0
+                          ? reinterpret_cast<const char *>(&node_data[0]) : 0,
+                          node_data.size() * sizeof(double)),
+          std::make_pair (cell_data.size() > 0
+                          ? reinterpret_cast<const char *>(&cell_data[0]) : 0,
+                          cell_data.size() * sizeof(unsigned int))
+        };
+    for (unsigned int b=0; b<2; ++b)
+      {
+        // also hash the size so that moving data from nodes to cells
+        // does not go unnoticed
+        const uint64_t size = blocks[b].second;
+        for (unsigned int i=0; i<sizeof(size); ++i)
+          {
+            hash ^= static_cast<unsigned char>(size >> (8*i));
+            hash *= 1099511628211ULL;
+          }
+        for (std::size_t i=0; i<blocks[b].second; ++i)
+          {
+            hash ^= static_cast<unsigned char>(blocks[b].first[i]);
+            hash *= 1099511628211ULL;
+          }
+      }
+
+    return static_cast<std::size_t>(hash);
+  }
+
+
+
+  /**
+   * Create a chunked, two-dimensional dataset @p name of size
+   * @p n_global_rows times @p n_columns at the given location of an HDF5
+   * file, and write the @p n_local_rows rows of this process starting at
+   * row @p row_offset into it. If @p compression_level is positive, the
+   * chunks are compressed with zlib.
+   */
+  void
+  write_chunked_hdf5_dataset (const hid_t         location,
+                              const std::string  &name,
+                              const hid_t         type,
+                              const void         *data,
+                              const hsize_t       n_local_rows,
+                              const hsize_t       n_global_rows,
+                              const hsize_t       row_offset,
+                              const hsize_t       n_columns,
+                              const hsize_t       chunk_rows,
+                              const unsigned int  compression_level,
+                              const hid_t         xfer_plist)
+  {
+    herr_t status;
+
+    hsize_t dims[2] = { n_global_rows, n_columns };
+    const hid_t file_dataspace = H5Screate_simple(2, dims, NULL);
+    AssertThrow(file_dataspace >= 0, ExcIO());
+
+    // chunks must not be empty, so store empty datasets contiguously
+    const hid_t create_plist = H5Pcreate(H5P_DATASET_CREATE);
+    AssertThrow(create_plist >= 0, ExcIO());
+    if (n_global_rows > 0)
+      {
+        hsize_t chunk_dims[2] = { std::min(chunk_rows, n_global_rows), n_columns };
+        status = H5Pset_chunk(create_plist, 2, chunk_dims);
+        AssertThrow(status >= 0, ExcIO());
+        if (compression_level > 0)
+          {
+            status = H5Pset_deflate(create_plist, compression_level);
+            AssertThrow(status >= 0, ExcIO());
+          }
+      }
+
+#if H5Gcreate_vers == 1
+    const hid_t dataset = H5Dcreate(location, name.c_str(), type, file_dataspace, create_plist);
+#else
+    const hid_t dataset = H5Dcreate(location, name.c_str(), type, file_dataspace, H5P_DEFAULT, create_plist, H5P_DEFAULT);
+#endif
+    AssertThrow(dataset >= 0, ExcIO());
+
+    // select the rows of this process in the file, and all of the data
+    // in memory. processes without data still have to take part in the
+    // (possibly collective) write
+    hsize_t count[2] = { n_local_rows, n_columns };
+    hsize_t offset[2] = { row_offset, 0 };
+    const hid_t memory_dataspace = H5Screate_simple(2, count, NULL);
+    AssertThrow(memory_dataspace >= 0, ExcIO());
+    if (n_local_rows > 0)
+      status = H5Sselect_hyperslab(file_dataspace, H5S_SELECT_SET, offset, NULL, count, NULL);
+    else
+      {
+        status = H5Sselect_none(file_dataspace);
+        AssertThrow(status >= 0, ExcIO());
+        status = H5Sselect_none(memory_dataspace);
+      }
+    AssertThrow(status >= 0, ExcIO());
+
+    status = H5Dwrite(dataset, type, memory_dataspace, file_dataspace, xfer_plist, data);
+    AssertThrow(status >= 0, ExcIO());
+
+    status = H5Sclose(memory_dataspace);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Sclose(file_dataspace);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Pclose(create_plist);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Dclose(dataset);
+    AssertThrow(status >= 0, ExcIO());
+  }
+
+
+
+  /**
+   * Create the group @p name in the given HDF5 file.
+   */
+  hid_t
+  create_hdf5_group (const hid_t file, const std::string &name)
+  {
+#if H5Gcreate_vers == 1
+    const hid_t group = H5Gcreate(file, name.c_str(), 0);
+#else
+    const hid_t group = H5Gcreate(file, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+#endif
+    AssertThrow(group >= 0, ExcIO());
+    return group;
+  }
+#endif
+}
+
+
+
+template <int dim, int spacedim>
+XDMFTimeSeries<dim,spacedim>::
+XDMFTimeSeries (const std::string  &h5_filename,
+                const std::string  &xdmf_filename,
+                MPI_Comm            comm,
+                const unsigned int  compression_level,
+                const unsigned int  chunk_size)
+  :
+  h5_filename (h5_filename),
+  xdmf_filename (xdmf_filename),
+  comm (comm),
+  compression_level (compression_level),
+  chunk_size (chunk_size),
+  n_written_steps (0),
+  n_written_meshes (0),
+  mesh_checksum (0)
+{
+  Assert (compression_level <= 9,
+          ExcIndexRange (compression_level, 0, 10));
+  Assert (chunk_size > 0, ExcMessage ("The chunk size must be positive."));
+}
+
+
+
+template <int dim, int spacedim>
+void
+XDMFTimeSeries<dim,spacedim>::
+write_time_step (const DataOutInterface<dim,spacedim> &data_out,
+                 const double                          time)
+{
+#ifndef DEAL_II_WITH_HDF5
+  // throw an exception, but first make
+  // sure the compiler does not warn about
+  // the now unused function arguments
+  (void)data_out;
+  (void)time;
+  AssertThrow(false, ExcMessage ("HDF5 support is disabled."));
+#else
+  herr_t          status;
+  unsigned int    local_node_cell_count[2], global_node_cell_count[2], global_node_cell_offsets[2];
+
+  // If HDF5 is not parallel and we're using multiple processes, abort
+  const unsigned int n_processes = Utilities::MPI::n_mpi_processes(comm);
+#ifndef H5_HAVE_PARALLEL
+  AssertThrow (n_processes <= 1,
+               ExcMessage ("Serial HDF5 output on multiple processes is not yet supported."));
+#endif
+
+  DataOutBase::DataOutFilter  data_filter(DataOutBase::DataOutFilterFlags(false, true));
+  data_out.write_filtered_data(data_filter);
+
+  local_node_cell_count[0] = data_filter.n_nodes();
+  local_node_cell_count[1] = data_filter.n_cells();
+#ifdef DEAL_II_WITH_MPI
+  MPI_Allreduce(local_node_cell_count, global_node_cell_count, 2, MPI_UNSIGNED, MPI_SUM, comm);
+  MPI_Scan(local_node_cell_count, global_node_cell_offsets, 2, MPI_UNSIGNED, MPI_SUM, comm);
+  global_node_cell_offsets[0] -= local_node_cell_count[0];
+  global_node_cell_offsets[1] -= local_node_cell_count[1];
+#else
+  global_node_cell_count[0] = local_node_cell_count[0];
+  global_node_cell_count[1] = local_node_cell_count[1];
+  global_node_cell_offsets[0] = global_node_cell_offsets[1] = 0;
+#endif
+
+  // Find out whether the mesh has changed on any of the processes. The
+  // checksum is computed from the connectivity in local numbering since
+  // the offsets change whenever the mesh changes on another process
+  std::vector<double>          node_data_vec;
+  std::vector<unsigned int>    cell_data_vec;
+  data_filter.fill_node_data(node_data_vec);
+  data_filter.fill_cell_data(0, cell_data_vec);
+  const std::size_t local_checksum = compute_mesh_checksum(node_data_vec, cell_data_vec);
+  const bool write_mesh
+    = ((n_written_meshes == 0)
+       ||
+       (Utilities::MPI::max((local_checksum != mesh_checksum ? 1U : 0U), comm) != 0));
+
+  // Only use the MPI-IO driver if more than one process writes to the
+  // file. Datasets written through it can not be compressed, so only
+  // compress the datasets if the file is written with the default driver
+#if defined(DEAL_II_WITH_MPI) && defined(H5_HAVE_PARALLEL)
+  const bool use_mpio = (n_processes > 1);
+#else
+  const bool use_mpio = false;
+#endif
+  const unsigned int level
+    = ((use_mpio == false) && (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+       ?
+       compression_level
+       :
+       0);
+
+  // Create the file upon the first time step, and reopen it afterwards
+  const hid_t file_plist_id = H5Pcreate(H5P_FILE_ACCESS);
+  AssertThrow(file_plist_id >= 0, ExcIO());
+  const hid_t xfer_plist_id = H5Pcreate(H5P_DATASET_XFER);
+  AssertThrow(xfer_plist_id >= 0, ExcIO());
+#if defined(DEAL_II_WITH_MPI) && defined(H5_HAVE_PARALLEL)
+  if (use_mpio)
+    {
+      status = H5Pset_fapl_mpio(file_plist_id, comm, MPI_INFO_NULL);
+      AssertThrow(status >= 0, ExcIO());
+      status = H5Pset_dxpl_mpio(xfer_plist_id, H5FD_MPIO_COLLECTIVE);
+      AssertThrow(status >= 0, ExcIO());
+    }
+#endif
+
+  const hid_t file_id
+    = (n_written_steps == 0
+       ?
+       H5Fcreate(h5_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, file_plist_id)
+       :
+       H5Fopen(h5_filename.c_str(), H5F_ACC_RDWR, file_plist_id));
+  AssertThrow(file_id >= 0, ExcIO());
+
+  if (write_mesh)
+    {
+      const hid_t mesh_group
+        = create_hdf5_group(file_id,
+                            "/mesh_" + Utilities::int_to_string(n_written_meshes));
+
+      write_chunked_hdf5_dataset(mesh_group, "nodes", H5T_NATIVE_DOUBLE,
+                                 node_data_vec.size() > 0 ? &node_data_vec[0] : 0,
+                                 local_node_cell_count[0],
+                                 global_node_cell_count[0],
+                                 global_node_cell_offsets[0],
+                                 spacedim, chunk_size, level, xfer_plist_id);
+
+      // now shift the connectivity to the global numbering of nodes
+      for (unsigned int i=0; i<cell_data_vec.size(); ++i)
+        cell_data_vec[i] += global_node_cell_offsets[0];
+      write_chunked_hdf5_dataset(mesh_group, "cells", H5T_NATIVE_UINT,
+                                 cell_data_vec.size() > 0 ? &cell_data_vec[0] : 0,
+                                 local_node_cell_count[1],
+                                 global_node_cell_count[1],
+                                 global_node_cell_offsets[1],
+                                 GeometryInfo<dim>::vertices_per_cell,
+                                 chunk_size, level, xfer_plist_id);
+
+      status = H5Gclose(mesh_group);
+      AssertThrow(status >= 0, ExcIO());
+
+      mesh_checksum = local_checksum;
+      ++n_written_meshes;
+    }
+  node_data_vec.clear();
+  cell_data_vec.clear();
+
+  // Then write the data of this time step into a group of its own
+  const std::string step_group_name = "/step_" + Utilities::int_to_string(n_written_steps);
+  const hid_t step_group = create_hdf5_group(file_id, step_group_name);
+  for (unsigned int i=0; i<data_filter.n_data_sets(); ++i)
+    write_chunked_hdf5_dataset(step_group, data_filter.get_data_set_name(i),
+                               H5T_NATIVE_DOUBLE,
+                               local_node_cell_count[0] > 0 ? data_filter.get_data_set(i) : 0,
+                               local_node_cell_count[0],
+                               global_node_cell_count[0],
+                               global_node_cell_offsets[0],
+                               data_filter.get_data_set_dim(i),
+                               chunk_size, level, xfer_plist_id);
+
+  status = H5Gclose(step_group);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pclose(xfer_plist_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pclose(file_plist_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Fclose(file_id);
+  AssertThrow(status >= 0, ExcIO());
+
+  // Finally add an entry that references the current mesh and the data
+  // just written, and rewrite the XDMF file
+  XDMFEntry entry = data_out.create_xdmf_entry(data_filter, h5_filename, time, comm);
+  entry.set_hdf5_groups("/mesh_" + Utilities::int_to_string(n_written_meshes-1),
+                        step_group_name);
+  entries.push_back(entry);
+  ++n_written_steps;
+
+  data_out.write_xdmf_file(entries, xdmf_filename, comm);
+#endif
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+XDMFTimeSeries<dim,spacedim>::n_time_steps () const
+{
+  return n_written_steps;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+XDMFTimeSeries<dim,spacedim>::n_meshes () const
+{
+  return n_written_meshes;
+}
+
+
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim,spacedim>::write (std::ostream &out,
@@ -7821,6 +8808,7 @@ DataOutReader<dim,spacedim>::read (std::istream &in)
     getline (in, tmp);
   }
 
+  bool binary = false;
   {
     std::string header;
     getline (in, header);
@@ -7828,7 +8816,10 @@ DataOutReader<dim,spacedim>::read (std::istream &in)
     std::ostringstream s;
     s << "[deal.II intermediate format graphics data]";
 
-    Assert (header == s.str(), ExcUnexpectedInput(s.str(),header));
+    if (header == DataOutBase::binary_intermediate_format_header)
+      binary = true;
+    else
+      Assert (header == s.str(), ExcUnexpectedInput(s.str(),header));
   }
   {
     std::string header;
@@ -7852,6 +8843,32 @@ DataOutReader<dim,spacedim>::read (std::istream &in)
                        "are written by."));
   }
 
+  // the binary format stores the same data as the text format, but
+  // in the order in which write_deal_II_intermediate() puts it
+  if (binary)
+    {
+      internal::FlatBinaryIArchive
+      archive (in, DataOutBase::binary_intermediate_format_tag<dim,spacedim>());
+
+      archive >> dataset_names;
+
+      unsigned int n_vector_data_ranges;
+      archive >> n_vector_data_ranges;
+      vector_data_ranges.resize (n_vector_data_ranges);
+      for (unsigned int i=0; i<n_vector_data_ranges; ++i)
+        archive >> std_cxx1x::get<0>(vector_data_ranges[i])
+                >> std_cxx1x::get<1>(vector_data_ranges[i])
+                >> std_cxx1x::get<2>(vector_data_ranges[i]);
+
+      unsigned int n_patches;
+      archive >> n_patches;
+      patches.resize (n_patches);
+      for (unsigned int i=0; i<n_patches; ++i)
+        DataOutBase::load_patch (archive, patches[i]);
+
+      return;
+    }
+
   // then read the rest of the data
   unsigned int n_datasets;
   in >> n_datasets;
@@ -7892,6 +8909,55 @@ DataOutReader<dim,spacedim>::read (std::istream &in)
 
 
 
+template <int dim, int spacedim>
+void
+DataOutReader<dim,spacedim>::
+write_merged_vtu (const std::vector<std::string> &filenames,
+                  std::ostream                   &out,
+                  const DataOutBase::VtkFlags    &flags)
+{
+  AssertThrow (out, ExcIO());
+  Assert (filenames.size() > 0, ExcNoPatches());
+
+  DataOutBase::write_vtu_header (out, flags);
+
+  // read one file at a time and write its patches as a piece of their
+  // own. the reader object is reused so that the memory allocated for
+  // the patches of one file can be recycled for the next one
+  DataOutReader<dim,spacedim> reader;
+  std::vector<std::string> first_dataset_names;
+  std::vector<std_cxx1x::tuple<unsigned int, unsigned int, std::string> >
+  first_vector_data_ranges;
+  for (unsigned int i=0; i<filenames.size(); ++i)
+    {
+      std::ifstream in (filenames[i].c_str(), std::ios::in | std::ios::binary);
+      AssertThrow (in, ExcFileNotOpen (filenames[i].c_str()));
+      reader.read (in);
+
+      if (i == 0)
+        {
+          first_dataset_names = reader.dataset_names;
+          first_vector_data_ranges = reader.vector_data_ranges;
+        }
+      else
+        {
+          AssertThrow (reader.dataset_names == first_dataset_names,
+                       ExcIncompatibleDatasetNames());
+          AssertThrow (reader.vector_data_ranges == first_vector_data_ranges,
+                       ExcMessage ("All files need to declare the same "
+                                   "components as vectors."));
+        }
+
+      DataOutBase::write_vtu_main (reader.patches, reader.dataset_names,
+                                   reader.vector_data_ranges, flags, out);
+    }
+
+  DataOutBase::write_vtu_footer (out);
+  out.flush ();
+}
+
+
+
 template <int dim, int spacedim>
 void
 DataOutReader<dim,spacedim>::
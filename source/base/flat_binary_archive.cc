@@ -0,0 +1,173 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/flat_binary_archive.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace
+  {
+    /**
+     * The string every archive starts with, and the version of the
+     * format. The version needs to be incremented whenever the layout
+     * of any of the objects written to these archives changes.
+     */
+    const char            magic[]        = "deal.II flat binary archive";
+    const boost::uint32_t format_version = 1;
+
+    /**
+     * A number whose binary representation identifies the byte order
+     * of the machine that wrote an archive.
+     */
+    const boost::uint32_t byte_order_mark = 0x01020304;
+
+    /**
+     * Fill @p sizes with the sizes of the fundamental types whose
+     * binary representation ends up in the archive.
+     */
+    void get_type_sizes (unsigned char (&sizes)[6])
+    {
+      sizes[0] = sizeof(int);
+      sizes[1] = sizeof(long int);
+      sizes[2] = sizeof(float);
+      sizes[3] = sizeof(double);
+      sizes[4] = sizeof(types::global_dof_index);
+      sizes[5] = sizeof(bool);
+    }
+  }
+
+
+
+  FlatBinaryOArchive::FlatBinaryOArchive (std::ostream      &out,
+                                          const std::string &tag)
+    :
+    out (out)
+  {
+    write_bytes (magic, sizeof(magic));
+    write_bytes (&format_version, sizeof(format_version));
+    write_bytes (&byte_order_mark, sizeof(byte_order_mark));
+
+    unsigned char sizes[6];
+    get_type_sizes (sizes);
+    write_bytes (sizes, sizeof(sizes));
+
+    save_object (tag);
+  }
+
+
+
+  void
+  FlatBinaryOArchive::save_object (const std::vector<bool> &t)
+  {
+    // pack eight flags into every byte
+    const boost::uint64_t size = t.size();
+    write_bytes (&size, sizeof(size));
+
+    std::vector<unsigned char> packed ((size+7)/8, 0);
+    for (std::size_t i=0; i<t.size(); ++i)
+      if (t[i])
+        packed[i/8] |= (1 << (i%8));
+    if (packed.size() > 0)
+      write_bytes (&packed[0], packed.size());
+  }
+
+
+
+  void
+  FlatBinaryOArchive::save_object (const std::string &t)
+  {
+    const boost::uint64_t size = t.size();
+    write_bytes (&size, sizeof(size));
+    write_bytes (t.data(), t.size());
+  }
+
+
+
+  FlatBinaryIArchive::FlatBinaryIArchive (std::istream      &in,
+                                          const std::string &tag)
+    :
+    in (in)
+  {
+    char file_magic[sizeof(magic)];
+    in.read (file_magic, sizeof(magic));
+    AssertThrow (in && (std::memcmp (file_magic, magic, sizeof(magic)) == 0),
+                 ExcInvalidHeader ("the stream does not start with the "
+                                   "identifier of a flat binary archive."));
+
+    boost::uint32_t file_version;
+    read_bytes (&file_version, sizeof(file_version));
+    AssertThrow (file_version == format_version,
+                 ExcInvalidHeader ("the archive was written in a format "
+                                   "version that is not supported."));
+
+    boost::uint32_t file_byte_order;
+    read_bytes (&file_byte_order, sizeof(file_byte_order));
+    AssertThrow (file_byte_order == byte_order_mark,
+                 ExcInvalidHeader ("the archive was written on a machine "
+                                   "with a different byte order."));
+
+    unsigned char sizes[6], file_sizes[6];
+    get_type_sizes (sizes);
+    read_bytes (file_sizes, sizeof(file_sizes));
+    AssertThrow (std::memcmp (sizes, file_sizes, sizeof(sizes)) == 0,
+                 ExcInvalidHeader ("the archive was written on a machine "
+                                   "with different sizes of fundamental "
+                                   "data types, or with a different "
+                                   "setting of DEAL_II_WITH_64BIT_INDICES."));
+
+    std::string file_tag;
+    load_object (file_tag);
+    AssertThrow (file_tag == tag,
+                 ExcInvalidHeader ("the archive contains an object of type <"
+                                   + file_tag + ">, but an object of type <"
+                                   + tag + "> was expected."));
+  }
+
+
+
+  void
+  FlatBinaryIArchive::load_object (std::vector<bool> &t)
+  {
+    boost::uint64_t size;
+    read_bytes (&size, sizeof(size));
+
+    std::vector<unsigned char> packed ((size+7)/8);
+    if (packed.size() > 0)
+      read_bytes (&packed[0], packed.size());
+
+    t.resize (size);
+    for (std::size_t i=0; i<t.size(); ++i)
+      t[i] = ((packed[i/8] & (1 << (i%8))) != 0);
+  }
+
+
+
+  void
+  FlatBinaryIArchive::load_object (std::string &t)
+  {
+    boost::uint64_t size;
+    read_bytes (&size, sizeof(size));
+    t.resize (size);
+    if (size > 0)
+      read_bytes (&t[0], size);
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
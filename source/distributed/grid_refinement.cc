@@ -16,6 +16,9 @@
 
 
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx1x/bind.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/block_vector.h>
 #include <deal.II/lac/petsc_vector.h>
@@ -32,8 +35,11 @@
 
 #include <deal.II/distributed/grid_refinement.h>
 
+#include <boost/cstdint.hpp>
+
 #include <numeric>
 #include <algorithm>
+#include <cstring>
 #include <limits>
 
 
@@ -256,133 +262,191 @@ namespace
   namespace RefineAndCoarsenFixedNumber
   {
     /**
-     * Compute a threshold value so
-     * that exactly n_target_cells have
-     * a value that is larger.
+     * The number of bits of the keys below that are determined in each
+     * round of the selection algorithm, and the corresponding number of
+     * bins of the histograms. Keys have 32 bits, so every selection takes
+     * exactly four rounds.
      */
-    template <typename number>
-    number
-    master_compute_threshold (const Vector<number> &criteria,
-                              const std::pair<double,double> global_min_and_max,
-                              const unsigned int    n_target_cells,
-                              MPI_Comm              mpi_communicator)
-    {
-      double interesting_range[2] = { global_min_and_max.first,
-                                      global_min_and_max.second
-                                    };
-      adjust_interesting_range (interesting_range);
+    const unsigned int bits_per_round = 8;
+    const unsigned int n_bins         = (1U << bits_per_round);
 
-      unsigned int iteration = 0;
+    /**
+     * The number of indicators each task counts when building the local
+     * histograms.
+     */
+    const unsigned int chunk_size = 4096;
 
-      do
-        {
-          MPI_Bcast (&interesting_range[0], 2, MPI_DOUBLE,
-                     0, mpi_communicator);
 
-          if (interesting_range[0] == interesting_range[1])
-            return interesting_range[0];
+    /**
+     * Map a float onto an unsigned integer so that the integers are
+     * ordered in the same way as the floats they represent. For
+     * non-negative numbers this amounts to setting the sign bit; negative
+     * numbers (of which only -0. can appear here) have all their bits
+     * flipped.
+     */
+    inline
+    boost::uint32_t
+    float_to_key (const float value)
+    {
+      boost::uint32_t bits;
+      std::memcpy (&bits, &value, sizeof(bits));
+      return ((bits & 0x80000000U) != 0 ? ~bits : (bits | 0x80000000U));
+    }
 
-          const double test_threshold
-            = (interesting_range[0] > 0
-               ?
-               std::sqrt(interesting_range[0] *
-                         interesting_range[1])
-               :
-               (interesting_range[0] + interesting_range[1]) / 2);
 
-          // count how many of our own
-          // elements would be above
-          // this threshold and then
-          // add to it the number for
-          // all the others
-          unsigned int
-          my_count = std::count_if (criteria.begin(),
-                                    criteria.end(),
-                                    std::bind2nd (std::greater<double>(),
-                                                  test_threshold));
-
-          unsigned int total_count;
-          MPI_Reduce (&my_count, &total_count, 1, MPI_UNSIGNED,
-                      MPI_SUM, 0, mpi_communicator);
+    /**
+     * The inverse of the function above.
+     */
+    inline
+    float
+    key_to_float (const boost::uint32_t key)
+    {
+      const boost::uint32_t bits = ((key & 0x80000000U) != 0
+                                    ?
+                                    (key & 0x7fffffffU)
+                                    :
+                                    ~key);
+      float value;
+      std::memcpy (&value, &bits, sizeof(value));
+      return value;
+    }
 
-          // now adjust the range. if
-          // we have to many cells, we
-          // take the upper half of the
-          // previous range, otherwise
-          // the lower half. if we have
-          // hit the right number, then
-          // set the range to the exact
-          // value
-          if (total_count > n_target_cells)
-            interesting_range[0] = test_threshold;
-          else if (total_count < n_target_cells)
-            interesting_range[1] = test_threshold;
-          else
-            interesting_range[0] = interesting_range[1] = test_threshold;
 
-          // terminate the iteration after 25 go-arounds. this is necessary
-          // because oftentimes error indicators on cells have exactly the
-          // same value, and so there may not be a particular value that cuts
-          // the indicators in such a way that we can achieve the desired
-          // number of cells. using a maximal number of iterations means that
-          // we terminate the iteration after a fixed number N of steps if the
-          // indicators were perfectly badly distributed, and we make at most
-          // a mistake of 1/2^N in the number of cells flagged if indicators
-          // are perfectly equidistributed
-          ++iteration;
-          if (iteration == 25)
-            interesting_range[0] = interesting_range[1] = test_threshold;
-        }
-      while (true);
+    /**
+     * For the chunks of indicators in the range [chunk_begin,chunk_end)
+     * and for each of the selections whose keys so far have been
+     * determined to start with @p prefixes, count how many indicators
+     * share this prefix and have each of the possible values of the next
+     * @p bits_per_round bits below bit @p shift. The result for chunk @p
+     * c and selection @p s goes into the @p n_bins elements of @p
+     * histograms starting at <tt>(c*prefixes.size()+s)*n_bins</tt>, so
+     * that chunks can be counted concurrently without synchronization.
+     */
+    void
+    count_digits_on_chunks (const unsigned int                    chunk_begin,
+                            const unsigned int                    chunk_end,
+                            const Vector<float>                  &criteria,
+                            const std::vector<boost::uint32_t>   &prefixes,
+                            const unsigned int                    shift,
+                            std::vector<types::global_dof_index> &histograms)
+    {
+      const boost::uint32_t prefix_mask
+        = (shift + bits_per_round < 32
+           ?
+           ~((static_cast<boost::uint32_t>(1) << (shift + bits_per_round)) - 1)
+           :
+           0);
+      const unsigned int n_selections = prefixes.size();
 
-      Assert (false, ExcInternalError());
-      return -1;
+      for (unsigned int chunk=chunk_begin; chunk<chunk_end; ++chunk)
+        {
+          types::global_dof_index *histogram
+            = &histograms[chunk * n_selections * n_bins];
+          const unsigned int end = std::min (static_cast<unsigned int>(criteria.size()),
+                                             (chunk+1) * chunk_size);
+          for (unsigned int i=chunk*chunk_size; i<end; ++i)
+            {
+              const boost::uint32_t key = float_to_key (criteria(i));
+              for (unsigned int s=0; s<n_selections; ++s)
+                if ((key & prefix_mask) == prefixes[s])
+                  ++histogram[s*n_bins + ((key >> shift) & (n_bins-1))];
+            }
+        }
     }
 
 
     /**
-     * The corresponding function to
-     * the one above, to be run on the
-     * slaves.
+     * Compute the values that, among the indicators of all processors
+     * sorted in ascending order, have the positions given in @p
+     * ranks. This is a most-significant-digit radix selection on the
+     * binary representation of the indicators: every round determines
+     * the next @p bits_per_round bits of all selected values at once,
+     * using a local histogram that is computed in parallel on the
+     * present machine and a single global reduction. The result is
+     * exact, is the same on all processors, and is obtained after a
+     * fixed number of four reductions independent of the distribution
+     * of the indicators.
      */
-    template <typename number>
-    number
-    slave_compute_threshold (const Vector<number> &criteria,
-                             MPI_Comm              mpi_communicator)
+    std::vector<float>
+    compute_global_order_statistics (const Vector<float>                        &criteria,
+                                     const std::vector<types::global_dof_index> &ranks,
+                                     MPI_Comm                                    mpi_communicator)
     {
-      do
-        {
-          double interesting_range[2] = { -1, -1 };
-          MPI_Bcast (&interesting_range[0], 2, MPI_DOUBLE,
-                     0, mpi_communicator);
+      const unsigned int n_selections = ranks.size();
+      const unsigned int n_chunks = (criteria.size() + chunk_size - 1) / chunk_size;
 
-          if (interesting_range[0] == interesting_range[1])
-            return interesting_range[0];
+      std::vector<types::global_dof_index> remaining_ranks (ranks);
+      std::vector<boost::uint32_t>         prefixes (n_selections, 0);
 
-          // count how many elements
-          // there are that are bigger
-          // than the following trial
-          // threshold
-          const double test_threshold
-            = (interesting_range[0] > 0
-               ?
-               std::exp((std::log(interesting_range[0]) +
-                         std::log(interesting_range[1])) / 2)
-               :
-               (interesting_range[0] + interesting_range[1]) / 2);
-          unsigned int
-          my_count = std::count_if (criteria.begin(),
-                                    criteria.end(),
-                                    std::bind2nd (std::greater<double>(),
-                                                  test_threshold));
+      std::vector<types::global_dof_index> chunk_histograms;
+      std::vector<types::global_dof_index> local_histograms (n_selections * n_bins);
+      std::vector<types::global_dof_index> global_histograms (n_selections * n_bins);
 
-          MPI_Reduce (&my_count, 0, 1, MPI_UNSIGNED,
-                      MPI_SUM, 0, mpi_communicator);
+      for (unsigned int round=0; round<32/bits_per_round; ++round)
+        {
+          const unsigned int shift = 32 - (round+1)*bits_per_round;
+
+          chunk_histograms.assign (n_chunks * n_selections * n_bins, 0);
+          parallel::apply_to_subranges (0U, n_chunks,
+                                        std_cxx1x::bind (&count_digits_on_chunks,
+                                                         std_cxx1x::_1,
+                                                         std_cxx1x::_2,
+                                                         std_cxx1x::cref(criteria),
+                                                         std_cxx1x::cref(prefixes),
+                                                         shift,
+                                                         std_cxx1x::ref(chunk_histograms)),
+                                        1);
+
+          std::fill (local_histograms.begin(), local_histograms.end(), 0);
+          for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+            for (unsigned int i=0; i<n_selections*n_bins; ++i)
+              local_histograms[i] += chunk_histograms[chunk*n_selections*n_bins + i];
+
+          Utilities::MPI::sum (local_histograms, mpi_communicator,
+                               global_histograms);
+
+          // for each selection, find the bin that contains the element
+          // with the requested rank and continue the search within it
+          for (unsigned int s=0; s<n_selections; ++s)
+            {
+              unsigned int digit = 0;
+              while (remaining_ranks[s] >= global_histograms[s*n_bins + digit])
+                {
+                  remaining_ranks[s] -= global_histograms[s*n_bins + digit];
+                  ++digit;
+                  Assert (digit < n_bins, ExcInternalError());
+                }
+              prefixes[s] |= (static_cast<boost::uint32_t>(digit) << shift);
+            }
         }
-      while (true);
 
-      Assert (false, ExcInternalError());
-      return -1;
+      std::vector<float> values (n_selections);
+      for (unsigned int s=0; s<n_selections; ++s)
+        values[s] = key_to_float (prefixes[s]);
+      return values;
+    }
+
+
+    /**
+     * Given the value @p lower of the largest indicator that is not
+     * among the @p n_target_cells largest ones, and the value @p upper
+     * of the smallest indicator that is, return a threshold so that
+     * exactly the @p n_target_cells largest indicators are larger than
+     * it. If the two values are equal, i.e. if there is no threshold
+     * that separates exactly @p n_target_cells cells from the rest, the
+     * common value is returned.
+     */
+    inline
+    double
+    threshold_between (const float lower,
+                       const float upper)
+    {
+      Assert (lower <= upper, ExcInternalError());
+      return (lower < upper
+              ?
+              (static_cast<double>(lower) + static_cast<double>(upper)) / 2
+              :
+              upper);
     }
   }
 
@@ -569,82 +633,69 @@ namespace parallel
                                       criteria,
                                       locally_owned_indicators);
 
-        MPI_Comm mpi_communicator = tria.get_communicator ();
-
-        // figure out the global
-        // max and min of the
-        // indicators. we don't
-        // need it here, but it's a
-        // collective communication
-        // call
-        const std::pair<double,double> global_min_and_max
-          = compute_global_min_and_max_at_root (locally_owned_indicators,
-                                                mpi_communicator);
-
-        // from here on designate a
-        // master and slaves
-        double top_threshold, bottom_threshold;
-        if (Utilities::MPI::this_mpi_process (mpi_communicator) == 0)
+        // the thresholds are determined by the indicators that, in the
+        // list of the indicators of all processors sorted in ascending
+        // order, bracket the n_refine_cells largest ones and the
+        // n_keep_cells largest ones, respectively. compute all four of
+        // them at once
+        const types::global_dof_index
+        n_global_cells = tria.n_global_active_cells(),
+        n_refine_cells = static_cast<types::global_dof_index>
+                         (top_fraction_of_cells * n_global_cells),
+        n_keep_cells   = static_cast<types::global_dof_index>
+                         ((1-bottom_fraction_of_cells) * n_global_cells);
+
+        std::vector<types::global_dof_index> ranks (4);
+        ranks[0] = (n_refine_cells < n_global_cells ?
+                    n_global_cells - n_refine_cells - 1 : 0);
+        ranks[1] = (n_refine_cells > 0 ?
+                    n_global_cells - n_refine_cells : n_global_cells - 1);
+        ranks[2] = (n_keep_cells < n_global_cells ?
+                    n_global_cells - n_keep_cells - 1 : 0);
+        ranks[3] = (n_keep_cells > 0 ?
+                    n_global_cells - n_keep_cells : n_global_cells - 1);
+
+        const std::vector<float> values
+          = RefineAndCoarsenFixedNumber::
+            compute_global_order_statistics (locally_owned_indicators,
+                                             ranks,
+                                             tria.get_communicator ());
+
+        // if no cell is to be refined, use a threshold above all
+        // indicators, if all of them are, use the smallest indicator
+        double top_threshold;
+        if (n_refine_cells == 0)
+          top_threshold = std::numeric_limits<double>::max();
+        else if (n_refine_cells == n_global_cells)
+          top_threshold = values[1];
+        else
+          top_threshold
+            = RefineAndCoarsenFixedNumber::threshold_between (values[0],
+                                                              values[1]);
+
+        // compute bottom
+        // threshold only if
+        // necessary. otherwise
+        // use a threshold lower
+        // than the smallest
+        // value we have locally
+        double bottom_threshold;
+        if (bottom_fraction_of_cells > 0)
           {
-            // this is the master
-            // processor
-            top_threshold
-              =
-                RefineAndCoarsenFixedNumber::
-                master_compute_threshold (locally_owned_indicators,
-                                          global_min_and_max,
-                                          static_cast<unsigned int>
-                                          (top_fraction_of_cells *
-                                           tria.n_global_active_cells()),
-                                          mpi_communicator);
-
-            // compute bottom
-            // threshold only if
-            // necessary. otherwise
-            // use a threshold lower
-            // than the smallest
-            // value we have locally
-            if (bottom_fraction_of_cells > 0)
-              bottom_threshold
-                =
-                  RefineAndCoarsenFixedNumber::
-                  master_compute_threshold (locally_owned_indicators,
-                                            global_min_and_max,
-                                            static_cast<unsigned int>
-                                            ((1-bottom_fraction_of_cells) *
-                                             tria.n_global_active_cells()),
-                                            mpi_communicator);
+            if (n_keep_cells == n_global_cells)
+              bottom_threshold = -std::numeric_limits<double>::max();
+            else if (n_keep_cells == 0)
+              bottom_threshold = values[2];
             else
-              {
-                bottom_threshold = *std::min_element (criteria.begin(),
-                                                      criteria.end());
-                bottom_threshold -= std::fabs(bottom_threshold);
-              }
+              bottom_threshold
+                = RefineAndCoarsenFixedNumber::threshold_between (values[2],
+                                                                  values[3]);
           }
         else
           {
-            // this is a slave
-            // processor
-            top_threshold
-              =
-                RefineAndCoarsenFixedNumber::
-                slave_compute_threshold (locally_owned_indicators,
-                                         mpi_communicator);
-            // compute bottom
-            // threshold only if
-            // necessary
-            if (bottom_fraction_of_cells > 0)
-              bottom_threshold
-                =
-                  RefineAndCoarsenFixedNumber::
-                  slave_compute_threshold (locally_owned_indicators,
-                                           mpi_communicator);
-            else
-              {
-                bottom_threshold = *std::min_element (criteria.begin(),
-                                                      criteria.end());
-                bottom_threshold -= std::fabs(bottom_threshold);
-              }
+            bottom_threshold = *std::min_element (criteria.begin(),
+                                                  criteria.end());
+            bottom_threshold -= std::fabs(bottom_threshold);
           }
 
         // now refine the mesh
@@ -44,6 +44,8 @@
 
 #include <algorithm>
 #include <numeric>
+#include <limits>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 
@@ -1138,6 +1140,124 @@ namespace
 
 
 
+  /**
+   * Add the array @p array with @p n_elements elements to the list of
+   * arrays of a p4est connectivity. If the array has not been allocated
+   * by p4est, it is recorded with size zero.
+   */
+  template <typename T>
+  void
+  add_connectivity_array (T                        *&array,
+                          const std::size_t          n_elements,
+                          std::vector<void **>      &arrays,
+                          std::vector<std::size_t>  &array_sizes)
+  {
+    arrays.push_back (reinterpret_cast<void **>(&array));
+    array_sizes.push_back (array != 0 ? n_elements * sizeof(T) : 0);
+  }
+
+
+
+  /**
+   * A class that knows about the layout of the p4est connectivity
+   * structures: which of their members are counts, and which of them
+   * are arrays that are allocated by p4est.
+   */
+  template <int dim> struct ConnectivityLayout;
+
+  template <>
+  struct ConnectivityLayout<2>
+  {
+    /**
+     * Create a connectivity object with empty arrays.
+     */
+    static
+    internal::p4est::types<2>::connectivity *
+    new_empty ()
+    {
+      return internal::p4est::functions<2>::connectivity_new (0, 0, 0, 0);
+    }
+
+    /**
+     * Collect pointers to the counts and the arrays of @p c, along
+     * with the sizes of the arrays in bytes. The sizes are only
+     * meaningful if @p c has been filled with data.
+     */
+    static
+    void
+    get (internal::p4est::types<2>::connectivity  &c,
+         std::vector<internal::p4est::types<2>::topidx *> &counts,
+         std::vector<void **>                     &arrays,
+         std::vector<std::size_t>                 &array_sizes)
+    {
+      counts.clear ();
+      arrays.clear ();
+      array_sizes.clear ();
+
+      counts.push_back (&c.num_vertices);
+      counts.push_back (&c.num_trees);
+      counts.push_back (&c.num_corners);
+
+      const std::size_t num_ctt = (c.ctt_offset != 0 ?
+                                   c.ctt_offset[c.num_corners] : 0);
+      add_connectivity_array (c.vertices,         3*c.num_vertices, arrays, array_sizes);
+      add_connectivity_array (c.tree_to_vertex,   4*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.tree_to_tree,     4*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.tree_to_face,     4*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.tree_to_corner,   4*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.ctt_offset,       c.num_corners+1,  arrays, array_sizes);
+      add_connectivity_array (c.corner_to_tree,   num_ctt,          arrays, array_sizes);
+      add_connectivity_array (c.corner_to_corner, num_ctt,          arrays, array_sizes);
+    }
+  };
+
+  template <>
+  struct ConnectivityLayout<3>
+  {
+    static
+    internal::p4est::types<3>::connectivity *
+    new_empty ()
+    {
+      return internal::p4est::functions<3>::connectivity_new (0, 0, 0, 0, 0, 0);
+    }
+
+    static
+    void
+    get (internal::p4est::types<3>::connectivity  &c,
+         std::vector<internal::p4est::types<3>::topidx *> &counts,
+         std::vector<void **>                     &arrays,
+         std::vector<std::size_t>                 &array_sizes)
+    {
+      counts.clear ();
+      arrays.clear ();
+      array_sizes.clear ();
+
+      counts.push_back (&c.num_vertices);
+      counts.push_back (&c.num_trees);
+      counts.push_back (&c.num_edges);
+      counts.push_back (&c.num_corners);
+
+      const std::size_t num_ett = (c.ett_offset != 0 ?
+                                   c.ett_offset[c.num_edges] : 0);
+      const std::size_t num_ctt = (c.ctt_offset != 0 ?
+                                   c.ctt_offset[c.num_corners] : 0);
+      add_connectivity_array (c.vertices,         3*c.num_vertices, arrays, array_sizes);
+      add_connectivity_array (c.tree_to_vertex,   8*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.tree_to_tree,     6*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.tree_to_face,     6*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.tree_to_edge,     12*c.num_trees,   arrays, array_sizes);
+      add_connectivity_array (c.ett_offset,       c.num_edges+1,    arrays, array_sizes);
+      add_connectivity_array (c.edge_to_tree,     num_ett,          arrays, array_sizes);
+      add_connectivity_array (c.edge_to_edge,     num_ett,          arrays, array_sizes);
+      add_connectivity_array (c.tree_to_corner,   8*c.num_trees,    arrays, array_sizes);
+      add_connectivity_array (c.ctt_offset,       c.num_corners+1,  arrays, array_sizes);
+      add_connectivity_array (c.corner_to_tree,   num_ctt,          arrays, array_sizes);
+      add_connectivity_array (c.corner_to_corner, num_ctt,          arrays, array_sizes);
+    }
+  };
+
+
+
   template <int dim, int spacedim>
   bool
   tree_exists_locally (const typename internal::p4est::types<dim>::forest *parallel_forest,
@@ -1523,6 +1643,160 @@ namespace
   }
 
 
+  /**
+   * Go through the p4est quadrants and the deal.II cells rooted in the same
+   * coarse cell in the same way as attach_mesh_data_recursively() does, and
+   * store the weight of every locally owned quadrant of the new mesh at its
+   * position in the list of local quadrants of the forest.
+   */
+  template <int dim, int spacedim>
+  void
+  get_cell_weights_recursively (const typename internal::p4est::types<dim>::tree &tree,
+                                const typename Triangulation<dim,spacedim>::cell_iterator &dealii_cell,
+                                const typename internal::p4est::types<dim>::quadrant &p4est_cell,
+                                parallel::distributed::Triangulation<dim,spacedim> &triangulation,
+                                std::vector<unsigned int> &weights)
+  {
+    const int idx = sc_array_bsearch(const_cast<sc_array_t *>(&tree.quadrants),
+                                     &p4est_cell,
+                                     internal::p4est::functions<dim>::quadrant_compare);
+
+    if (idx == -1 && (internal::p4est::functions<dim>::
+                      quadrant_overlaps_tree (const_cast<typename internal::p4est::types<dim>::tree *>(&tree),
+                                              &p4est_cell)
+                      == false))
+      return; //this quadrant and none of its children belongs to us.
+
+    const bool p4est_has_children = (idx == -1);
+
+    if (!p4est_has_children)
+      {
+        // the cell is active in the new mesh. it either is active now as
+        // well, or its children are going to be coarsened into it
+        weights[tree.quadrants_offset + idx]
+          = triangulation.cell_weight (dealii_cell,
+                                       dealii_cell->has_children()
+                                       ?
+                                       parallel::distributed::Triangulation<dim,spacedim>::CELL_COARSEN
+                                       :
+                                       parallel::distributed::Triangulation<dim,spacedim>::CELL_PERSIST);
+        return;
+      }
+
+    typename internal::p4est::types<dim>::quadrant
+    p4est_child[GeometryInfo<dim>::max_children_per_cell];
+    for (unsigned int c=0; c<GeometryInfo<dim>::max_children_per_cell; ++c)
+      switch (dim)
+        {
+        case 2:
+          P4EST_QUADRANT_INIT(&p4est_child[c]);
+          break;
+        case 3:
+          P8EST_QUADRANT_INIT(&p4est_child[c]);
+          break;
+        default:
+          Assert (false, ExcNotImplemented());
+        }
+    internal::p4est::functions<dim>::
+    quadrant_childrenv (&p4est_cell, p4est_child);
+
+    if (dealii_cell->has_children())
+      {
+        for (unsigned int c=0;
+             c<GeometryInfo<dim>::max_children_per_cell; ++c)
+          get_cell_weights_recursively<dim,spacedim> (tree,
+                                                      dealii_cell->child(c),
+                                                      p4est_child[c],
+                                                      triangulation,
+                                                      weights);
+      }
+    else
+      {
+        // the cell is going to be refined. all of its children get the
+        // weight that is returned for the parent
+        const unsigned int weight
+          = triangulation.cell_weight (dealii_cell,
+                                       parallel::distributed::Triangulation<dim,spacedim>::CELL_REFINE);
+        for (unsigned int c=0;
+             c<GeometryInfo<dim>::max_children_per_cell; ++c)
+          {
+            const int child_idx = sc_array_bsearch(const_cast<sc_array_t *>(&tree.quadrants),
+                                                   &p4est_child[c],
+                                                   internal::p4est::functions<dim>::quadrant_compare);
+            Assert (child_idx != -1,
+                    ExcMessage ("The children of a refined cell should exist as active quadrants!"));
+            weights[tree.quadrants_offset + child_idx] = weight;
+          }
+      }
+  }
+
+
+
+  /**
+   * A class that hands the weights computed by
+   * get_cell_weights_recursively() to p4est. p4est calls the callback
+   * function once for every local quadrant, in the order in which they
+   * are stored, and passes the forest whose user pointer points to an
+   * object of this class.
+   */
+  template <int dim, int spacedim>
+  class PartitionWeights
+  {
+  public:
+    PartitionWeights (const std::vector<unsigned int> &cell_weights);
+
+    /**
+     * The callback function for p4est's partition function: return the
+     * weight of the next quadrant.
+     */
+    static
+    int
+    cell_weight (typename internal::p4est::types<dim>::forest *forest,
+                 typename internal::p4est::types<dim>::topidx tree,
+                 typename internal::p4est::types<dim>::quadrant *quadrant);
+
+  private:
+    const std::vector<unsigned int> &cell_weights;
+    unsigned int                     current_index;
+  };
+
+
+
+  template <int dim, int spacedim>
+  PartitionWeights<dim,spacedim>::
+  PartitionWeights (const std::vector<unsigned int> &cell_weights)
+    :
+    cell_weights (cell_weights),
+    current_index (0)
+  {}
+
+
+
+  template <int dim, int spacedim>
+  int
+  PartitionWeights<dim,spacedim>::
+  cell_weight (typename internal::p4est::types<dim>::forest *forest,
+               typename internal::p4est::types<dim>::topidx,
+               typename internal::p4est::types<dim>::quadrant *)
+  {
+    PartitionWeights<dim,spacedim> *this_object
+      = reinterpret_cast<PartitionWeights<dim,spacedim>*>(forest->user_pointer);
+
+    Assert (this_object->current_index < this_object->cell_weights.size(),
+            ExcInternalError());
+    // p4est takes the weights as int. do not let larger weights wrap
+    // around to negative values
+    const unsigned int weight
+      = this_object->cell_weights[this_object->current_index++];
+    Assert (weight <= static_cast<unsigned int>(std::numeric_limits<int>::max()),
+            ExcMessage ("The weight of a cell exceeds the largest weight "
+                        "p4est can represent."));
+    return static_cast<int>(std::min (weight,
+                                      static_cast<unsigned int>(std::numeric_limits<int>::max())));
+  }
+
+
+
   template <int dim, int spacedim>
   void
   post_mesh_data_recursively (const typename internal::p4est::types<dim>::tree &tree,
@@ -2020,6 +2294,8 @@ namespace parallel
       my_subdomain (Utilities::MPI::this_mpi_process (this->mpi_communicator)),
       triangulation_has_content (false),
       connectivity (0),
+      node_communicator (MPI_COMM_NULL),
+      connectivity_window (MPI_WIN_NULL),
       parallel_forest (0),
       refinement_in_progress (false),
       attached_data_size(0),
@@ -2057,6 +2333,152 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    bool
+    Triangulation<dim,spacedim>::setup_node_communicator ()
+    {
+      Assert (node_communicator == MPI_COMM_NULL, ExcInternalError());
+
+#if MPI_VERSION >= 3
+      if (settings & share_coarse_connectivity_within_node)
+        {
+          MPI_Comm_split_type (mpi_communicator, MPI_COMM_TYPE_SHARED,
+                               Utilities::MPI::this_mpi_process (mpi_communicator),
+                               MPI_INFO_NULL, &node_communicator);
+
+          // there is nothing to share if we are alone on this node
+          if (Utilities::MPI::n_mpi_processes (node_communicator) == 1)
+            {
+              MPI_Comm_free (&node_communicator);
+              node_communicator = MPI_COMM_NULL;
+              return true;
+            }
+
+          return (Utilities::MPI::this_mpi_process (node_communicator) == 0);
+        }
+#endif
+
+      return true;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::share_connectivity_within_node ()
+    {
+#if MPI_VERSION >= 3
+      if (node_communicator == MPI_COMM_NULL)
+        return;
+
+      typedef typename dealii::internal::p4est::types<dim>::topidx topidx;
+      const bool is_first = (Utilities::MPI::this_mpi_process (node_communicator) == 0);
+      Assert ((connectivity != 0) == is_first, ExcInternalError());
+
+      // every process, including the first one, ends up with a connectivity
+      // object of its own whose arrays point into the shared window. create
+      // it with empty arrays and keep a copy of it so that we can give it
+      // back to p4est in its original state later on
+      typename dealii::internal::p4est::types<dim>::connectivity *
+      shared_connectivity = ConnectivityLayout<dim>::new_empty ();
+      connectivity_shell = *shared_connectivity;
+
+      // the first process tells everyone else the sizes of all counts and
+      // arrays
+      std::vector<topidx *>    counts;
+      std::vector<void **>     arrays;
+      std::vector<std::size_t> array_sizes;
+      ConnectivityLayout<dim>::get (is_first ? *connectivity : *shared_connectivity,
+                                    counts, arrays, array_sizes);
+
+      std::vector<unsigned long long int> sizes (counts.size() + arrays.size(), 0);
+      if (is_first)
+        {
+          for (unsigned int i=0; i<counts.size(); ++i)
+            sizes[i] = *counts[i];
+          for (unsigned int i=0; i<arrays.size(); ++i)
+            sizes[counts.size()+i] = array_sizes[i];
+        }
+      MPI_Bcast (&sizes[0], sizes.size(), MPI_UNSIGNED_LONG_LONG, 0,
+                 node_communicator);
+
+      // place the arrays one after the other into the window, each aligned
+      // to a multiple of eight bytes
+      std::vector<std::size_t> offsets (arrays.size()+1, 0);
+      for (unsigned int i=0; i<arrays.size(); ++i)
+        offsets[i+1] = offsets[i] + (sizes[counts.size()+i] + 7) / 8 * 8;
+
+      char *window_data = 0;
+      MPI_Win_allocate_shared ((is_first ? offsets.back() : 0), 1,
+                               MPI_INFO_NULL, node_communicator,
+                               &window_data, &connectivity_window);
+      if (!is_first)
+        {
+          MPI_Aint size;
+          int      displacement_unit;
+          MPI_Win_shared_query (connectivity_window, 0,
+                                &size, &displacement_unit, &window_data);
+        }
+
+      // the first process copies its arrays into the window and then
+      // releases the connectivity it has built
+      MPI_Win_fence (0, connectivity_window);
+      if (is_first)
+        {
+          for (unsigned int i=0; i<arrays.size(); ++i)
+            if (array_sizes[i] > 0)
+              std::memcpy (window_data + offsets[i], *arrays[i], array_sizes[i]);
+          dealii::internal::p4est::functions<dim>::connectivity_destroy (connectivity);
+        }
+      MPI_Win_fence (0, connectivity_window);
+
+      // finally let everyone's connectivity object refer to the shared arrays
+      ConnectivityLayout<dim>::get (*shared_connectivity, counts, arrays, array_sizes);
+      for (unsigned int i=0; i<counts.size(); ++i)
+        *counts[i] = sizes[i];
+      for (unsigned int i=0; i<arrays.size(); ++i)
+        *arrays[i] = (sizes[counts.size()+i] > 0 ?
+                      window_data + offsets[i]
+                      :
+                      0);
+      connectivity = shared_connectivity;
+
+      Assert (dealii::internal::p4est::functions<dim>::connectivity_is_valid (connectivity) == 1,
+              ExcInternalError());
+#endif
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::destroy_connectivity ()
+    {
+      if (connectivity != 0)
+        {
+          // if the arrays live in a shared window, hand the connectivity
+          // object back to p4est with the arrays it was created with
+          if (connectivity_window != MPI_WIN_NULL)
+            {
+              *connectivity = connectivity_shell;
+              MPI_Win_free (&connectivity_window);
+              connectivity_window = MPI_WIN_NULL;
+            }
+
+          dealii::internal::p4est::functions<dim>::connectivity_destroy (connectivity);
+          connectivity = 0;
+        }
+
+      if (node_communicator != MPI_COMM_NULL)
+        {
+          MPI_Comm_free (&node_communicator);
+          node_communicator = MPI_COMM_NULL;
+        }
+    }
+
+
+
+
     template <int dim, int spacedim>
     void
     Triangulation<dim,spacedim>::
@@ -2119,11 +2541,7 @@ namespace parallel
           parallel_forest = 0;
         }
 
-      if (connectivity != 0)
-        {
-          dealii::internal::p4est::functions<dim>::connectivity_destroy (connectivity);
-          connectivity = 0;
-        }
+      destroy_connectivity ();
 
       coarse_cell_to_p4est_tree_permutation.resize (0);
       p4est_tree_to_coarse_cell_permutation.resize (0);
@@ -2254,8 +2672,7 @@ namespace parallel
         }
       dealii::internal::p4est::functions<dim>::destroy (parallel_forest);
       parallel_forest = 0;
-      dealii::internal::p4est::functions<dim>::connectivity_destroy (connectivity);
-      connectivity = 0;
+      destroy_connectivity ();
 
       unsigned int version, numcpus, attached_size, attached_count, n_coarse_cells;
       {
@@ -2294,6 +2711,18 @@ namespace parallel
                           this,
                           &connectivity);
 #endif
+
+      // every process has read the connectivity from the file. if it is
+      // to be shared within the node, only the first process keeps its
+      // copy, and the forest is redirected to the shared one
+      if (setup_node_communicator () == false)
+        {
+          dealii::internal::p4est::functions<dim>::connectivity_destroy (connectivity);
+          connectivity = 0;
+        }
+      share_connectivity_within_node ();
+      parallel_forest->connectivity = connectivity;
+
       if (numcpus != Utilities::MPI::n_mpi_processes (mpi_communicator))
         {
           // We are changing the number of CPUs so we need to repartition.
@@ -2322,6 +2751,24 @@ namespace parallel
           AssertThrow (false, ExcInternalError());
         }
 
+      // the weights of cells can only be computed once the cells exist in
+      // the triangulation. if weights are requested, partition the mesh
+      // once more and rebuild the local part of the triangulation. the data
+      // attached to the cells in the file moves along with them
+      if (cell_weight.empty() == false)
+        {
+          partition_forest ();
+
+          try
+            {
+              copy_local_forest_to_triangulation ();
+            }
+          catch (const typename Triangulation<dim>::DistortedCellList &)
+            {
+              AssertThrow (false, ExcInternalError());
+            }
+        }
+
       update_number_cache ();
     }
 
@@ -2362,51 +2809,57 @@ namespace parallel
       Assert (this->n_cells(0) > 0, ExcInternalError());
       Assert (this->n_levels() == 1, ExcInternalError());
 
-      // data structures that counts how many cells touch each vertex
-      // (vertex_touch_count), and which cells touch a given vertex (together
-      // with the local numbering of that vertex within the cells that touch
-      // it)
-      std::vector<unsigned int> vertex_touch_count;
-      std::vector<
-      std::list<
-      std::pair<Triangulation<dim,spacedim>::active_cell_iterator,
-          unsigned int> > >
-          vertex_to_cell;
-      get_vertex_to_cell_mappings (*this,
-                                   vertex_touch_count,
-                                   vertex_to_cell);
-      const dealii::internal::p4est::types<2>::locidx
-      num_vtt = std::accumulate (vertex_touch_count.begin(),
-                                 vertex_touch_count.end(),
-                                 0);
-
-      // now create a connectivity object with the right sizes for all
-      // arrays. set vertex information only in debug mode (saves a few bytes
-      // in optimized mode)
-      const bool set_vertex_info
+      // build the connectivity, unless another process on this node
+      // builds it and shares it with us
+      if (setup_node_communicator () == true)
+        {
+          // data structures that counts how many cells touch each vertex
+          // (vertex_touch_count), and which cells touch a given vertex (together
+          // with the local numbering of that vertex within the cells that touch
+          // it)
+          std::vector<unsigned int> vertex_touch_count;
+          std::vector<
+          std::list<
+          std::pair<Triangulation<dim,spacedim>::active_cell_iterator,
+              unsigned int> > >
+              vertex_to_cell;
+          get_vertex_to_cell_mappings (*this,
+                                       vertex_touch_count,
+                                       vertex_to_cell);
+          const dealii::internal::p4est::types<2>::locidx
+          num_vtt = std::accumulate (vertex_touch_count.begin(),
+                                     vertex_touch_count.end(),
+                                     0);
+
+          // now create a connectivity object with the right sizes for all
+          // arrays. set vertex information only in debug mode (saves a few bytes
+          // in optimized mode)
+          const bool set_vertex_info
 #ifdef DEBUG
-        = true
+            = true
 #else
-        = false
+            = false
 #endif
-          ;
-
-      connectivity
-        = dealii::internal::p4est::functions<2>::
-          connectivity_new ((set_vertex_info == true ? this->n_vertices() : 0),
-                            this->n_cells(0),
-                            this->n_vertices(),
-                            num_vtt);
-
-      set_vertex_and_cell_info (*this,
-                                vertex_touch_count,
-                                vertex_to_cell,
-                                coarse_cell_to_p4est_tree_permutation,
-                                set_vertex_info,
-                                connectivity);
-
-      Assert (p4est_connectivity_is_valid (connectivity) == 1,
-              ExcInternalError());
+              ;
+
+          connectivity
+            = dealii::internal::p4est::functions<2>::
+              connectivity_new ((set_vertex_info == true ? this->n_vertices() : 0),
+                                this->n_cells(0),
+                                this->n_vertices(),
+                                num_vtt);
+
+          set_vertex_and_cell_info (*this,
+                                    vertex_touch_count,
+                                    vertex_to_cell,
+                                    coarse_cell_to_p4est_tree_permutation,
+                                    set_vertex_info,
+                                    connectivity);
+
+          Assert (p4est_connectivity_is_valid (connectivity) == 1,
+                  ExcInternalError());
+        }
+      share_connectivity_within_node ();
 
       // now create a forest out of the connectivity data structure
       parallel_forest
@@ -2433,51 +2886,57 @@ namespace parallel
       Assert (this->n_cells(0) > 0, ExcInternalError());
       Assert (this->n_levels() == 1, ExcInternalError());
 
-      // data structures that counts how many cells touch each vertex
-      // (vertex_touch_count), and which cells touch a given vertex (together
-      // with the local numbering of that vertex within the cells that touch
-      // it)
-      std::vector<unsigned int> vertex_touch_count;
-      std::vector<
-      std::list<
-      std::pair<Triangulation<dim,spacedim>::active_cell_iterator,
-          unsigned int> > >
-          vertex_to_cell;
-      get_vertex_to_cell_mappings (*this,
-                                   vertex_touch_count,
-                                   vertex_to_cell);
-      const dealii::internal::p4est::types<2>::locidx
-      num_vtt = std::accumulate (vertex_touch_count.begin(),
-                                 vertex_touch_count.end(),
-                                 0);
-
-      // now create a connectivity object with the right sizes for all
-      // arrays. set vertex information only in debug mode (saves a few bytes
-      // in optimized mode)
-      const bool set_vertex_info
+      // build the connectivity, unless another process on this node
+      // builds it and shares it with us
+      if (setup_node_communicator () == true)
+        {
+          // data structures that counts how many cells touch each vertex
+          // (vertex_touch_count), and which cells touch a given vertex (together
+          // with the local numbering of that vertex within the cells that touch
+          // it)
+          std::vector<unsigned int> vertex_touch_count;
+          std::vector<
+          std::list<
+          std::pair<Triangulation<dim,spacedim>::active_cell_iterator,
+              unsigned int> > >
+              vertex_to_cell;
+          get_vertex_to_cell_mappings (*this,
+                                       vertex_touch_count,
+                                       vertex_to_cell);
+          const dealii::internal::p4est::types<2>::locidx
+          num_vtt = std::accumulate (vertex_touch_count.begin(),
+                                     vertex_touch_count.end(),
+                                     0);
+
+          // now create a connectivity object with the right sizes for all
+          // arrays. set vertex information only in debug mode (saves a few bytes
+          // in optimized mode)
+          const bool set_vertex_info
 #ifdef DEBUG
-        = true
+            = true
 #else
-        = false
+            = false
 #endif
-          ;
-
-      connectivity
-        = dealii::internal::p4est::functions<2>::
-          connectivity_new ((set_vertex_info == true ? this->n_vertices() : 0),
-                            this->n_cells(0),
-                            this->n_vertices(),
-                            num_vtt);
-
-      set_vertex_and_cell_info (*this,
-                                vertex_touch_count,
-                                vertex_to_cell,
-                                coarse_cell_to_p4est_tree_permutation,
-                                set_vertex_info,
-                                connectivity);
-
-      Assert (p4est_connectivity_is_valid (connectivity) == 1,
-              ExcInternalError());
+              ;
+
+          connectivity
+            = dealii::internal::p4est::functions<2>::
+              connectivity_new ((set_vertex_info == true ? this->n_vertices() : 0),
+                                this->n_cells(0),
+                                this->n_vertices(),
+                                num_vtt);
+
+          set_vertex_and_cell_info (*this,
+                                    vertex_touch_count,
+                                    vertex_to_cell,
+                                    coarse_cell_to_p4est_tree_permutation,
+                                    set_vertex_info,
+                                    connectivity);
+
+          Assert (p4est_connectivity_is_valid (connectivity) == 1,
+                  ExcInternalError());
+        }
+      share_connectivity_within_node ();
 
       // now create a forest out of the connectivity data structure
       parallel_forest
@@ -2502,134 +2961,140 @@ namespace parallel
       Assert (this->n_cells(0) > 0, ExcInternalError());
       Assert (this->n_levels() == 1, ExcInternalError());
 
-      // data structures that counts how many cells touch each vertex
-      // (vertex_touch_count), and which cells touch a given vertex (together
-      // with the local numbering of that vertex within the cells that touch
-      // it)
-      std::vector<unsigned int> vertex_touch_count;
-      std::vector<
-      std::list<
-      std::pair<Triangulation<3>::active_cell_iterator,
-          unsigned int> > >
-          vertex_to_cell;
-      get_vertex_to_cell_mappings (*this,
-                                   vertex_touch_count,
-                                   vertex_to_cell);
-      const dealii::internal::p4est::types<2>::locidx
-      num_vtt = std::accumulate (vertex_touch_count.begin(),
-                                 vertex_touch_count.end(),
-                                 0);
-
-      std::vector<unsigned int> edge_touch_count;
-      std::vector<
-      std::list<
-      std::pair<Triangulation<3>::active_cell_iterator,
-          unsigned int> > >
-          edge_to_cell;
-      get_edge_to_cell_mappings (*this,
-                                 edge_touch_count,
-                                 edge_to_cell);
-      const dealii::internal::p4est::types<2>::locidx
-      num_ett = std::accumulate (edge_touch_count.begin(),
-                                 edge_touch_count.end(),
-                                 0);
-
-      // now create a connectivity object with the right sizes for all arrays
-      const bool set_vertex_info
+      // build the connectivity, unless another process on this node
+      // builds it and shares it with us
+      if (setup_node_communicator () == true)
+        {
+          // data structures that counts how many cells touch each vertex
+          // (vertex_touch_count), and which cells touch a given vertex (together
+          // with the local numbering of that vertex within the cells that touch
+          // it)
+          std::vector<unsigned int> vertex_touch_count;
+          std::vector<
+          std::list<
+          std::pair<Triangulation<3>::active_cell_iterator,
+              unsigned int> > >
+              vertex_to_cell;
+          get_vertex_to_cell_mappings (*this,
+                                       vertex_touch_count,
+                                       vertex_to_cell);
+          const dealii::internal::p4est::types<2>::locidx
+          num_vtt = std::accumulate (vertex_touch_count.begin(),
+                                     vertex_touch_count.end(),
+                                     0);
+
+          std::vector<unsigned int> edge_touch_count;
+          std::vector<
+          std::list<
+          std::pair<Triangulation<3>::active_cell_iterator,
+              unsigned int> > >
+              edge_to_cell;
+          get_edge_to_cell_mappings (*this,
+                                     edge_touch_count,
+                                     edge_to_cell);
+          const dealii::internal::p4est::types<2>::locidx
+          num_ett = std::accumulate (edge_touch_count.begin(),
+                                     edge_touch_count.end(),
+                                     0);
+
+          // now create a connectivity object with the right sizes for all arrays
+          const bool set_vertex_info
 #ifdef DEBUG
-        = true
+            = true
 #else
-        = false
+            = false
 #endif
-          ;
-
-      connectivity
-        = dealii::internal::p4est::functions<3>::
-          connectivity_new ((set_vertex_info == true ? this->n_vertices() : 0),
-                            this->n_cells(0),
-                            this->n_active_lines(),
-                            num_ett,
-                            this->n_vertices(),
-                            num_vtt);
-
-      set_vertex_and_cell_info (*this,
-                                vertex_touch_count,
-                                vertex_to_cell,
-                                coarse_cell_to_p4est_tree_permutation,
-                                set_vertex_info,
-                                connectivity);
-
-      // next to tree-to-edge
-      // data. note that in p4est lines
-      // are ordered as follows
-      //      *---3---*        *---3---*
-      //     /|       |       /       /|
-      //    6 |       11     6       7 11
-      //   /  10      |     /       /  |
-      //  *   |       |    *---2---*   |
-      //  |   *---1---*    |       |   *
-      //  |  /       /     |       9  /
-      //  8 4       5      8       | 5
-      //  |/       /       |       |/
-      //  *---0---*        *---0---*
-      // whereas in deal.II they are like this:
-      //      *---7---*        *---7---*
-      //     /|       |       /       /|
-      //    4 |       11     4       5 11
-      //   /  10      |     /       /  |
-      //  *   |       |    *---6---*   |
-      //  |   *---3---*    |       |   *
-      //  |  /       /     |       9  /
-      //  8 0       1      8       | 1
-      //  |/       /       |       |/
-      //  *---2---*        *---2---*
-
-      const unsigned int deal_to_p4est_line_index[12]
-        = { 4, 5, 0, 1,  6, 7, 2, 3, 8, 9, 10, 11 } ;
-
-      for (Triangulation<dim,spacedim>::active_cell_iterator
-           cell = this->begin_active();
-           cell != this->end(); ++cell)
-        {
-          const unsigned int
-          index = coarse_cell_to_p4est_tree_permutation[cell->index()];
-          for (unsigned int e=0; e<GeometryInfo<3>::lines_per_cell; ++e)
-            connectivity->tree_to_edge[index*GeometryInfo<3>::lines_per_cell+
-                                       deal_to_p4est_line_index[e]]
-              = cell->line(e)->index();
-        }
-
-      // now also set edge-to-tree
-      // information
-      connectivity->ett_offset[0] = 0;
-      std::partial_sum (edge_touch_count.begin(),
-                        edge_touch_count.end(),
-                        &connectivity->ett_offset[1]);
+              ;
+
+          connectivity
+            = dealii::internal::p4est::functions<3>::
+              connectivity_new ((set_vertex_info == true ? this->n_vertices() : 0),
+                                this->n_cells(0),
+                                this->n_active_lines(),
+                                num_ett,
+                                this->n_vertices(),
+                                num_vtt);
+
+          set_vertex_and_cell_info (*this,
+                                    vertex_touch_count,
+                                    vertex_to_cell,
+                                    coarse_cell_to_p4est_tree_permutation,
+                                    set_vertex_info,
+                                    connectivity);
+
+          // next to tree-to-edge
+          // data. note that in p4est lines
+          // are ordered as follows
+          //      *---3---*        *---3---*
+          //     /|       |       /       /|
+          //    6 |       11     6       7 11
+          //   /  10      |     /       /  |
+          //  *   |       |    *---2---*   |
+          //  |   *---1---*    |       |   *
+          //  |  /       /     |       9  /
+          //  8 4       5      8       | 5
+          //  |/       /       |       |/
+          //  *---0---*        *---0---*
+          // whereas in deal.II they are like this:
+          //      *---7---*        *---7---*
+          //     /|       |       /       /|
+          //    4 |       11     4       5 11
+          //   /  10      |     /       /  |
+          //  *   |       |    *---6---*   |
+          //  |   *---3---*    |       |   *
+          //  |  /       /     |       9  /
+          //  8 0       1      8       | 1
+          //  |/       /       |       |/
+          //  *---2---*        *---2---*
+
+          const unsigned int deal_to_p4est_line_index[12]
+            = { 4, 5, 0, 1,  6, 7, 2, 3, 8, 9, 10, 11 } ;
+
+          for (Triangulation<dim,spacedim>::active_cell_iterator
+               cell = this->begin_active();
+               cell != this->end(); ++cell)
+            {
+              const unsigned int
+              index = coarse_cell_to_p4est_tree_permutation[cell->index()];
+              for (unsigned int e=0; e<GeometryInfo<3>::lines_per_cell; ++e)
+                connectivity->tree_to_edge[index*GeometryInfo<3>::lines_per_cell+
+                                           deal_to_p4est_line_index[e]]
+                  = cell->line(e)->index();
+            }
 
-      Assert (connectivity->ett_offset[this->n_active_lines()] ==
-              num_ett,
-              ExcInternalError());
+          // now also set edge-to-tree
+          // information
+          connectivity->ett_offset[0] = 0;
+          std::partial_sum (edge_touch_count.begin(),
+                            edge_touch_count.end(),
+                            &connectivity->ett_offset[1]);
 
-      for (unsigned int v=0; v<this->n_active_lines(); ++v)
-        {
-          Assert (edge_to_cell[v].size() == edge_touch_count[v],
+          Assert (connectivity->ett_offset[this->n_active_lines()] ==
+                  num_ett,
                   ExcInternalError());
 
-          std::list<std::pair
-          <Triangulation<dim,spacedim>::active_cell_iterator,
-          unsigned int> >::const_iterator
-          p = edge_to_cell[v].begin();
-          for (unsigned int c=0; c<edge_touch_count[v]; ++c, ++p)
+          for (unsigned int v=0; v<this->n_active_lines(); ++v)
             {
-              connectivity->edge_to_tree[connectivity->ett_offset[v]+c]
-                = coarse_cell_to_p4est_tree_permutation[p->first->index()];
-              connectivity->edge_to_edge[connectivity->ett_offset[v]+c]
-                = deal_to_p4est_line_index[p->second];
+              Assert (edge_to_cell[v].size() == edge_touch_count[v],
+                      ExcInternalError());
+
+              std::list<std::pair
+              <Triangulation<dim,spacedim>::active_cell_iterator,
+              unsigned int> >::const_iterator
+              p = edge_to_cell[v].begin();
+              for (unsigned int c=0; c<edge_touch_count[v]; ++c, ++p)
+                {
+                  connectivity->edge_to_tree[connectivity->ett_offset[v]+c]
+                    = coarse_cell_to_p4est_tree_permutation[p->first->index()];
+                  connectivity->edge_to_edge[connectivity->ett_offset[v]+c]
+                    = deal_to_p4est_line_index[p->second];
+                }
             }
-        }
 
-      Assert (p8est_connectivity_is_valid (connectivity) == 1,
-              ExcInternalError());
+          Assert (p8est_connectivity_is_valid (connectivity) == 1,
+                  ExcInternalError());
+        }
+      share_connectivity_within_node ();
 
       // now create a forest out of the connectivity data structure
       parallel_forest
@@ -3108,10 +3573,7 @@ namespace parallel
       attach_mesh_data();
 
       // partition the new mesh between all processors
-      dealii::internal::p4est::functions<dim>::
-      partition (parallel_forest,
-                 /* prepare coarsening */ 1,
-                 /* weight_callback */ NULL);
+      partition_forest ();
 
       // finally copy back from local part of tree to deal.II
       // triangulation. before doing so, make sure there are no refine or
@@ -3143,6 +3605,115 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::repartition ()
+    {
+      Assert (refinement_in_progress == false,
+              ExcMessage ("repartition() can not be called while the "
+                          "triangulation is being refined."));
+
+      refinement_in_progress = true;
+
+      if (parallel_ghost != 0)
+        {
+          dealii::internal::p4est::functions<dim>::ghost_destroy (parallel_ghost);
+          parallel_ghost = 0;
+        }
+
+      // before repartitioning the mesh let others attach mesh related info
+      // (such as SolutionTransfer data) to the p4est
+      attach_mesh_data();
+
+      partition_forest ();
+
+      // copy back from the local part of the forest to the deal.II
+      // triangulation. this only changes which cells are locally owned.
+      // before doing so, make sure there are no refine or coarsen flags
+      // pending, since copy_local_forest_to_triangulation() would
+      // otherwise act on them
+      for (typename Triangulation<dim,spacedim>::active_cell_iterator
+           cell = this->begin_active();
+           cell != this->end(); ++cell)
+        {
+          cell->clear_refine_flag();
+          cell->clear_coarsen_flag();
+        }
+
+      try
+        {
+          copy_local_forest_to_triangulation ();
+        }
+      catch (const typename Triangulation<dim>::DistortedCellList &)
+        {
+          // the underlying triangulation should not be checking for distorted
+          // cells
+          AssertThrow (false, ExcInternalError());
+        }
+
+      refinement_in_progress = false;
+
+      update_number_cache ();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::partition_forest ()
+    {
+      if (cell_weight.empty())
+        {
+          dealii::internal::p4est::functions<dim>::
+          partition (parallel_forest,
+                     /* prepare coarsening */ 1,
+                     /* weight_callback */ NULL);
+          return;
+        }
+
+      // compute the weights of all locally owned quadrants of the forest
+      std::vector<unsigned int> weights (parallel_forest->local_num_quadrants, 0);
+      for (typename Triangulation<dim,spacedim>::cell_iterator
+           cell = this->begin(0);
+           cell != this->end(0);
+           ++cell)
+        {
+          //skip coarse cells, that are not ours
+          if (tree_exists_locally<dim,spacedim>(parallel_forest,
+                                                coarse_cell_to_p4est_tree_permutation[cell->index()])
+              == false)
+            continue;
+
+          typename dealii::internal::p4est::types<dim>::quadrant p4est_coarse_cell;
+          typename dealii::internal::p4est::types<dim>::tree *tree =
+            init_tree(cell->index());
+
+          dealii::internal::p4est::init_coarse_quadrant<dim>(p4est_coarse_cell);
+
+          get_cell_weights_recursively<dim,spacedim>(*tree,
+                                                     cell,
+                                                     p4est_coarse_cell,
+                                                     *this,
+                                                     weights);
+        }
+
+      // hand them to p4est through the user pointer of the forest, in the
+      // same way as the refinement and coarsening flags
+      PartitionWeights<dim,spacedim> partition_weights (weights);
+
+      void *userptr = parallel_forest->user_pointer;
+      parallel_forest->user_pointer = &partition_weights;
+
+      dealii::internal::p4est::functions<dim>::
+      partition (parallel_forest,
+                 /* prepare coarsening */ 1,
+                 /* weight_callback */ &PartitionWeights<dim,spacedim>::cell_weight);
+
+      parallel_forest->user_pointer = userptr;
+    }
+
+
+
     template <int dim, int spacedim>
     void
     Triangulation<dim,spacedim>::update_number_cache ()
@@ -3626,6 +4197,15 @@ namespace parallel
               ExcMessage ("The triangulation is empty!"));
       Assert (this->n_levels() == 1,
               ExcMessage ("The triangulation is refined!"));
+      // p4est modifies (and possibly reallocates) the arrays of the
+      // connectivity when joining faces, which is not possible if they are
+      // shared with other processes
+      AssertThrow (connectivity_window == MPI_WIN_NULL,
+                   ExcMessage ("Periodic boundaries can not be added to a "
+                               "triangulation whose coarse connectivity is "
+                               "shared between processes. Do not use the "
+                               "share_coarse_connectivity_within_node flag "
+                               "in this case."));
 
       typedef std::vector<GridTools::PeriodicFacePair<cell_iterator> >
       FaceVector;
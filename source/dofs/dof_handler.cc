@@ -15,6 +15,9 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/flat_binary_archive.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/std_cxx1x/bind.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_handler_policy.h>
 #include <deal.II/dofs/dof_levels.h>
@@ -758,7 +761,11 @@ DoFHandler<dim,spacedim>::DoFHandler (const Triangulation<dim,spacedim> &tria)
   tria(&tria, typeid(*this).name()),
   selected_fe(0, typeid(*this).name()),
   faces(NULL),
-  mg_faces (NULL)
+  mg_faces (NULL),
+  compressed_dof_indices_cache (false),
+  incremental_dof_distribution (false),
+  dof_indices_up_to_date (false),
+  recorded_n_dofs (0)
 {
   // decide whether we need a
   // sequential or a parallel
@@ -778,13 +785,23 @@ DoFHandler<dim,spacedim>::DoFHandler ()
   tria(0, typeid(*this).name()),
   selected_fe(0, typeid(*this).name()),
   faces(NULL),
-  mg_faces (NULL)
+  mg_faces (NULL),
+  compressed_dof_indices_cache (false),
+  incremental_dof_distribution (false),
+  dof_indices_up_to_date (false),
+  recorded_n_dofs (0)
 {}
 
 
 template <int dim, int spacedim>
 DoFHandler<dim,spacedim>::~DoFHandler ()
 {
+  // unsubscribe as a listener to refinement
+  // of the underlying triangulation
+  for (unsigned int i=0; i<tria_listeners.size(); ++i)
+    tria_listeners[i].disconnect ();
+  tria_listeners.clear ();
+
   // release allocated memory
   clear ();
 }
@@ -810,6 +827,11 @@ DoFHandler<dim,spacedim>::initialize(
   else
     policy.reset (new internal::DoFHandler::Policy::ParallelDistributed<dim,spacedim>());
 
+  // listen to the new triangulation if so
+  // requested
+  if (incremental_dof_distribution)
+    set_incremental_dof_distribution (true);
+
   distribute_dofs(fe);
 }
 
@@ -1196,11 +1218,42 @@ DoFHandler<dim,spacedim>::memory_consumption () const
   for (unsigned int i = 0; i < mg_vertex_dofs.size (); ++i)
     mem += sizeof (MGVertexDoFs) + (1 + mg_vertex_dofs[i].get_finest_level () - mg_vertex_dofs[i].get_coarsest_level ()) * sizeof (types::global_dof_index);
 
+  mem += (recorded_cells.capacity() * sizeof (std::pair<CellId,unsigned int>) +
+          MemoryConsumption::memory_consumption (recorded_dof_indices));
+
   return mem;
 }
 
 
 
+template<int dim, int spacedim>
+void
+DoFHandler<dim,spacedim>::save_snapshot (std::ostream &out) const
+{
+  internal::FlatBinaryOArchive archive (out,
+                                        "DoFHandler<"
+                                        + Utilities::int_to_string(dim) + ","
+                                        + Utilities::int_to_string(spacedim)
+                                        + ">");
+  save (archive, 0);
+}
+
+
+
+template<int dim, int spacedim>
+void
+DoFHandler<dim,spacedim>::load_snapshot (std::istream &in)
+{
+  internal::FlatBinaryIArchive archive (in,
+                                        "DoFHandler<"
+                                        + Utilities::int_to_string(dim) + ","
+                                        + Utilities::int_to_string(spacedim)
+                                        + ">");
+  load (archive, 0);
+}
+
+
+
 template<int dim, int spacedim>
 void DoFHandler<dim,spacedim>::distribute_dofs (const FiniteElement<dim,spacedim> &ff)
 {
@@ -1227,6 +1280,12 @@ void DoFHandler<dim,spacedim>::distribute_dofs (const FiniteElement<dim,spacedim
 
   // hand things off to the policy
   number_cache = policy->distribute_dofs (*this);
+  compress_dof_indices_cache ();
+
+  // indices recorded before the last
+  // refinement are now obsolete
+  clear_recorded_dof_indices ();
+  dof_indices_up_to_date = true;
 
   // initialize the block info object
   // only if this is a sequential
@@ -1295,12 +1354,215 @@ void DoFHandler<dim,spacedim>::initialize_local_block_info ()
 
 
 
+template<int dim, int spacedim>
+void DoFHandler<dim,spacedim>::set_compressed_dof_indices_cache (const bool compress)
+{
+  compressed_dof_indices_cache = compress;
+  if (compress)
+    compress_dof_indices_cache ();
+  else
+    for (unsigned int i=0; i<levels.size(); ++i)
+      levels[i]->uncompress_cell_dof_indices_cache ();
+}
+
+
+
+template<int dim, int spacedim>
+bool DoFHandler<dim,spacedim>::dof_indices_cache_is_compressed () const
+{
+  if (levels.size() == 0)
+    return false;
+
+  for (unsigned int i=0; i<levels.size(); ++i)
+    if (levels[i]->cell_dof_indices_cache_is_compressed() == false)
+      return false;
+  return true;
+}
+
+
+
+template<int dim, int spacedim>
+void DoFHandler<dim,spacedim>::compress_dof_indices_cache ()
+{
+  if (compressed_dof_indices_cache == false || selected_fe == 0)
+    return;
+
+  for (unsigned int i=0; i<levels.size(); ++i)
+    levels[i]->compress_cell_dof_indices_cache (selected_fe->dofs_per_cell);
+}
+
+
+
+template<int dim, int spacedim>
+void DoFHandler<dim,spacedim>::set_incremental_dof_distribution (const bool incremental)
+{
+  for (unsigned int i=0; i<tria_listeners.size(); ++i)
+    tria_listeners[i].disconnect ();
+  tria_listeners.clear ();
+  clear_recorded_dof_indices ();
+
+  incremental_dof_distribution = incremental;
+  if (incremental == false)
+    return;
+
+  Assert (tria != 0, ExcNotInitialized());
+  AssertThrow ((dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim>*>
+                (&*tria) == 0),
+               ExcNotImplemented());
+
+  tria_listeners.push_back
+  (tria->signals.pre_refinement
+   .connect (std_cxx1x::bind (&DoFHandler<dim,spacedim>::record_dof_indices,
+                              std_cxx1x::ref(*this))));
+  tria_listeners.push_back
+  (tria->signals.any_change
+   .connect (std_cxx1x::bind (&DoFHandler<dim,spacedim>::mark_dof_indices_out_of_date,
+                              std_cxx1x::ref(*this))));
+  tria_listeners.push_back
+  (tria->signals.clear
+   .connect (std_cxx1x::bind (&DoFHandler<dim,spacedim>::clear_recorded_dof_indices,
+                              std_cxx1x::ref(*this))));
+}
+
+
+
+template<int dim, int spacedim>
+void DoFHandler<dim,spacedim>::record_dof_indices ()
+{
+  // the stored indices are only
+  // meaningful before the first
+  // refinement after distributing
+  // degrees of freedom. in later
+  // refinement steps, keep what we
+  // have: cells that were not changed
+  // since then can still be
+  // identified by their id
+  if ((dof_indices_up_to_date == false) ||
+      (recorded_cells.size() > 0) ||
+      (selected_fe == 0))
+    return;
+
+  const unsigned int dofs_per_cell = selected_fe->dofs_per_cell;
+  std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+
+  recorded_cells.reserve (tria->n_active_cells());
+  recorded_dof_indices.reserve (tria->n_active_cells() * dofs_per_cell);
+  for (active_cell_iterator cell = begin_active(); cell != end(); ++cell)
+    {
+      cell->get_dof_indices (local_dof_indices);
+      recorded_cells.push_back (std::make_pair (cell->id(),
+                                                static_cast<unsigned int>(recorded_cells.size())));
+      recorded_dof_indices.insert (recorded_dof_indices.end(),
+                                   local_dof_indices.begin(),
+                                   local_dof_indices.end());
+    }
+  std::sort (recorded_cells.begin(), recorded_cells.end());
+
+  recorded_n_dofs = n_dofs();
+}
+
+
+
+template<int dim, int spacedim>
+void DoFHandler<dim,spacedim>::mark_dof_indices_out_of_date ()
+{
+  dof_indices_up_to_date = false;
+}
+
+
+
+template<int dim, int spacedim>
+void DoFHandler<dim,spacedim>::clear_recorded_dof_indices ()
+{
+  std::vector<std::pair<CellId,unsigned int> > tmp_cells;
+  recorded_cells.swap (tmp_cells);
+  std::vector<types::global_dof_index> tmp_indices;
+  recorded_dof_indices.swap (tmp_indices);
+  recorded_n_dofs = 0;
+}
+
+
+
+template<int dim, int spacedim>
+void
+DoFHandler<dim,spacedim>::redistribute_dofs (std::vector<types::global_dof_index> &old_to_new_dofs)
+{
+  Assert (selected_fe != 0, ExcNotInitialized());
+
+  if (recorded_cells.size() == 0)
+    {
+      old_to_new_dofs.assign (n_dofs(), invalid_dof_index);
+      distribute_dofs (*selected_fe);
+      return;
+    }
+
+  const unsigned int dofs_per_cell = selected_fe->dofs_per_cell;
+
+  // find the cells that were already
+  // active when the indices were
+  // recorded, and mark their degrees
+  // of freedom as kept
+  std::vector<std::pair<active_cell_iterator,unsigned int> > unchanged_cells;
+  old_to_new_dofs.assign (recorded_n_dofs, invalid_dof_index);
+  for (active_cell_iterator cell = begin_active(); cell != end(); ++cell)
+    {
+      const CellId id = cell->id();
+      const typename std::vector<std::pair<CellId,unsigned int> >::const_iterator
+      p = std::lower_bound (recorded_cells.begin(),
+                            recorded_cells.end(),
+                            std::make_pair (id, 0U));
+      if ((p != recorded_cells.end()) && (p->first == id))
+        {
+          unchanged_cells.push_back (std::make_pair (cell, p->second));
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            old_to_new_dofs[recorded_dof_indices[p->second*dofs_per_cell+i]] = 0;
+        }
+    }
+
+  // number the kept degrees of
+  // freedom in their previous order
+  types::global_dof_index n_kept_dofs = 0;
+  for (types::global_dof_index i=0; i<old_to_new_dofs.size(); ++i)
+    if (old_to_new_dofs[i] != invalid_dof_index)
+      old_to_new_dofs[i] = n_kept_dofs++;
+
+  // then set up the storage for the
+  // new triangulation, copy the kept
+  // indices into it and let the
+  // policy number the remaining
+  // degrees of freedom
+  clear_space ();
+  internal::DoFHandler::Implementation::reserve_space (*this);
+
+  std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+  for (unsigned int c=0; c<unchanged_cells.size(); ++c)
+    {
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        local_dof_indices[i]
+          = old_to_new_dofs[recorded_dof_indices[unchanged_cells[c].second*dofs_per_cell+i]];
+      unchanged_cells[c].first->set_dof_indices (local_dof_indices);
+    }
+
+  number_cache = policy->distribute_additional_dofs (*this, n_kept_dofs);
+  compress_dof_indices_cache ();
+
+  clear_recorded_dof_indices ();
+  dof_indices_up_to_date = true;
+
+  block_info_object.initialize(*this, false, true);
+}
+
+
+
 template<int dim, int spacedim>
 void DoFHandler<dim,spacedim>::clear ()
 {
   // release lock to old fe
   selected_fe = 0;
 
+  clear_recorded_dof_indices ();
+  dof_indices_up_to_date = false;
+
   // release memory
   clear_space ();
   clear_mg_space ();
@@ -1341,6 +1603,7 @@ DoFHandler<dim,spacedim>::renumber_dofs (const std::vector<types::global_dof_ind
 #endif
 
   number_cache = policy->renumber_dofs (new_numbers, *this);
+  compress_dof_indices_cache ();
 }
 
 
@@ -20,6 +20,8 @@
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx1x/bind.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -51,176 +53,389 @@ namespace internal
         /* -------------- distribute_dofs functionality ------------- */
 
         /**
-         * Distribute dofs on the given cell,
-         * with new dofs starting with index
-         * @p next_free_dof. Return the next
-         * unused index number.
-         *
-         * This function is excluded from the
-         * @p distribute_dofs function since
-         * it can not be implemented dimension
-         * independent.
+         * Return how many vertices, lines
+         * and quads of a cell carry degrees
+         * of freedom of their own, and
+         * whether the interior of the cell
+         * does (@p n_interior is then one,
+         * otherwise zero).
+         */
+        template <int dim, int spacedim>
+        static
+        void
+        get_dof_object_layout (const FiniteElement<dim,spacedim> &fe,
+                               unsigned int &n_vertices,
+                               unsigned int &n_lines,
+                               unsigned int &n_quads,
+                               unsigned int &n_interior)
+        {
+          n_vertices = (fe.dofs_per_vertex > 0 ?
+                        GeometryInfo<dim>::vertices_per_cell : 0);
+          n_lines    = ((dim > 1) && (fe.dofs_per_line > 0) ?
+                        GeometryInfo<dim>::lines_per_cell : 0);
+          n_quads    = ((dim > 2) && (fe.dofs_per_quad > 0) ?
+                        GeometryInfo<dim>::quads_per_cell : 0);
+          n_interior = (fe.template n_dofs_per_object<dim>() > 0 ? 1 : 0);
+        }
+
+
+
+        /**
+         * Return the first DoF index on
+         * the @p q-th quad of a cell, and
+         * set the DoF indices on it. The
+         * overloads for 1d exist only so
+         * that the dimension independent
+         * functions below compile; cells
+         * in 1d have no quads.
          */
+        template <int dim, int spacedim>
+        static
+        types::global_dof_index
+        quad_dof_index (const DoFHandler<dim,spacedim> &,
+                        const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell,
+                        const unsigned int q)
+        {
+          return cell->quad(q)->dof_index(0);
+        }
+
         template <int spacedim>
         static
         types::global_dof_index
-        distribute_dofs_on_cell (const DoFHandler<1,spacedim> &dof_handler,
-                                 const typename DoFHandler<1,spacedim>::active_cell_iterator &cell,
-                                 types::global_dof_index next_free_dof)
+        quad_dof_index (const DoFHandler<1,spacedim> &,
+                        const typename DoFHandler<1,spacedim>::active_cell_iterator &,
+                        const unsigned int)
         {
+          Assert (false, ExcImpossibleInDim(1));
+          return DoFHandler<1,spacedim>::invalid_dof_index;
+        }
 
-          // distribute dofs of vertices
-          if (dof_handler.get_fe().dofs_per_vertex > 0)
-            for (unsigned int v=0; v<GeometryInfo<1>::vertices_per_cell; ++v)
-              {
-                if (cell->vertex_dof_index (v,0) ==
-                    DoFHandler<1,spacedim>::invalid_dof_index)
-                  for (unsigned int d=0;
-                       d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                    {
-                      Assert ((cell->vertex_dof_index (v,d) ==
-                               DoFHandler<1,spacedim>::invalid_dof_index),
-                              ExcInternalError());
-                      cell->set_vertex_dof_index (v, d, next_free_dof++);
-                    }
-                else
-                  for (unsigned int d=0;
-                       d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                    Assert ((cell->vertex_dof_index (v,d) !=
-                             DoFHandler<1,spacedim>::invalid_dof_index),
-                            ExcInternalError());
-              }
+        template <int dim, int spacedim>
+        static
+        void
+        set_quad_dof_indices (const DoFHandler<dim,spacedim> &dof_handler,
+                              const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell,
+                              const unsigned int q,
+                              types::global_dof_index &next_free_dof)
+        {
+          const typename DoFHandler<dim,spacedim>::quad_iterator
+          quad = cell->quad(q);
+          for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_quad; ++d)
+            quad->set_dof_index (d, next_free_dof++);
+        }
 
-          // dofs of line
-          for (unsigned int d=0;
-               d<dof_handler.get_fe().dofs_per_line; ++d)
-            cell->set_dof_index (d, next_free_dof++);
+        template <int spacedim>
+        static
+        void
+        set_quad_dof_indices (const DoFHandler<1,spacedim> &,
+                              const typename DoFHandler<1,spacedim>::active_cell_iterator &,
+                              const unsigned int,
+                              types::global_dof_index &)
+        {
+          Assert (false, ExcImpossibleInDim(1));
+        }
 
-          // note that this cell has been
-          // processed
-          cell->set_user_flag ();
 
-          return next_free_dof;
+
+        /**
+         * For the cells with indices
+         * <code>[begin,end)</code> in the
+         * given array, store the indices
+         * of all vertices, lines and quads
+         * that carry degrees of freedom,
+         * followed by the index of the
+         * cell within @p cells for its
+         * interior, in @p objects in the
+         * layout determined by
+         * get_dof_object_layout(). Objects
+         * that already have degrees of
+         * freedom are stored as
+         * numbers::invalid_unsigned_int
+         * since they must not be numbered
+         * again.
+         *
+         * This function only reads from
+         * the DoFHandler and writes to
+         * disjoint parts of @p objects for
+         * different ranges, so it may run
+         * on several threads concurrently.
+         */
+        template <int dim, int spacedim>
+        static
+        void
+        collect_dof_objects_on_cells (const unsigned int begin,
+                                      const unsigned int end,
+                                      const std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> &cells,
+                                      std::vector<unsigned int> &objects)
+        {
+          const FiniteElement<dim,spacedim> &fe = cells[begin]->get_fe();
+          unsigned int n_vertices, n_lines, n_quads, n_interior;
+          get_dof_object_layout (fe, n_vertices, n_lines, n_quads, n_interior);
+          const unsigned int n_objects = n_vertices + n_lines + n_quads + n_interior;
+
+          for (unsigned int c=begin; c<end; ++c)
+            {
+              const typename DoFHandler<dim,spacedim>::active_cell_iterator
+              &cell = cells[c];
+              std::vector<unsigned int>::iterator
+              next = objects.begin() + c*n_objects;
+
+              for (unsigned int v=0; v<n_vertices; ++v, ++next)
+                *next = (cell->vertex_dof_index(v,0) ==
+                         DoFHandler<dim,spacedim>::invalid_dof_index
+                         ?
+                         cell->vertex_index(v)
+                         :
+                         numbers::invalid_unsigned_int);
+              for (unsigned int l=0; l<n_lines; ++l, ++next)
+                *next = (cell->line(l)->dof_index(0) ==
+                         DoFHandler<dim,spacedim>::invalid_dof_index
+                         ?
+                         cell->line_index(l)
+                         :
+                         numbers::invalid_unsigned_int);
+              for (unsigned int q=0; q<n_quads; ++q, ++next)
+                *next = (quad_dof_index (cell->get_dof_handler(), cell, q) ==
+                         DoFHandler<dim,spacedim>::invalid_dof_index
+                         ?
+                         cell->quad_index(q)
+                         :
+                         numbers::invalid_unsigned_int);
+              if (n_interior > 0)
+                *next = (cell->dof_index(0) ==
+                         DoFHandler<dim,spacedim>::invalid_dof_index
+                         ?
+                         c
+                         :
+                         numbers::invalid_unsigned_int);
+            }
         }
 
 
 
-        template <int spacedim>
+        /**
+         * Return the number of degrees
+         * of freedom that the cells of
+         * the given chunk will number,
+         * given which of their vertices,
+         * lines and quads they own.
+         */
+        template <int dim, int spacedim>
         static
         types::global_dof_index
-        distribute_dofs_on_cell (const DoFHandler<2,spacedim> &dof_handler,
-                                 const typename DoFHandler<2,spacedim>::active_cell_iterator &cell,
-                                 types::global_dof_index next_free_dof)
+        count_dofs_on_chunk (const unsigned int chunk,
+                             const unsigned int chunk_size,
+                             const std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> &cells,
+                             const std::vector<bool> &owned_objects)
         {
-          if (dof_handler.get_fe().dofs_per_vertex > 0)
-            // number dofs on vertices
-            for (unsigned int vertex=0; vertex<GeometryInfo<2>::vertices_per_cell; ++vertex)
-              // check whether dofs for this
-              // vertex have been distributed
-              // (only check the first dof)
-              if (cell->vertex_dof_index(vertex, 0) == DoFHandler<2,spacedim>::invalid_dof_index)
-                for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                  cell->set_vertex_dof_index (vertex, d, next_free_dof++);
-
-          // for the four sides
-          if (dof_handler.get_fe().dofs_per_line > 0)
-            for (unsigned int side=0; side<GeometryInfo<2>::faces_per_cell; ++side)
-              {
-                const typename DoFHandler<2,spacedim>::line_iterator
-                line = cell->line(side);
-
-                // distribute dofs if necessary:
-                // check whether line dof is already
-                // numbered (check only first dof)
-                if (line->dof_index(0) == DoFHandler<2,spacedim>::invalid_dof_index)
-                  // if not: distribute dofs
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_line; ++d)
-                    line->set_dof_index (d, next_free_dof++);
-              }
+          const FiniteElement<dim,spacedim> &fe = cells[0]->get_fe();
+          unsigned int n_vertices, n_lines, n_quads, n_interior;
+          get_dof_object_layout (fe, n_vertices, n_lines, n_quads, n_interior);
+          const unsigned int n_objects = n_vertices + n_lines + n_quads + n_interior;
 
+          const unsigned int begin = chunk * chunk_size,
+                             end   = std::min<unsigned int> (begin + chunk_size,
+                                                             cells.size());
 
-          // dofs of quad
-          if (dof_handler.get_fe().dofs_per_quad > 0)
-            for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_quad; ++d)
-              cell->set_dof_index (d, next_free_dof++);
+          types::global_dof_index n_dofs = 0;
+          for (unsigned int c=begin; c<end; ++c)
+            {
+              std::vector<bool>::const_iterator
+              owned = owned_objects.begin() + c*n_objects;
+              for (unsigned int v=0; v<n_vertices; ++v, ++owned)
+                if (*owned)
+                  n_dofs += fe.dofs_per_vertex;
+              for (unsigned int l=0; l<n_lines; ++l, ++owned)
+                if (*owned)
+                  n_dofs += fe.dofs_per_line;
+              for (unsigned int q=0; q<n_quads; ++q, ++owned)
+                if (*owned)
+                  n_dofs += fe.dofs_per_quad;
+              if ((n_interior > 0) && (*owned))
+                n_dofs += fe.template n_dofs_per_object<dim>();
+            }
+          return n_dofs;
+        }
 
 
-          // note that this cell has been processed
-          cell->set_user_flag ();
 
-          return next_free_dof;
+        /**
+         * Count the degrees of freedom
+         * numbered by each of the chunks
+         * <code>[begin,end)</code>.
+         */
+        template <int dim, int spacedim>
+        static
+        void
+        count_dofs_on_chunks (const unsigned int begin,
+                              const unsigned int end,
+                              const unsigned int chunk_size,
+                              const std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> &cells,
+                              const std::vector<bool> &owned_objects,
+                              std::vector<types::global_dof_index> &n_dofs_on_chunk)
+        {
+          for (unsigned int chunk=begin; chunk<end; ++chunk)
+            n_dofs_on_chunk[chunk]
+              = count_dofs_on_chunk<dim,spacedim> (chunk, chunk_size,
+                                                   cells, owned_objects);
         }
 
 
-        template <int spacedim>
+
+        /**
+         * Number the degrees of freedom
+         * on the chunks of cells
+         * <code>[begin,end)</code>. Within
+         * each chunk, the cells are
+         * visited in order and on each
+         * cell first the vertices, then
+         * the lines, the quads and
+         * finally the interior are
+         * numbered, starting at the
+         * first index given for this
+         * chunk. Only objects owned by a
+         * cell get numbers on that cell.
+         *
+         * Since every vertex, line and
+         * quad is owned by exactly one
+         * cell, different chunks write
+         * to disjoint memory locations
+         * and this function may run on
+         * several threads concurrently.
+         */
+        template <int dim, int spacedim>
         static
-        types::global_dof_index
-        distribute_dofs_on_cell (const DoFHandler<3,spacedim> &dof_handler,
-                                 const typename DoFHandler<3,spacedim>::active_cell_iterator &cell,
-                                 types::global_dof_index next_free_dof)
+        void
+        distribute_dofs_on_chunks (const unsigned int begin,
+                                   const unsigned int end,
+                                   const unsigned int chunk_size,
+                                   const std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> &cells,
+                                   const std::vector<bool> &owned_objects,
+                                   const std::vector<types::global_dof_index> &first_dof_on_chunk)
         {
-          if (dof_handler.get_fe().dofs_per_vertex > 0)
-            // number dofs on vertices
-            for (unsigned int vertex=0; vertex<GeometryInfo<3>::vertices_per_cell; ++vertex)
-              // check whether dofs for this
-              // vertex have been distributed
-              // (only check the first dof)
-              if (cell->vertex_dof_index(vertex, 0) == DoFHandler<3,spacedim>::invalid_dof_index)
-                for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                  cell->set_vertex_dof_index (vertex, d, next_free_dof++);
+          const FiniteElement<dim,spacedim> &fe = cells[0]->get_fe();
+          unsigned int n_vertices, n_lines, n_quads, n_interior;
+          get_dof_object_layout (fe, n_vertices, n_lines, n_quads, n_interior);
+          const unsigned int n_objects = n_vertices + n_lines + n_quads + n_interior;
+          const unsigned int dofs_per_cell_interior
+            = fe.template n_dofs_per_object<dim>();
+
+          for (unsigned int chunk=begin; chunk<end; ++chunk)
+            {
+              types::global_dof_index next_free_dof = first_dof_on_chunk[chunk];
 
-          // for the lines
-          if (dof_handler.get_fe().dofs_per_line > 0)
-            for (unsigned int l=0; l<GeometryInfo<3>::lines_per_cell; ++l)
-              {
-                const typename DoFHandler<3,spacedim>::line_iterator
-                line = cell->line(l);
+              const unsigned int first_cell = chunk * chunk_size,
+                                 last_cell  = std::min<unsigned int> (first_cell + chunk_size,
+                                                                      cells.size());
+              for (unsigned int c=first_cell; c<last_cell; ++c)
+                {
+                  const typename DoFHandler<dim,spacedim>::active_cell_iterator
+                  &cell = cells[c];
+                  std::vector<bool>::const_iterator
+                  owned = owned_objects.begin() + c*n_objects;
+
+                  for (unsigned int v=0; v<n_vertices; ++v, ++owned)
+                    if (*owned)
+                      for (unsigned int d=0; d<fe.dofs_per_vertex; ++d)
+                        cell->set_vertex_dof_index (v, d, next_free_dof++);
+
+                  for (unsigned int l=0; l<n_lines; ++l, ++owned)
+                    if (*owned)
+                      {
+                        const typename DoFHandler<dim,spacedim>::line_iterator
+                        line = cell->line(l);
+                        for (unsigned int d=0; d<fe.dofs_per_line; ++d)
+                          line->set_dof_index (d, next_free_dof++);
+                      }
 
-                // distribute dofs if necessary:
-                // check whether line dof is already
-                // numbered (check only first dof)
-                if (line->dof_index(0) == DoFHandler<3,spacedim>::invalid_dof_index)
-                  // if not: distribute dofs
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_line; ++d)
-                    line->set_dof_index (d, next_free_dof++);
-              }
+                  for (unsigned int q=0; q<n_quads; ++q, ++owned)
+                    if (*owned)
+                      set_quad_dof_indices (cell->get_dof_handler(), cell, q,
+                                            next_free_dof);
 
-          // for the quads
-          if (dof_handler.get_fe().dofs_per_quad > 0)
-            for (unsigned int q=0; q<GeometryInfo<3>::quads_per_cell; ++q)
-              {
-                const typename DoFHandler<3,spacedim>::quad_iterator
-                quad = cell->quad(q);
+                  if ((n_interior > 0) && (*owned))
+                    for (unsigned int d=0; d<dofs_per_cell_interior; ++d)
+                      cell->set_dof_index (d, next_free_dof++);
+                }
+
+              Assert ((chunk+1 == first_dof_on_chunk.size())
+                      ||
+                      (next_free_dof == first_dof_on_chunk[chunk+1]),
+                      ExcInternalError());
+            }
+        }
 
-                // distribute dofs if necessary:
-                // check whether quad dof is already
-                // numbered (check only first dof)
-                if (quad->dof_index(0) == DoFHandler<3,spacedim>::invalid_dof_index)
-                  // if not: distribute dofs
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_quad; ++d)
-                    quad->set_dof_index (d, next_free_dof++);
-              }
 
 
-          // dofs of hex
-          if (dof_handler.get_fe().dofs_per_hex > 0)
-            for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_hex; ++d)
-              cell->set_dof_index (d, next_free_dof++);
+        /**
+         * Update the cache of DoF
+         * indices on the cells with
+         * indices <code>[begin,end)</code>
+         * in the given array.
+         */
+        template <typename CellIterator>
+        static
+        void
+        update_cell_dof_indices_cache_on_cells (const unsigned int begin,
+                                                const unsigned int end,
+                                                const std::vector<CellIterator> &cells)
+        {
+          for (unsigned int c=begin; c<end; ++c)
+            cells[c]->update_cell_dof_indices_cache ();
+        }
 
 
-          // note that this cell has been
-          // processed
-          cell->set_user_flag ();
 
-          return next_free_dof;
+        /**
+         * Update the cache of DoF
+         * indices on all of the given
+         * cells, possibly in parallel.
+         * Each cell writes only its own
+         * part of the cache, but going
+         * back from a compressed to the
+         * plain form of the cache
+         * reallocates the arrays of a
+         * whole level, so this is done
+         * up front for all levels.
+         */
+        template <int dim, int spacedim, typename CellIterator>
+        static
+        void
+        update_cell_dof_indices_caches (DoFHandler<dim,spacedim> &dof_handler,
+                                        const std::vector<CellIterator> &cells)
+        {
+          for (unsigned int level=0; level<dof_handler.levels.size(); ++level)
+            dof_handler.levels[level]->uncompress_cell_dof_indices_cache ();
+
+          parallel::apply_to_subranges
+          (0U, cells.size(),
+           std_cxx1x::bind (&update_cell_dof_indices_cache_on_cells<CellIterator>,
+                            std_cxx1x::_1, std_cxx1x::_2,
+                            std_cxx1x::cref(cells)),
+           256);
         }
 
 
+
         /**
          * Distribute degrees of freedom on all cells, or on cells with the
          * correct subdomain_id if the corresponding argument is not equal to
          * numbers::invalid_subdomain_id. Return the total number of dofs
          * distributed.
+         *
+         * The result is the same as if we walked over the cells in order and
+         * numbered, on each cell, first all vertices, then lines, quads and
+         * the cell interior that have not been numbered before. To do this on several threads, we split the cells into chunks
+         * of fixed size and proceed in four steps:
+         * - Collect the vertex, line and quad indices of all cells (in
+         *   parallel).
+         * - Determine for every object the first cell that touches it; this
+         *   cell owns the object. This is a single sweep over an integer
+         *   array and the only sequential part of the algorithm.
+         * - Count the number of degrees of freedom numbered by each chunk (in
+         *   parallel) and form the prefix sum over the chunks.
+         * - Starting at its offset, every chunk numbers the objects owned by
+         *   its cells (in parallel).
          */
         template <int dim, int spacedim>
         static
@@ -233,35 +448,127 @@ namespace internal
             = dof_handler.get_tria();
           Assert (tria.n_levels() > 0, ExcMessage("Empty triangulation"));
 
-          // Clear user flags because we will need them. But first we save
-          // them and make sure that we restore them later such that at the
-          // end of this function the Triangulation will be in the same state
-          // as it was at the beginning of this function.
-          std::vector<bool> user_flags;
-          tria.save_user_flags(user_flags);
-          const_cast<dealii::Triangulation<dim,spacedim> &>(tria).clear_user_flags ();
+          const unsigned int chunk_size = 256;
+
+          std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator>
+          cells, cells_with_cache;
+          for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+               cell = dof_handler.begin_active();
+               cell != dof_handler.end(); ++cell)
+            {
+              if ((subdomain_id == numbers::invalid_subdomain_id)
+                  ||
+                  (cell->subdomain_id() == subdomain_id))
+                cells.push_back (cell);
+              if (!cell->is_artificial())
+                cells_with_cache.push_back (cell);
+            }
 
           types::global_dof_index next_free_dof = offset;
-          typename DoFHandler<dim,spacedim>::active_cell_iterator
-          cell = dof_handler.begin_active(),
-          endc = dof_handler.end();
+          if (cells.size() > 0)
+            {
+              const FiniteElement<dim,spacedim> &fe = dof_handler.get_fe();
+              unsigned int n_vertices, n_lines, n_quads, n_interior;
+              get_dof_object_layout (fe, n_vertices, n_lines, n_quads, n_interior);
+              const unsigned int n_objects = n_vertices + n_lines + n_quads + n_interior;
+
+              // step 1: find the objects that may carry new dofs
+              std::vector<unsigned int> objects (cells.size() * n_objects);
+              if (n_objects > 0)
+                parallel::apply_to_subranges
+                (0U, cells.size(),
+                 std_cxx1x::bind (&collect_dof_objects_on_cells<dim,spacedim>,
+                                  std_cxx1x::_1, std_cxx1x::_2,
+                                  std_cxx1x::cref(cells),
+                                  std_cxx1x::ref(objects)),
+                 chunk_size);
+
+              // step 2: the first cell to see an object owns it
+              std::vector<bool> owned_objects (objects.size(), false);
+              {
+                std::vector<bool> vertex_touched (n_vertices > 0 ?
+                                                  tria.n_vertices() : 0,
+                                                  false);
+                std::vector<bool> line_touched (n_lines > 0 ?
+                                                tria.n_raw_lines() : 0,
+                                                false);
+                std::vector<bool> quad_touched (n_quads > 0 ?
+                                                tria.n_raw_quads() : 0,
+                                                false);
+                std::vector<unsigned int>::const_iterator
+                object = objects.begin();
+                std::vector<bool>::iterator
+                owned = owned_objects.begin();
+                for (unsigned int c=0; c<cells.size(); ++c)
+                  {
+                    for (unsigned int v=0; v<n_vertices; ++v, ++object, ++owned)
+                      if ((*object != numbers::invalid_unsigned_int)
+                          &&
+                          (vertex_touched[*object] == false))
+                        {
+                          vertex_touched[*object] = true;
+                          *owned = true;
+                        }
+                    for (unsigned int l=0; l<n_lines; ++l, ++object, ++owned)
+                      if ((*object != numbers::invalid_unsigned_int)
+                          &&
+                          (line_touched[*object] == false))
+                        {
+                          line_touched[*object] = true;
+                          *owned = true;
+                        }
+                    for (unsigned int q=0; q<n_quads; ++q, ++object, ++owned)
+                      if ((*object != numbers::invalid_unsigned_int)
+                          &&
+                          (quad_touched[*object] == false))
+                        {
+                          quad_touched[*object] = true;
+                          *owned = true;
+                        }
+                    if (n_interior > 0)
+                      {
+                        *owned = (*object != numbers::invalid_unsigned_int);
+                        ++object;
+                        ++owned;
+                      }
+                  }
+              }
 
-          for (; cell != endc; ++cell)
-            if ((subdomain_id == numbers::invalid_subdomain_id)
-                ||
-                (cell->subdomain_id() == subdomain_id))
-              next_free_dof
-                = Implementation::distribute_dofs_on_cell (dof_handler,
-                                                           cell,
-                                                           next_free_dof);
+              // step 3: count dofs per chunk and compute where each chunk
+              // starts numbering
+              const unsigned int n_chunks = (cells.size() + chunk_size - 1) / chunk_size;
+              std::vector<types::global_dof_index> first_dof_on_chunk (n_chunks);
+              parallel::apply_to_subranges
+              (0U, n_chunks,
+               std_cxx1x::bind (&count_dofs_on_chunks<dim,spacedim>,
+                                std_cxx1x::_1, std_cxx1x::_2,
+                                chunk_size,
+                                std_cxx1x::cref(cells),
+                                std_cxx1x::cref(owned_objects),
+                                std_cxx1x::ref(first_dof_on_chunk)),
+               1);
+              for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+                {
+                  const types::global_dof_index n_dofs_on_chunk
+                    = first_dof_on_chunk[chunk];
+                  first_dof_on_chunk[chunk] = next_free_dof;
+                  next_free_dof += n_dofs_on_chunk;
+                }
 
-          // update the cache used for cell dof indices
-          for (cell = dof_handler.begin_active(); cell != endc; ++cell)
-            if (!cell->is_artificial())
-              cell->update_cell_dof_indices_cache ();
+              // step 4: number the dofs
+              parallel::apply_to_subranges
+              (0U, n_chunks,
+               std_cxx1x::bind (&distribute_dofs_on_chunks<dim,spacedim>,
+                                std_cxx1x::_1, std_cxx1x::_2,
+                                chunk_size,
+                                std_cxx1x::cref(cells),
+                                std_cxx1x::cref(owned_objects),
+                                std_cxx1x::cref(first_dof_on_chunk)),
+               1);
+            }
 
-          // finally restore the user flags
-          const_cast<dealii::Triangulation<dim,spacedim> &>(tria).load_user_flags(user_flags);
+          // update the cache used for cell dof indices
+          update_cell_dof_indices_caches (dof_handler, cells_with_cache);
 
           return next_free_dof;
         }
@@ -573,10 +880,14 @@ namespace internal
           // update the cache
           // used for cell dof
           // indices
+          std::vector<typename DoFHandler<1,spacedim>::level_cell_iterator>
+          cells;
+          cells.reserve (dof_handler.get_tria().n_cells());
           for (typename DoFHandler<1,spacedim>::level_cell_iterator
                cell = dof_handler.begin();
                cell != dof_handler.end(); ++cell)
-            cell->update_cell_dof_indices_cache ();
+            cells.push_back (cell);
+          update_cell_dof_indices_caches (dof_handler, cells);
         }
 
         template <int spacedim>
@@ -683,10 +994,14 @@ namespace internal
           // update the cache
           // used for cell dof
           // indices
+          std::vector<typename DoFHandler<2,spacedim>::level_cell_iterator>
+          cells;
+          cells.reserve (dof_handler.get_tria().n_cells());
           for (typename DoFHandler<2,spacedim>::level_cell_iterator
                cell = dof_handler.begin();
                cell != dof_handler.end(); ++cell)
-            cell->update_cell_dof_indices_cache ();
+            cells.push_back (cell);
+          update_cell_dof_indices_caches (dof_handler, cells);
         }
 
         template <int spacedim>
@@ -835,10 +1150,14 @@ namespace internal
           // update the cache
           // used for cell dof
           // indices
+          std::vector<typename DoFHandler<3,spacedim>::level_cell_iterator>
+          cells;
+          cells.reserve (dof_handler.get_tria().n_cells());
           for (typename DoFHandler<3,spacedim>::level_cell_iterator
                cell = dof_handler.begin();
                cell != dof_handler.end(); ++cell)
-            cell->update_cell_dof_indices_cache ();
+            cells.push_back (cell);
+          update_cell_dof_indices_caches (dof_handler, cells);
         }
 
         template <int spacedim>
@@ -873,9 +1192,20 @@ namespace internal
       NumberCache
       Sequential<dim,spacedim>::
       distribute_dofs (DoFHandler<dim,spacedim> &dof_handler) const
+      {
+        return distribute_additional_dofs (dof_handler, 0);
+      }
+
+
+
+      template <int dim, int spacedim>
+      NumberCache
+      Sequential<dim,spacedim>::
+      distribute_additional_dofs (DoFHandler<dim,spacedim> &dof_handler,
+                                  const types::global_dof_index offset) const
       {
         const types::global_dof_index n_dofs =
-          Implementation::distribute_dofs (0,
+          Implementation::distribute_dofs (offset,
                                            numbers::invalid_subdomain_id,
                                            dof_handler);
 
@@ -2148,6 +2478,20 @@ namespace internal
       }
 
 
+
+      template <int dim, int spacedim>
+      NumberCache
+      ParallelDistributed<dim, spacedim>::
+      distribute_additional_dofs (DoFHandler<dim,spacedim> &,
+                                  const types::global_dof_index) const
+      {
+        // keeping the numbers of some degrees of freedom would require
+        // to also keep the partitioning of indices between processors
+        AssertThrow (false, ExcNotImplemented());
+        return NumberCache();
+      }
+
+
       template <int dim, int spacedim>
       void
       ParallelDistributed<dim, spacedim>::
@@ -40,6 +40,8 @@
 
 #include <deal.II/multigrid/mg_tools.h>
 
+#include <deal.II/matrix_free/matrix_free.h>
+
 #include <boost/config.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/cuthill_mckee_ordering.hpp>
@@ -351,6 +353,49 @@ namespace DoFRenumbering
 
 
 
+  namespace internal
+  {
+    /**
+     * Build the connectivity graph of the locally owned degrees of freedom
+     * of @p dof_handler in the local index space, i.e., row and column
+     * <tt>i</tt> of @p sparsity correspond to
+     * <tt>locally_owned_dofs().nth_index_in_set(i)</tt>. Couplings to degrees
+     * of freedom that are not locally owned are omitted.
+     */
+    template <class DH>
+    void
+    make_local_sparsity_pattern (const DH        &dof_handler,
+                                 SparsityPattern &sparsity)
+    {
+      const IndexSet &locally_owned = dof_handler.locally_owned_dofs();
+      CompressedSimpleSparsityPattern csp (locally_owned.n_elements(),
+                                           locally_owned.n_elements());
+
+      std::vector<types::global_dof_index> cell_dofs, local_dofs;
+      for (typename DH::active_cell_iterator cell = dof_handler.begin_active();
+           cell != dof_handler.end(); ++cell)
+        if (cell->is_locally_owned())
+          {
+            cell_dofs.resize (cell->get_fe().dofs_per_cell);
+            cell->get_dof_indices (cell_dofs);
+
+            local_dofs.clear ();
+            for (unsigned int i=0; i<cell_dofs.size(); ++i)
+              if (locally_owned.is_element (cell_dofs[i]))
+                local_dofs.push_back (locally_owned.index_within_set (cell_dofs[i]));
+            std::sort (local_dofs.begin(), local_dofs.end());
+
+            for (unsigned int i=0; i<local_dofs.size(); ++i)
+              csp.add_entries (local_dofs[i], local_dofs.begin(),
+                               local_dofs.end(), true);
+          }
+
+      sparsity.copy_from (csp);
+    }
+  }
+
+
+
   template <class DH>
   void
   Cuthill_McKee (DH              &dof_handler,
@@ -386,13 +431,41 @@ namespace DoFRenumbering
     //
     // note that if constraints are not requested, then the 'constraints'
     // object will be empty and nothing happens
+    IndexSet locally_owned = dof_handler.locally_owned_dofs();
+    SparsityPattern sparsity;
+
+    // in a distributed computation without constraints, build the graph of
+    // the locally owned degrees of freedom directly in the local index
+    // space from the locally owned cells. couplings to degrees of freedom
+    // owned by other processors (i.e., to ghosts) are simply dropped, as
+    // these are not renumbered here anyway. this avoids setting up a
+    // pattern in the global index space first
+    if ((locally_owned.n_elements() != locally_owned.size())
+        &&
+        (use_constraints == false))
+      {
+        internal::make_local_sparsity_pattern (dof_handler, sparsity);
+
+        Assert(new_indices.size() == sparsity.n_rows(),
+               ExcDimensionMismatch(new_indices.size(),
+                                    sparsity.n_rows()));
+
+        SparsityTools::reorder_Cuthill_McKee (sparsity, new_indices,
+                                              starting_indices);
+
+        if (reversed_numbering)
+          new_indices = Utilities::reverse_permutation (new_indices);
+
+        for (std::size_t i=0; i<new_indices.size(); ++i)
+          new_indices[i] = locally_owned.nth_index_in_set(new_indices[i]);
+        return;
+      }
+
     ConstraintMatrix constraints;
     if (use_constraints)
       DoFTools::make_hanging_node_constraints (dof_handler, constraints);
     constraints.close ();
 
-    IndexSet locally_owned = dof_handler.locally_owned_dofs();
-    SparsityPattern sparsity;
     if (DH::dimension < 2)
       {
         sparsity.reinit (dof_handler.n_dofs(),
@@ -1542,6 +1615,101 @@ namespace DoFRenumbering
 
 
 
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>              &dof_handler,
+                             const MatrixFree<dim,Number> &matrix_free,
+                             const unsigned int            fe_component)
+  {
+    std::vector<types::global_dof_index> renumbering (dof_handler.n_locally_owned_dofs(),
+                                                      DoFHandler<dim>::invalid_dof_index);
+    compute_matrix_free_data_locality (renumbering, dof_handler, matrix_free,
+                                       fe_component);
+
+    dof_handler.renumber_dofs(renumbering);
+  }
+
+
+
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free,
+                                     const unsigned int                    fe_component)
+  {
+    Assert (&matrix_free.get_dof_handler(fe_component) == &dof_handler,
+            ExcMessage ("The given DoFHandler must be the one stored in the "
+                        "MatrixFree object for the given fe_component."));
+
+    const IndexSet locally_owned = dof_handler.locally_owned_dofs();
+    const types::global_dof_index n_owned_dofs = locally_owned.n_elements();
+    Assert (new_indices.size() == n_owned_dofs,
+            ExcDimensionMismatch(new_indices.size(), n_owned_dofs));
+
+    // first find the locally owned degrees of freedom that are imported by
+    // other processors as ghosts, i.e., that sit on a ghost cell of this
+    // processor. in the serial case, there are no such cells
+    std::vector<bool> is_shared (n_owned_dofs, false);
+    std::vector<types::global_dof_index> cell_dofs;
+    for (typename DoFHandler<dim>::active_cell_iterator
+         cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+      if (cell->is_ghost())
+        {
+          cell_dofs.resize (cell->get_fe().dofs_per_cell);
+          cell->get_dof_indices (cell_dofs);
+          for (unsigned int i=0; i<cell_dofs.size(); ++i)
+            if (locally_owned.is_element (cell_dofs[i]))
+              is_shared[locally_owned.index_within_set (cell_dofs[i])] = true;
+        }
+
+    // then go through the cells in the order of the matrix-free loop and
+    // record the order in which the degrees of freedom are first touched,
+    // separately for the interior and the shared ones
+    std::vector<bool> touched (n_owned_dofs, false);
+    std::vector<types::global_dof_index> interior_order, shared_order;
+    interior_order.reserve (n_owned_dofs);
+    for (unsigned int macro_cell=0; macro_cell<matrix_free.n_macro_cells();
+         ++macro_cell)
+      for (unsigned int v=0; v<matrix_free.n_components_filled(macro_cell); ++v)
+        {
+          const typename DoFHandler<dim>::cell_iterator
+          cell = matrix_free.get_cell_iterator (macro_cell, v, fe_component);
+          Assert (cell->active(), ExcNotImplemented());
+
+          cell_dofs.resize (cell->get_fe().dofs_per_cell);
+          cell->get_dof_indices (cell_dofs);
+          for (unsigned int i=0; i<cell_dofs.size(); ++i)
+            if (locally_owned.is_element (cell_dofs[i]))
+              {
+                const types::global_dof_index local_index
+                  = locally_owned.index_within_set (cell_dofs[i]);
+                if (touched[local_index] == false)
+                  {
+                    touched[local_index] = true;
+                    if (is_shared[local_index])
+                      shared_order.push_back (local_index);
+                    else
+                      interior_order.push_back (local_index);
+                  }
+              }
+        }
+
+    // degrees of freedom on cells that are not part of the matrix-free loop
+    // (if any) keep their relative order and go last
+    interior_order.insert (interior_order.end(),
+                           shared_order.begin(), shared_order.end());
+    for (types::global_dof_index i=0; i<n_owned_dofs; ++i)
+      if (touched[i] == false)
+        interior_order.push_back (i);
+    Assert (interior_order.size() == n_owned_dofs, ExcRenumberingIncomplete());
+
+    for (types::global_dof_index i=0; i<n_owned_dofs; ++i)
+      new_indices[interior_order[i]] = locally_owned.nth_index_in_set (i);
+  }
+
+
+
 
 
 
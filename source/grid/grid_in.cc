@@ -29,6 +29,7 @@
 #include <fstream>
 #include <functional>
 #include <cctype>
+#include <cstring>
 
 
 #ifdef DEAL_II_WITH_NETCDF
@@ -1085,6 +1086,244 @@ void GridIn<3>::read_xda (std::istream &in)
 
 
 
+namespace
+{
+  /**
+   * Map the vertex numbers used in a Gmsh file to consecutive vertex
+   * indices. Gmsh numbers vertices starting at one and usually
+   * without gaps, so a plain table indexed by the vertex number is
+   * used whenever the numbers are not too sparse. Only for very sparse
+   * numberings do we fall back to a std::map.
+   */
+  class GmshVertexIndices
+  {
+  public:
+    void initialize (const std::vector<int> &vertex_numbers)
+    {
+      table.clear ();
+      map.clear ();
+
+      int max_number = 0;
+      bool numbers_are_positive = true;
+      for (unsigned int i=0; i<vertex_numbers.size(); ++i)
+        {
+          max_number = std::max (max_number, vertex_numbers[i]);
+          if (vertex_numbers[i] < 0)
+            numbers_are_positive = false;
+        }
+
+      use_table = (numbers_are_positive &&
+                   (static_cast<std::size_t>(max_number) <= 4*vertex_numbers.size()+16));
+      if (use_table)
+        {
+          table.resize (max_number+1, numbers::invalid_unsigned_int);
+          for (unsigned int i=0; i<vertex_numbers.size(); ++i)
+            table[vertex_numbers[i]] = i;
+        }
+      else
+        for (unsigned int i=0; i<vertex_numbers.size(); ++i)
+          map[vertex_numbers[i]] = i;
+    }
+
+    /**
+     * Return the index of the vertex with the given number in the
+     * file, or numbers::invalid_unsigned_int if there is no such
+     * vertex.
+     */
+    unsigned int operator() (const int vertex_number) const
+    {
+      if (use_table)
+        return ((vertex_number >= 0) &&
+                (static_cast<std::size_t>(vertex_number) < table.size())
+                ?
+                table[vertex_number]
+                :
+                numbers::invalid_unsigned_int);
+
+      const std::map<int,unsigned int>::const_iterator p = map.find (vertex_number);
+      return (p != map.end() ? p->second : numbers::invalid_unsigned_int);
+    }
+
+  private:
+    bool                          use_table;
+    std::vector<unsigned int>     table;
+    std::map<int,unsigned int>    map;
+  };
+
+
+
+  /**
+   * Return the number of nodes of a Gmsh element of the given type, or
+   * zero if the type is not known. Besides the types deal.II can use,
+   * this also covers triangles and tetrahedra so that the error
+   * message for them can be more specific.
+   */
+  unsigned int gmsh_nodes_per_element (const unsigned int element_type)
+  {
+    switch (element_type)
+      {
+      case 1:  return 2;  // line
+      case 2:  return 3;  // triangle
+      case 3:  return 4;  // quadrilateral
+      case 4:  return 4;  // tetrahedron
+      case 5:  return 8;  // hexahedron
+      case 15: return 1;  // point
+      default: return 0;
+      }
+  }
+
+
+
+  /**
+   * Read @p n_bytes bytes of binary data from the given stream.
+   */
+  void read_binary (std::istream &in,
+                    void         *data,
+                    const std::size_t n_bytes)
+  {
+    in.read (static_cast<char *>(data), n_bytes);
+    AssertThrow (in, ExcIO());
+  }
+
+
+
+  /**
+   * Sort one element read from a Gmsh file into either the list of
+   * cells or the lists of boundary lines and quads, translating the
+   * vertex numbers of the file into consecutive indices. @p number is
+   * the position of the element in the file and is only used for
+   * error messages.
+   */
+  template <int dim>
+  void add_gmsh_element (const unsigned int        number,
+                         const unsigned int        element_type,
+                         const unsigned int        material_id,
+                         const int                *vertex_numbers,
+                         const unsigned int        n_vertices,
+                         const GmshVertexIndices  &vertex_indices,
+                         std::vector<CellData<dim> > &cells,
+                         SubCellData              &subcelldata)
+  {
+    /*       `ELM-TYPE'
+             defines the geometrical type of the N-th element:
+             `1'
+             Line (2 nodes, 1 edge).
+
+             `3'
+             Quadrangle (4 nodes, 4 edges).
+
+             `5'
+             Hexahedron (8 nodes, 12 edges, 6 faces).
+
+             `15'
+             Point (1 node).
+    */
+    if (((element_type == 1) && (dim == 1)) ||
+        ((element_type == 3) && (dim == 2)) ||
+        ((element_type == 5) && (dim == 3)))
+      // found a cell
+      {
+        AssertThrow (n_vertices == GeometryInfo<dim>::vertices_per_cell,
+                     ExcMessage ("Number of nodes does not coincide with the "
+                                 "number required for this object"));
+
+        // to make sure that the cast wont fail
+        Assert(material_id<= std::numeric_limits<types::material_id>::max(),
+               ExcIndexRange(material_id,0,std::numeric_limits<types::material_id>::max()));
+        // we use only material_ids in the range from 0 to numbers::invalid_material_id-1
+        Assert(material_id < numbers::invalid_material_id,
+               ExcIndexRange(material_id,0,numbers::invalid_material_id));
+
+        cells.push_back (CellData<dim>());
+        cells.back().material_id = static_cast<types::material_id>(material_id);
+
+        // transform from gmsh to consecutive numbering
+        for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
+          {
+            cells.back().vertices[i] = vertex_indices (vertex_numbers[i]);
+            AssertThrow (cells.back().vertices[i] != numbers::invalid_unsigned_int,
+                         typename GridIn<dim>::ExcInvalidVertexIndex(number, vertex_numbers[i]));
+          }
+      }
+    else if ((element_type == 1) && ((dim == 2) || (dim == 3)))
+      // boundary info
+      {
+        AssertThrow (n_vertices == 2,
+                     ExcMessage ("Number of nodes does not coincide with the "
+                                 "number required for this object"));
+
+        // to make sure that the cast wont fail
+        Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
+               ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
+        // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
+        Assert(material_id < numbers::internal_face_boundary_id,
+               ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
+
+        subcelldata.boundary_lines.push_back (CellData<1>());
+        subcelldata.boundary_lines.back().boundary_id
+          = static_cast<types::boundary_id>(material_id);
+
+        // transform from gmsh to consecutive numbering
+        for (unsigned int i=0; i<2; ++i)
+          {
+            subcelldata.boundary_lines.back().vertices[i] = vertex_indices (vertex_numbers[i]);
+            AssertThrow (subcelldata.boundary_lines.back().vertices[i] !=
+                         numbers::invalid_unsigned_int,
+                         typename GridIn<dim>::ExcInvalidVertexIndex(number, vertex_numbers[i]));
+          }
+      }
+    else if ((element_type == 3) && (dim == 3))
+      // boundary info
+      {
+        AssertThrow (n_vertices == 4,
+                     ExcMessage ("Number of nodes does not coincide with the "
+                                 "number required for this object"));
+
+        // to make sure that the cast wont fail
+        Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
+               ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
+        // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
+        Assert(material_id < numbers::internal_face_boundary_id,
+               ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
+
+        subcelldata.boundary_quads.push_back (CellData<2>());
+        subcelldata.boundary_quads.back().boundary_id
+          = static_cast<types::boundary_id>(material_id);
+
+        // transform from gmsh to consecutive numbering
+        for (unsigned int i=0; i<4; ++i)
+          {
+            subcelldata.boundary_quads.back().vertices[i] = vertex_indices (vertex_numbers[i]);
+            AssertThrow (subcelldata.boundary_quads.back().vertices[i] !=
+                         numbers::invalid_unsigned_int,
+                         typename GridIn<dim>::ExcInvalidVertexIndex(number, vertex_numbers[i]));
+          }
+      }
+    else if (element_type == 15)
+      {
+        // ignore vertices
+      }
+    else
+      // cannot read this, so throw an exception. treat triangles and
+      // tetrahedra specially since this deserves a more explicit
+      // error message
+      {
+        AssertThrow (element_type != 2,
+                     ExcMessage("Found triangles while reading a file "
+                                "in gmsh format. deal.II does not "
+                                "support triangles"));
+        AssertThrow ((element_type != 4) && (element_type != 11),
+                     ExcMessage("Found tetrahedra while reading a file "
+                                "in gmsh format. deal.II does not "
+                                "support tetrahedra"));
+
+        AssertThrow (false, typename GridIn<dim>::ExcGmshUnsupportedGeometry(element_type));
+      }
+  }
+}
+
+
+
 template <int dim, int spacedim>
 void GridIn<dim, spacedim>::read_msh (std::istream &in)
 {
@@ -1107,6 +1346,10 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   else
     AssertThrow (false, ExcInvalidGMSHInput(line));
 
+  // whether the nodes and elements are stored in binary form. this is
+  // only possible with format 2
+  bool binary = false;
+
   // if file format is 2 or greater
   // then we also have to read the
   // rest of the header
@@ -1117,10 +1360,28 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
 
       in >> version >> file_type >> data_size;
 
-      Assert ( (version >= 2.0) &&
-               (version <= 2.2), ExcNotImplemented());
-      Assert (file_type == 0, ExcNotImplemented());
-      Assert (data_size == sizeof(double), ExcNotImplemented());
+      AssertThrow ((version >= 2.0) &&
+                   (version < 3.0),
+                   ExcMessage ("Only version 2 of the Gmsh file format "
+                               "can be read. Please save the mesh in "
+                               "the version 2 format."));
+      AssertThrow ((file_type == 0) || (file_type == 1),
+                   ExcNotImplemented());
+      AssertThrow (data_size == sizeof(double), ExcNotImplemented());
+
+      binary = (file_type == 1);
+      if (binary)
+        {
+          // the header is followed by the integer one in binary form,
+          // which allows to detect a different byte order than ours
+          std::getline (in, line);
+          int one;
+          read_binary (in, &one, sizeof(one));
+          AssertThrow (one == 1,
+                       ExcMessage ("The binary Gmsh file was written with a "
+                                   "byte order different from the one of "
+                                   "this machine, which is not supported."));
+        }
 
       // read the end of the header
       // and the first line of the
@@ -1154,25 +1415,50 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   // now read the nodes list
   in >> n_vertices;
   std::vector<Point<spacedim> >     vertices (n_vertices);
-  // set up mapping between numbering
-  // in msh-file (nod) and in the
-  // vertices vector
-  std::map<int,int> vertex_indices;
+  // the numbers of the vertices in the msh-file, used to set up the
+  // mapping between these numbers and the indices into the vertices
+  // vector
+  std::vector<int> vertex_numbers (n_vertices);
 
-  for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+  if (binary)
     {
-      int vertex_number;
-      double x[3];
-
-      // read vertex
-      in >> vertex_number
-         >> x[0] >> x[1] >> x[2];
+      // each node is stored as its number followed by its three
+      // coordinates. read them all at once, then pick them apart
+      const std::size_t bytes_per_node = sizeof(int) + 3*sizeof(double);
+      std::vector<char> buffer (n_vertices * bytes_per_node);
+      std::getline (in, line);
+      if (buffer.size() > 0)
+        read_binary (in, &buffer[0], buffer.size());
+
+      for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+        {
+          const char *node = &buffer[vertex*bytes_per_node];
+          double x[3];
+          std::memcpy (&vertex_numbers[vertex], node, sizeof(int));
+          std::memcpy (x, node+sizeof(int), 3*sizeof(double));
 
-      for (unsigned int d=0; d<spacedim; ++d)
-        vertices[vertex](d) = x[d];
-      // store mapping
-      vertex_indices[vertex_number] = vertex;
+          for (unsigned int d=0; d<spacedim; ++d)
+            vertices[vertex](d) = x[d];
+        }
     }
+  else
+    for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+      {
+        double x[3];
+
+        // read vertex
+        in >> vertex_numbers[vertex]
+           >> x[0] >> x[1] >> x[2];
+
+        for (unsigned int d=0; d<spacedim; ++d)
+          vertices[vertex](d) = x[d];
+      }
+
+  // set up mapping between numbering
+  // in msh-file (nod) and in the
+  // vertices vector
+  GmshVertexIndices vertex_indices;
+  vertex_indices.initialize (vertex_numbers);
 
   // Assert we reached the end of the block
   in >> line;
@@ -1192,233 +1478,121 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   std::vector<CellData<dim> > cells;
   SubCellData                 subcelldata;
 
-  for (unsigned int cell=0; cell<n_cells; ++cell)
-    {
-      // note that since in the input
-      // file we found the number of
-      // cells at the top, there
-      // should still be input here,
-      // so check this:
-      AssertThrow (in, ExcIO());
-
-      unsigned int cell_type;
-      unsigned int material_id;
-      unsigned int nod_num;
-
-      /*
-        For file format version 1, the format of each cell is as follows:
-          elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
-
-        However, for version 2, the format reads like this:
-          elm-number elm-type number-of-tags < tag > ... node-number-list
-
-        In the following, we will ignore the element number (we simply enumerate
-        them in the order in which we read them, and we will take reg-phys
-        (version 1) or the first tag (version 2, if any tag is given at all) as
-        material id.
-      */
+  // the vertex numbers of the element just read
+  std::vector<int> element_vertices;
 
-      in >> dummy          // ELM-NUMBER
-         >> cell_type;     // ELM-TYPE
-
-      switch (gmsh_file_format)
-        {
-        case 1:
-        {
-          in >> material_id  // REG-PHYS
-             >> dummy        // reg_elm
-             >> nod_num;
-          break;
-        }
-
-        case 2:
-        {
-          // read the tags; ignore
-          // all but the first one
-          unsigned int n_tags;
-          in >> n_tags;
-          if (n_tags > 0)
-            in >> material_id;
-          else
-            material_id = 0;
-
-          for (unsigned int i=1; i<n_tags; ++i)
-            in >> dummy;
-
-          nod_num = GeometryInfo<dim>::vertices_per_cell;
-
-          break;
-        }
-
-        default:
-          AssertThrow (false, ExcNotImplemented());
-        }
-
-
-      /*       `ELM-TYPE'
-               defines the geometrical type of the N-th element:
-               `1'
-               Line (2 nodes, 1 edge).
-
-               `3'
-               Quadrangle (4 nodes, 4 edges).
-
-               `5'
-               Hexahedron (8 nodes, 12 edges, 6 faces).
-
-               `15'
-               Point (1 node).
-      */
-
-      if (((cell_type == 1) && (dim == 1)) ||
-          ((cell_type == 3) && (dim == 2)) ||
-          ((cell_type == 5) && (dim == 3)))
-        // found a cell
+  if (binary)
+    {
+      std::getline (in, line);
+
+      // in binary files, elements come in blocks of elements of the
+      // same type and with the same number of tags. each block starts
+      // with a header of three integers: the element type, the number
+      // of elements in the block, and the number of tags
+      std::vector<int> block;
+      unsigned int cell = 0;
+      while (cell < n_cells)
         {
-          AssertThrow (nod_num == GeometryInfo<dim>::vertices_per_cell,
-                       ExcMessage ("Number of nodes does not coincide with the "
-                                   "number required for this object"));
-
-          // allocate and read indices
-          cells.push_back (CellData<dim>());
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            in >> cells.back().vertices[i];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::material_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::material_id>::max()));
-          // we use only material_ids in the range from 0 to numbers::invalid_material_id-1
-          Assert(material_id < numbers::invalid_material_id,
-                 ExcIndexRange(material_id,0,numbers::invalid_material_id));
-
-          cells.back().material_id = static_cast<types::material_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
+          int header[3];
+          read_binary (in, header, sizeof(header));
+
+          const unsigned int element_type = header[0];
+          const unsigned int n_elements   = header[1];
+          const unsigned int n_tags       = header[2];
+          const unsigned int n_nodes      = gmsh_nodes_per_element (element_type);
+          AssertThrow (n_nodes > 0, ExcGmshUnsupportedGeometry(element_type));
+          AssertThrow (cell + n_elements <= n_cells, ExcIO());
+
+          // each element consists of its number, its tags and its nodes
+          const unsigned int ints_per_element = 1 + n_tags + n_nodes;
+          block.resize (n_elements * ints_per_element);
+          if (block.size() > 0)
+            read_binary (in, &block[0], block.size()*sizeof(int));
+
+          for (unsigned int e=0; e<n_elements; ++e, ++cell)
             {
-              AssertThrow (vertex_indices.find (cells.back().vertices[i]) !=
-                           vertex_indices.end(),
-                           ExcInvalidVertexIndex(cell, cells.back().vertices[i]));
-
-              // vertex with this index exists
-              cells.back().vertices[i] = vertex_indices[cells.back().vertices[i]];
+              const int *element = &block[e*ints_per_element];
+              // as in the ASCII case, the first tag is the material or
+              // boundary id
+              const unsigned int material_id = (n_tags > 0 ? element[1] : 0);
+              add_gmsh_element (cell, element_type, material_id,
+                                element + 1 + n_tags, n_nodes,
+                                vertex_indices, cells, subcelldata);
             }
         }
-      else if ((cell_type == 1) && ((dim == 2) || (dim == 3)))
-        // boundary info
-        {
-          subcelldata.boundary_lines.push_back (CellData<1>());
-          in >> subcelldata.boundary_lines.back().vertices[0]
-             >> subcelldata.boundary_lines.back().vertices[1];
+    }
+  else
+    for (unsigned int cell=0; cell<n_cells; ++cell)
+      {
+        // note that since in the input
+        // file we found the number of
+        // cells at the top, there
+        // should still be input here,
+        // so check this:
+        AssertThrow (in, ExcIO());
+
+        unsigned int cell_type;
+        unsigned int material_id;
+        unsigned int nod_num;
+
+        /*
+          For file format version 1, the format of each cell is as follows:
+            elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
+
+          However, for version 2, the format reads like this:
+            elm-number elm-type number-of-tags < tag > ... node-number-list
+
+          In the following, we will ignore the element number (we simply enumerate
+          them in the order in which we read them, and we will take reg-phys
+          (version 1) or the first tag (version 2, if any tag is given at all) as
+          material id.
+        */
+
+        in >> dummy          // ELM-NUMBER
+           >> cell_type;     // ELM-TYPE
+
+        switch (gmsh_file_format)
+          {
+          case 1:
+          {
+            in >> material_id  // REG-PHYS
+               >> dummy        // reg_elm
+               >> nod_num;
+            break;
+          }
 
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
+          case 2:
+          {
+            // read the tags; ignore
+            // all but the first one
+            unsigned int n_tags;
+            in >> n_tags;
+            if (n_tags > 0)
+              in >> material_id;
+            else
+              material_id = 0;
 
-          subcelldata.boundary_lines.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
+            for (unsigned int i=1; i<n_tags; ++i)
+              in >> dummy;
 
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<2; ++i)
-            if (vertex_indices.find (subcelldata.boundary_lines.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_lines.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_lines.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                AssertThrow (false,
-                             ExcInvalidVertexIndex(cell,
-                                                   subcelldata.boundary_lines.back().vertices[i]));
-                subcelldata.boundary_lines.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              };
-        }
-      else if ((cell_type == 3) && (dim == 3))
-        // boundary info
-        {
-          subcelldata.boundary_quads.push_back (CellData<2>());
-          in >> subcelldata.boundary_quads.back().vertices[0]
-             >> subcelldata.boundary_quads.back().vertices[1]
-             >> subcelldata.boundary_quads.back().vertices[2]
-             >> subcelldata.boundary_quads.back().vertices[3];
+            nod_num = gmsh_nodes_per_element (cell_type);
+            AssertThrow (nod_num > 0, ExcGmshUnsupportedGeometry(cell_type));
 
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
+            break;
+          }
 
-          subcelldata.boundary_quads.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
+          default:
+            AssertThrow (false, ExcNotImplemented());
+          }
 
-          // transform from gmsh to
-          // consecutive numbering
-          for (unsigned int i=0; i<4; ++i)
-            if (vertex_indices.find (subcelldata.boundary_quads.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_quads.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_quads.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                Assert (false,
-                        ExcInvalidVertexIndex(cell,
-                                              subcelldata.boundary_quads.back().vertices[i]));
-                subcelldata.boundary_quads.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              };
+        element_vertices.resize (nod_num);
+        for (unsigned int i=0; i<nod_num; ++i)
+          in >> element_vertices[i];
 
-        }
-      else if (cell_type == 15)
-        {
-          // Ignore vertices
-          // but read the
-          // number of nodes
-          // given
-          switch (gmsh_file_format)
-            {
-            case 1:
-            {
-              for (unsigned int i=0; i<nod_num; ++i)
-                in >> dummy;
-              break;
-            }
-            case 2:
-            {
-              in >> dummy;
-              break;
-            }
-            }
-        }
-      else
-        // cannot read this, so throw
-        // an exception. treat
-        // triangles and tetrahedra
-        // specially since this
-        // deserves a more explicit
-        // error message
-        {
-          AssertThrow (cell_type != 2,
-                       ExcMessage("Found triangles while reading a file "
-                                  "in gmsh format. deal.II does not "
-                                  "support triangles"));
-          AssertThrow (cell_type != 11,
-                       ExcMessage("Found tetrahedra while reading a file "
-                                  "in gmsh format. deal.II does not "
-                                  "support tetrahedra"));
-
-          AssertThrow (false, ExcGmshUnsupportedGeometry(cell_type));
-        }
-    };
+        add_gmsh_element (cell, cell_type, material_id,
+                          (nod_num > 0 ? &element_vertices[0] : 0), nod_num,
+                          vertex_indices, cells, subcelldata);
+      }
 
   // Assert we reached the end of the block
   in >> line;
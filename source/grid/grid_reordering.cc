@@ -19,9 +19,11 @@
 #include <deal.II/grid/grid_reordering_internal.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/std_cxx1x/bind.h>
 
 #include <algorithm>
+#include <numeric>
 #include <set>
 #include <iostream>
 #include <fstream>
@@ -86,6 +88,144 @@ GridReordering<1,3>::invert_all_cells_of_negative_grid(const std::vector<Point<3
 }
 
 
+template<>
+bool
+GridReordering<1>::is_consistent (const std::vector<CellData<1> > &,
+                                  const bool)
+{
+  // lines can always be combined
+  return true;
+}
+
+
+template<>
+bool
+GridReordering<1,2>::is_consistent (const std::vector<CellData<1> > &,
+                                    const bool)
+{
+  return true;
+}
+
+
+template<>
+bool
+GridReordering<1,3>::is_consistent (const std::vector<CellData<1> > &,
+                                    const bool)
+{
+  return true;
+}
+
+
+
+// anonymous namespace for the check whether all cells agree on the
+// direction of their common edges
+namespace
+{
+  /**
+   * One occurrence of an edge in a cell. It is stored with the smaller
+   * of the two vertices of the edge and records the other vertex, and
+   * whether the cell runs along the edge starting at the smaller
+   * vertex.
+   */
+  struct EdgeOccurrence
+  {
+    unsigned int other_vertex;
+    bool         forward;
+
+    bool operator < (const EdgeOccurrence &e) const
+    {
+      return ((other_vertex < e.other_vertex) ||
+              ((other_vertex == e.other_vertex) && (forward < e.forward)));
+    }
+  };
+
+
+
+  /**
+   * Sort the edge occurrences stored with the vertices
+   * <tt>[begin,end)</tt> and return the number of edges among them
+   * that are run along in both directions. Different vertices use
+   * disjoint parts of @p occurrences, so this function can work on
+   * different ranges of vertices in parallel.
+   */
+  unsigned int
+  count_conflicting_edges (const unsigned int               begin,
+                           const unsigned int               end,
+                           const std::vector<unsigned int> &bucket_start,
+                           std::vector<EdgeOccurrence>     &occurrences)
+  {
+    unsigned int n_conflicts = 0;
+    for (unsigned int v=begin; v<end; ++v)
+      {
+        std::vector<EdgeOccurrence>::iterator
+        first = occurrences.begin() + bucket_start[v],
+        last  = occurrences.begin() + bucket_start[v+1];
+        std::sort (first, last);
+
+        // after sorting, an edge that is run along in both directions
+        // shows up as two neighboring entries with the same other
+        // vertex but different directions
+        for (; (first != last) && (first+1 != last); ++first)
+          if ((first->other_vertex == (first+1)->other_vertex)
+              &&
+              (first->forward != (first+1)->forward))
+            ++n_conflicts;
+      }
+    return n_conflicts;
+  }
+
+
+
+  /**
+   * Return whether all cells that share an edge run along it in the
+   * same direction, where the direction of the edges of a cell is
+   * given by the pairs of local vertex numbers in @p local_edges. The
+   * occurrences of all edges are sorted into one bucket per vertex by
+   * a counting sort, and the buckets are then checked in parallel.
+   */
+  template <int dim>
+  bool
+  edges_are_consistent (const std::vector<CellData<dim> > &cells,
+                        const unsigned int               (*local_edges)[2],
+                        const unsigned int                 n_local_edges)
+  {
+    unsigned int n_vertices = 0;
+    for (unsigned int c=0; c<cells.size(); ++c)
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        n_vertices = std::max (n_vertices, cells[c].vertices[v]+1);
+
+    std::vector<unsigned int> bucket_start (n_vertices+1, 0);
+    for (unsigned int c=0; c<cells.size(); ++c)
+      for (unsigned int e=0; e<n_local_edges; ++e)
+        ++bucket_start[std::min (cells[c].vertices[local_edges[e][0]],
+                                 cells[c].vertices[local_edges[e][1]]) + 1];
+    std::partial_sum (bucket_start.begin(), bucket_start.end(),
+                      bucket_start.begin());
+
+    std::vector<EdgeOccurrence> occurrences (bucket_start.back());
+    std::vector<unsigned int> next_in_bucket (bucket_start.begin(),
+                                              bucket_start.end()-1);
+    for (unsigned int c=0; c<cells.size(); ++c)
+      for (unsigned int e=0; e<n_local_edges; ++e)
+        {
+          const unsigned int v0 = cells[c].vertices[local_edges[e][0]],
+                             v1 = cells[c].vertices[local_edges[e][1]];
+          EdgeOccurrence &occurrence = occurrences[next_in_bucket[std::min(v0,v1)]++];
+          occurrence.other_vertex = std::max (v0, v1);
+          occurrence.forward      = (v0 < v1);
+        }
+
+    return (parallel::accumulate_from_subranges<unsigned int>
+            (std_cxx1x::bind (&count_conflicting_edges,
+                              std_cxx1x::_1, std_cxx1x::_2,
+                              std_cxx1x::cref(bucket_start),
+                              std_cxx1x::ref(occurrences)),
+             0U, n_vertices, 1024)
+            == 0);
+  }
+}
+
+
 namespace internal
 {
   namespace GridReordering2d
@@ -101,72 +241,15 @@ namespace internal
     {{0,1},{1,2},{3,2},{0,3}};
 
 
-    /**
-     * Simple data structure denoting
-     * an edge, i.e. the ordered pair
-     * of its vertices. This is only
-     * used in the is_consistent
-     * function.
-     */
-    struct Edge
-    {
-      Edge (const unsigned int v0,
-            const unsigned int v1)
-        :
-        v0(v0), v1(v1)
-      {}
-
-      const unsigned int v0, v1;
-      bool operator < (const Edge &e) const
-      {
-        return ((v0 < e.v0) || ((v0 == e.v0) && (v1 < e.v1)));
-      }
-    };
-
-
     bool
     is_consistent  (const std::vector<CellData<2> > &cells)
     {
-      std::set<Edge> edges;
-
-      std::vector<CellData<2> >::const_iterator c = cells.begin();
-      for (; c != cells.end(); ++c)
-        {
-          // construct the four edges
-          // in reverse order
-          const Edge reverse_edges[4] = { Edge (c->vertices[1],
-                                                c->vertices[0]),
-                                          Edge (c->vertices[2],
-                                                c->vertices[1]),
-                                          Edge (c->vertices[2],
-                                                c->vertices[3]),
-                                          Edge (c->vertices[3],
-                                                c->vertices[0])
-                                        };
-          // for each of them, check
-          // whether they are already
-          // in the set
-          if ((edges.find (reverse_edges[0]) != edges.end()) ||
-              (edges.find (reverse_edges[1]) != edges.end()) ||
-              (edges.find (reverse_edges[2]) != edges.end()) ||
-              (edges.find (reverse_edges[3]) != edges.end()))
-            return false;
-          // ok, not. insert them
-          // in the order in which
-          // we want them
-          // (std::set eliminates
-          // duplicated by itself)
-          for (unsigned int i = 0; i<4; ++i)
-            {
-              const Edge e(reverse_edges[i].v1, reverse_edges[i].v0);
-              edges.insert (e);
-            }
-          // then go on with next
-          // cell
-        }
-      // no conflicts found, so
-      // return true
-      return true;
+      // the edges of a cell, in the
+      // direction in which we want
+      // them
+      static const unsigned int edges[GeometryInfo<2>::lines_per_cell][2]
+        = { {0,1}, {1,2}, {3,2}, {0,3} };
+      return edges_are_consistent (cells, edges, GeometryInfo<2>::lines_per_cell);
     }
 
 
@@ -720,6 +803,33 @@ GridReordering<2,3>::reorder_cells (std::vector<CellData<2> > &cells,
 
 
 
+template<>
+bool
+GridReordering<2>::is_consistent (const std::vector<CellData<2> > &cells,
+                                  const bool use_new_style_ordering)
+{
+  if (!use_new_style_ordering)
+    return internal::GridReordering2d::is_consistent (cells);
+
+  // in the new style, vertices 2
+  // and 3 are swapped
+  static const unsigned int edges[GeometryInfo<2>::lines_per_cell][2]
+    = { {0,1}, {1,3}, {2,3}, {0,2} };
+  return edges_are_consistent (cells, edges, GeometryInfo<2>::lines_per_cell);
+}
+
+
+
+template<>
+bool
+GridReordering<2,3>::is_consistent (const std::vector<CellData<2> > &cells,
+                                    const bool use_new_style_ordering)
+{
+  return GridReordering<2>::is_consistent (cells, use_new_style_ordering);
+}
+
+
+
 template<>
 void
 GridReordering<2>::invert_all_cells_of_negative_grid(const std::vector<Point<2> > &all_vertices,
@@ -1023,10 +1133,34 @@ namespace internal
       // Correctly build the edge
       // list
       {
-        // edge_map stores the
-        // edge_number associated
-        // with a given CheapEdge
-        std::map<CheapEdge,unsigned int> edge_map;
+        // the edges are stored with
+        // the smaller of their two
+        // vertices, each vertex
+        // having a bucket of pairs
+        // of the other vertex and
+        // the edge number. first
+        // find out how large each
+        // bucket can get, then
+        // allocate all buckets in
+        // one array
+        unsigned int n_vertices = 0;
+        for (unsigned int c=0; c<n_cells; ++c)
+          for (unsigned int v=0; v<GeometryInfo<3>::vertices_per_cell; ++v)
+            n_vertices = std::max (n_vertices, cell_list[c].nodes[v]+1);
+
+        std::vector<unsigned int> bucket_start (n_vertices+1, 0);
+        for (unsigned int c=0; c<n_cells; ++c)
+          for (unsigned int e=0; e<GeometryInfo<3>::lines_per_cell; ++e)
+            ++bucket_start[std::min (cell_list[c].nodes[ElementInfo::nodes_on_edge[e][0]],
+                                     cell_list[c].nodes[ElementInfo::nodes_on_edge[e][1]])
+                           + 1];
+        std::partial_sum (bucket_start.begin(), bucket_start.end(),
+                          bucket_start.begin());
+
+        std::vector<std::pair<unsigned int,unsigned int> >
+        edges_at_vertex (bucket_start.back());
+        std::vector<unsigned int> bucket_size (n_vertices, 0);
+
         unsigned int ctr = 0;
         for (unsigned int cur_cell_id = 0;
              cur_cell_id<n_cells;
@@ -1051,13 +1185,24 @@ namespace internal
                 node1 = cur_cell.nodes[ElementInfo::nodes_on_edge[edge_num][1]];
                 const CheapEdge cur_edge (node0, node1);
 
-                if (edge_map.count(cur_edge) == 0)
-                  // Edge not in map
+                // look the edge up in
+                // the bucket of its
+                // smaller vertex
+                const unsigned int bucket = bucket_start[cur_edge.node0];
+                unsigned int position = 0;
+                for (; position<bucket_size[cur_edge.node0]; ++position)
+                  if (edges_at_vertex[bucket+position].first == cur_edge.node1)
+                    break;
+
+                if (position == bucket_size[cur_edge.node0])
+                  // Edge not yet seen
                   {
                     // put edge in
-                    // hash map with
+                    // the bucket with
                     // ctr value;
-                    edge_map[cur_edge] = ctr;
+                    edges_at_vertex[bucket+position]
+                      = std::make_pair (cur_edge.node1, ctr);
+                    ++bucket_size[cur_edge.node0];
                     gl_edge_num = ctr;
 
                     // put the edge
@@ -1070,8 +1215,8 @@ namespace internal
                 else
                   {
                     // get edge_num
-                    // from hash_map
-                    gl_edge_num = edge_map[cur_edge];
+                    // from the bucket
+                    gl_edge_num = edges_at_vertex[bucket+position].second;
                     if (edge_list[gl_edge_num].nodes[0] != node0)
                       l_edge_orient = backward_edge;
                   }
@@ -1641,20 +1786,27 @@ GridReordering<3>::reorder_cells (std::vector<CellData<3> > &cells,
   if (use_new_style_ordering)
     reorder_new_to_old_style(cells);
 
-  // create a backup to use if GridReordering
-  // was not successful
-  std::vector<CellData<3> > backup=cells;
-
-  // This does the real work
-  const bool success=
-    internal::GridReordering3d::Orienter::orient_mesh (cells);
-
-  // if reordering was not successful use
-  // original connectivity, otherwise do
-  // nothing (i.e. use the reordered
-  // connectivity)
-  if (!success)
-    cells=backup;
+  // check whether the cells are
+  // already consistently
+  // oriented. if so, there is
+  // nothing to do
+  if (!is_consistent (cells, false))
+    {
+      // create a backup to use if GridReordering
+      // was not successful
+      std::vector<CellData<3> > backup=cells;
+
+      // This does the real work
+      const bool success=
+        internal::GridReordering3d::Orienter::orient_mesh (cells);
+
+      // if reordering was not successful use
+      // original connectivity, otherwise do
+      // nothing (i.e. use the reordered
+      // connectivity)
+      if (!success)
+        cells=backup;
+    }
 
   // and convert back if necessary
   if (use_new_style_ordering)
@@ -1663,6 +1815,31 @@ GridReordering<3>::reorder_cells (std::vector<CellData<3> > &cells,
 
 
 
+template<>
+bool
+GridReordering<3>::is_consistent (const std::vector<CellData<3> > &cells,
+                                  const bool use_new_style_ordering)
+{
+  // the edges of a cell in the
+  // direction in which we want
+  // them, translated to the new
+  // style numbering if necessary
+  unsigned int edges[GeometryInfo<3>::lines_per_cell][2];
+  for (unsigned int e=0; e<GeometryInfo<3>::lines_per_cell; ++e)
+    for (unsigned int i=0; i<2; ++i)
+      {
+        const unsigned int
+        vertex = internal::GridReordering3d::ElementInfo::nodes_on_edge[e][i];
+        edges[e][i] = (use_new_style_ordering ?
+                       GeometryInfo<3>::ucd_to_deal[vertex] :
+                       vertex);
+      }
+
+  return edges_are_consistent (cells, edges, GeometryInfo<3>::lines_per_cell);
+}
+
+
+
 template<>
 void
 GridReordering<3>::invert_all_cells_of_negative_grid(
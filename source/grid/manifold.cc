@@ -27,21 +27,13 @@ DEAL_II_NAMESPACE_OPEN
 namespace Manifolds
 {
 
-  Quadrature<3>
-  get_default_quadrature(const TriaIterator<CellAccessor<3, 3> > &obj)
+  unsigned int
+  get_default_points_and_weights(const TriaIterator<CellAccessor<3, 3> > &obj,
+                                 Point<3> *sp,
+                                 double   *wp)
   {
-    std::vector<Point<3> > sp;
-    std::vector<double> wp;
-
     const int dim = 3;
 
-    const unsigned int np =
-      GeometryInfo<dim>::vertices_per_cell+
-      GeometryInfo<dim>::lines_per_cell+
-      GeometryInfo<dim>::faces_per_cell;
-
-    sp.resize(np);
-    wp.resize(np);
     unsigned int j=0;
 
     // note that the exact weights are chosen such as to minimize the
@@ -65,7 +57,21 @@ namespace Manifolds
                  obj->face(i)->get_manifold().get_new_point_on_face(obj->face(i)));
         wp[j] = 1.0/12.0;
       }
-    return Quadrature<3>(sp,wp);
+    Assert (j == max_default_points, ExcInternalError());
+    return j;
+  }
+
+
+
+  Quadrature<3>
+  get_default_quadrature(const TriaIterator<CellAccessor<3, 3> > &obj)
+  {
+    Point<3> sp[max_default_points];
+    double   wp[max_default_points];
+    const unsigned int n_points = get_default_points_and_weights(obj, sp, wp);
+
+    return Quadrature<3>(std::vector<Point<3> >(sp, sp+n_points),
+                         std::vector<double>(wp, wp+n_points));
   }
 
 }
@@ -75,6 +81,15 @@ using namespace Manifolds;
 /* -------------------------- Manifold --------------------- */
 
 
+template <int dim, int spacedim>
+Manifold<dim, spacedim>::Manifold ()
+  :
+  use_array_interface (false),
+  thread_safe (false)
+{}
+
+
+
 template <int dim, int spacedim>
 Manifold<dim, spacedim>::~Manifold ()
 {}
@@ -116,14 +131,52 @@ get_new_point (const Quadrature<spacedim> &quad) const
 }
 
 
+
+template <int dim, int spacedim>
+Point<spacedim>
+Manifold<dim, spacedim>::
+get_new_point (const Point<spacedim> *surrounding_points,
+               const double          *weights,
+               const unsigned int     n_points) const
+{
+  return get_new_point (Quadrature<spacedim>
+                        (std::vector<Point<spacedim> >(surrounding_points,
+                                                       surrounding_points+n_points),
+                         std::vector<double>(weights, weights+n_points)));
+}
+
+
+
+template <int dim, int spacedim>
+void
+Manifold<dim, spacedim>::
+get_new_points (const std::vector<Point<spacedim> > &surrounding_points,
+                const Table<2,double>               &weights,
+                std::vector<Point<spacedim> >       &new_points) const
+{
+  AssertDimension (weights.size(1), surrounding_points.size());
+  Assert (surrounding_points.size() > 0, ExcEmptyObject());
+
+  new_points.resize (weights.size(0));
+  for (unsigned int i=0; i<weights.size(0); ++i)
+    new_points[i] = get_new_point (&surrounding_points[0], &weights[i][0],
+                                   surrounding_points.size());
+}
+
+
+
 template <int dim, int spacedim>
 Point<spacedim>
 Manifold<dim, spacedim>::
 get_new_point_on_line (const typename Triangulation<dim, spacedim>::line_iterator &line) const
 {
-  return get_new_point
-         (get_default_quadrature<const typename Triangulation<dim, spacedim>::line_iterator,
-          spacedim>(line, false));
+  Point<spacedim> points[max_default_points];
+  double          weights[max_default_points];
+  const unsigned int n_points
+    = get_default_points_and_weights<const typename Triangulation<dim, spacedim>::line_iterator,
+      spacedim>(line, points, weights, false);
+
+  return get_new_point (points, weights, n_points);
 }
 
 
@@ -133,9 +186,13 @@ Point<spacedim>
 Manifold<dim, spacedim>::
 get_new_point_on_quad (const typename Triangulation<dim, spacedim>::quad_iterator &quad) const
 {
-  return get_new_point
-         (get_default_quadrature<const typename Triangulation<dim, spacedim>::quad_iterator,
-          spacedim>(quad, false));
+  Point<spacedim> points[max_default_points];
+  double          weights[max_default_points];
+  const unsigned int n_points
+    = get_default_points_and_weights<const typename Triangulation<dim, spacedim>::quad_iterator,
+      spacedim>(quad, points, weights, false);
+
+  return get_new_point (points, weights, n_points);
 }
 
 
@@ -178,6 +235,15 @@ get_new_point_on_cell (const typename Triangulation<dim,spacedim>::cell_iterator
 }
 
 
+
+template <int dim, int spacedim>
+bool
+Manifold<dim, spacedim>::is_thread_safe () const
+{
+  return thread_safe;
+}
+
+
 template <>
 Point<1>
 Manifold<1,1>::
@@ -251,7 +317,11 @@ Point<3>
 Manifold<3,3>::
 get_new_point_on_hex (const typename Triangulation<3, 3>::hex_iterator &hex) const
 {
-  return get_new_point(get_default_quadrature(hex));
+  Point<3> points[max_default_points];
+  double   weights[max_default_points];
+  const unsigned int n_points = get_default_points_and_weights(hex, points, weights);
+
+  return get_new_point (points, weights, n_points);
 }
 
 
@@ -263,7 +333,9 @@ FlatManifold<dim,spacedim>::FlatManifold (const Point<spacedim> periodicity,
                                           const double tolerance) :
   periodicity(periodicity),
   tolerance(tolerance)
-{}
+{
+  this->thread_safe = true;
+}
 
 template <int dim, int spacedim>
 Point<spacedim>
@@ -271,11 +343,42 @@ FlatManifold<dim, spacedim>::
 get_new_point (const Quadrature<spacedim> &quad) const
 {
   const std::vector<Point<spacedim> > &surrounding_points = quad.get_points();
-  const std::vector<double> &weights = quad.get_weights();
+  const Point<spacedim> p = compute_weighted_average (&surrounding_points[0],
+                                                      &quad.get_weights()[0],
+                                                      quad.size());
+  return project_to_manifold(surrounding_points, p);
+}
+
+
+
+template <int dim, int spacedim>
+Point<spacedim>
+FlatManifold<dim, spacedim>::
+get_new_point (const Point<spacedim> *surrounding_points,
+               const double          *weights,
+               const unsigned int     n_points) const
+{
+  // unless a derived class has declared that the projection is the
+  // identity, go through the Quadrature variant of this function, which
+  // may have been overloaded
+  if (this->use_array_interface == false)
+    return Manifold<dim,spacedim>::get_new_point (surrounding_points, weights, n_points);
+
+  return compute_weighted_average (surrounding_points, weights, n_points);
+}
+
 
+
+template <int dim, int spacedim>
+Point<spacedim>
+FlatManifold<dim, spacedim>::
+compute_weighted_average (const Point<spacedim> *surrounding_points,
+                          const double          *weights,
+                          const unsigned int     n_points) const
+{
 #ifdef DEBUG
   double sum=0;
-  for (unsigned int i=0; i<weights.size(); ++i)
+  for (unsigned int i=0; i<n_points; ++i)
     sum+= weights[i];
   // Here it is correct to use tolerance as an absolute one, since
   // this should be relative to unity.
@@ -288,7 +391,7 @@ get_new_point (const Quadrature<spacedim> &quad) const
   Point<spacedim> minP = periodicity;
   const bool check_period = (periodicity.norm() > tolerance);
   if (check_period)
-    for (unsigned int i=0; i<surrounding_points.size(); ++i)
+    for (unsigned int i=0; i<n_points; ++i)
       for (unsigned int d=0; d<spacedim; ++d)
         {
           minP[d] = std::min(minP[d], surrounding_points[i][d]);
@@ -298,7 +401,7 @@ get_new_point (const Quadrature<spacedim> &quad) const
                     ExcPeriodicBox(d, surrounding_points[i], periodicity, tolerance*periodicity.norm()));
         }
 
-  for (unsigned int i=0; i<surrounding_points.size(); ++i)
+  for (unsigned int i=0; i<n_points; ++i)
     {
       dp = Point<spacedim>();
       if (check_period)
@@ -315,9 +418,10 @@ get_new_point (const Quadrature<spacedim> &quad) const
       if (periodicity[d] > 0)
         p[d] = (p[d] < 0 ? p[d] + periodicity[d] : p[d]);
 
-  return project_to_manifold(surrounding_points, p);
+  return p;
 }
 
+
 template <int dim, int spacedim>
 Point<spacedim>
 FlatManifold<dim, spacedim>::project_to_manifold (const std::vector<Point<spacedim> > &vertices,
@@ -344,21 +448,113 @@ Point<spacedim>
 ChartManifold<dim,spacedim,chartdim>::
 get_new_point (const Quadrature<spacedim> &quad) const
 {
-  const std::vector<Point<spacedim> > &surrounding_points = quad.get_points();
-  const std::vector<double> &weights = quad.get_weights();
-  std::vector<Point<chartdim> > chart_points(surrounding_points.size());
+  return compute_new_point (&quad.get_points()[0], &quad.get_weights()[0], quad.size());
+}
 
-  for (unsigned int i=0; i<surrounding_points.size(); ++i)
-    chart_points[i] = pull_back(surrounding_points[i]);
 
-  const Quadrature<chartdim> chart_quad(chart_points, weights);
-  const Point<chartdim> p_chart = sub_manifold.get_new_point(chart_quad);
+
+template <int dim, int spacedim, int chartdim>
+Point<spacedim>
+ChartManifold<dim,spacedim,chartdim>::
+get_new_point (const Point<spacedim> *surrounding_points,
+               const double          *weights,
+               const unsigned int     n_points) const
+{
+  if (this->use_array_interface == false)
+    return Manifold<dim,spacedim>::get_new_point (surrounding_points, weights, n_points);
+
+  return compute_new_point (surrounding_points, weights, n_points);
+}
+
+
+
+template <int dim, int spacedim, int chartdim>
+Point<spacedim>
+ChartManifold<dim,spacedim,chartdim>::
+compute_new_point (const Point<spacedim> *surrounding_points,
+                   const double          *weights,
+                   const unsigned int     n_points) const
+{
+  // keep the pulled back points on the stack unless there are too many
+  Point<chartdim> stack_chart_points[max_stack_points];
+  std::vector<Point<chartdim> > heap_chart_points;
+  Point<chartdim> *chart_points = stack_chart_points;
+  if (n_points > max_stack_points)
+    {
+      heap_chart_points.resize (n_points);
+      chart_points = &heap_chart_points[0];
+    }
+
+  pull_back_points (surrounding_points, n_points, chart_points);
+
+  const Point<chartdim> p_chart = sub_manifold.compute_weighted_average(chart_points,
+                                                                        weights,
+                                                                        n_points);
 
   return push_forward(p_chart);
 }
 
 
 
+template <int dim, int spacedim, int chartdim>
+void
+ChartManifold<dim,spacedim,chartdim>::
+get_new_points (const std::vector<Point<spacedim> > &surrounding_points,
+                const Table<2,double>               &weights,
+                std::vector<Point<spacedim> >       &new_points) const
+{
+  if (this->use_array_interface == false)
+    {
+      Manifold<dim,spacedim>::get_new_points (surrounding_points, weights, new_points);
+      return;
+    }
+
+  AssertDimension (weights.size(1), surrounding_points.size());
+  Assert (surrounding_points.size() > 0, ExcEmptyObject());
+
+  const unsigned int n_points = surrounding_points.size();
+  std::vector<Point<chartdim> > chart_points (n_points);
+  pull_back_points (&surrounding_points[0], n_points, &chart_points[0]);
+
+  std::vector<Point<chartdim> > new_chart_points (weights.size(0));
+  for (unsigned int i=0; i<weights.size(0); ++i)
+    new_chart_points[i] = sub_manifold.compute_weighted_average (&chart_points[0],
+                                                                 &weights[i][0],
+                                                                 n_points);
+
+  new_points.resize (weights.size(0));
+  if (new_points.size() > 0)
+    push_forward_points (&new_chart_points[0], new_chart_points.size(), &new_points[0]);
+}
+
+
+
+template <int dim, int spacedim, int chartdim>
+void
+ChartManifold<dim,spacedim,chartdim>::
+pull_back_points (const Point<spacedim> *space_points,
+                  const unsigned int     n_points,
+                  Point<chartdim>       *chart_points) const
+{
+  for (unsigned int i=0; i<n_points; ++i)
+    chart_points[i] = pull_back(space_points[i]);
+}
+
+
+
+template <int dim, int spacedim, int chartdim>
+void
+ChartManifold<dim,spacedim,chartdim>::
+push_forward_points (const Point<chartdim> *chart_points,
+                     const unsigned int     n_points,
+                     Point<spacedim>       *space_points) const
+{
+  for (unsigned int i=0; i<n_points; ++i)
+    space_points[i] = push_forward(chart_points[i]);
+}
+
+
+
 
 
 
@@ -30,6 +30,8 @@ SphericalManifold<dim,spacedim>::SphericalManifold(const Point<spacedim> center)
   center(center)
 {
   Assert(spacedim != 1, ExcImpossibleInDim(1));
+  this->use_array_interface = true;
+  this->thread_safe = true;
 }
 
 
@@ -47,17 +49,47 @@ SphericalManifold<dim,spacedim>::get_periodicity()
 template <int dim, int spacedim>
 Point<spacedim>
 SphericalManifold<dim,spacedim>::get_new_point(const Quadrature<spacedim> &quad) const
+{
+  return compute_new_point(&quad.get_points()[0], &quad.get_weights()[0], quad.size());
+}
+
+
+
+template <int dim, int spacedim>
+Point<spacedim>
+SphericalManifold<dim,spacedim>::
+get_new_point(const Point<spacedim> *surrounding_points,
+              const double          *weights,
+              const unsigned int     n_points) const
+{
+  // a derived class that overrides the Quadrature variant has reset
+  // the flag, so let the base class route the call there
+  if (this->use_array_interface == false)
+    return Manifold<dim,spacedim>::get_new_point(surrounding_points,
+                                                 weights, n_points);
+  return compute_new_point(surrounding_points, weights, n_points);
+}
+
+
+
+template <int dim, int spacedim>
+Point<spacedim>
+SphericalManifold<dim,spacedim>::
+compute_new_point(const Point<spacedim> *surrounding_points,
+                  const double          *weights,
+                  const unsigned int     n_points) const
 {
   if (spacedim == 2)
-    return ChartManifold<dim,spacedim,spacedim>::get_new_point(quad);
+    return ChartManifold<dim,spacedim,spacedim>::compute_new_point(surrounding_points,
+        weights, n_points);
   else
     {
       double rho_average = 0;
       Point<spacedim> mid_point;
-      for (unsigned int i=0; i<quad.size(); ++i)
+      for (unsigned int i=0; i<n_points; ++i)
         {
-          rho_average += quad.weight(i)*(quad.point(i)-center).norm();
-          mid_point += quad.weight(i)*quad.point(i);
+          rho_average += weights[i]*(surrounding_points[i]-center).norm();
+          mid_point += weights[i]*surrounding_points[i];
         }
       // Project the mid_pont back to the right location
       Point<spacedim> R = mid_point-center;
@@ -70,6 +102,23 @@ SphericalManifold<dim,spacedim>::get_new_point(const Quadrature<spacedim> &quad)
 
 
 
+template <int dim, int spacedim>
+void
+SphericalManifold<dim,spacedim>::
+get_new_points(const std::vector<Point<spacedim> > &surrounding_points,
+               const Table<2,double>               &weights,
+               std::vector<Point<spacedim> >       &new_points) const
+{
+  if (spacedim == 2)
+    ChartManifold<dim,spacedim,spacedim>::get_new_points(surrounding_points,
+                                                         weights, new_points);
+  else
+    Manifold<dim,spacedim>::get_new_points(surrounding_points,
+                                           weights, new_points);
+}
+
+
+
 template <int dim, int spacedim>
 Point<spacedim>
 SphericalManifold<dim,spacedim>::push_forward(const Point<spacedim> &spherical_point) const
@@ -148,6 +197,8 @@ CylindricalManifold<dim,spacedim>::CylindricalManifold(const unsigned int axis,
   tolerance(tolerance)
 {
   Assert(spacedim > 1, ExcImpossibleInDim(1));
+  this->use_array_interface = true;
+  this->thread_safe = true;
 }
 
 
@@ -160,6 +211,8 @@ CylindricalManifold<dim,spacedim>::CylindricalManifold(const Point<spacedim> &di
   tolerance(tolerance)
 {
   Assert(spacedim > 2, ExcImpossibleInDim(spacedim));
+  this->use_array_interface = true;
+  this->thread_safe = true;
 }
 
 
@@ -170,17 +223,42 @@ Point<spacedim>
 CylindricalManifold<dim,spacedim>::
 get_new_point (const Quadrature<spacedim> &quad) const
 {
-  const std::vector<Point<spacedim> > &surrounding_points = quad.get_points();
-  const std::vector<double> &weights = quad.get_weights();
+  return compute_new_point(&quad.get_points()[0], &quad.get_weights()[0], quad.size());
+}
+
+
+
+template <int dim, int spacedim>
+Point<spacedim>
+CylindricalManifold<dim,spacedim>::
+get_new_point (const Point<spacedim> *surrounding_points,
+               const double          *weights,
+               const unsigned int     n_points) const
+{
+  if (this->use_array_interface == false)
+    return Manifold<dim,spacedim>::get_new_point(surrounding_points,
+                                                 weights, n_points);
+  return compute_new_point(surrounding_points, weights, n_points);
+}
+
 
-  // compute a proposed new point
-  Point<spacedim> middle = flat_manifold.get_new_point(quad);
 
+template <int dim, int spacedim>
+Point<spacedim>
+CylindricalManifold<dim,spacedim>::
+compute_new_point (const Point<spacedim> *surrounding_points,
+                   const double          *weights,
+                   const unsigned int     n_points) const
+{
+  // compute a proposed new point as the weighted average of the
+  // surrounding points, and the average distance from the axis
+  Point<spacedim> middle;
   double radius = 0;
   Point<spacedim> on_plane;
 
-  for (unsigned int i=0; i<surrounding_points.size(); ++i)
+  for (unsigned int i=0; i<n_points; ++i)
     {
+      middle += weights[i] * surrounding_points[i];
       on_plane = surrounding_points[i]-point_on_axis;
       on_plane = on_plane - (on_plane*direction) * direction;
       radius += weights[i]*on_plane.norm();
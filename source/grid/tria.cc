@@ -16,9 +16,12 @@
 
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/flat_binary_archive.h>
+#include <deal.II/base/utilities.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/std_cxx1x/bind.h>
+#include <deal.II/base/parallel.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_levels.h>
@@ -3955,11 +3958,14 @@ namespace internal
             if (dim == spacedim)
               {
                 // triangulation.vertices[next_unused_vertex] = new_point;
+                Point<spacedim> points[Manifolds::max_default_points];
+                double          weights[Manifolds::max_default_points];
+                const unsigned int n_points
+                  = Manifolds::get_default_points_and_weights
+                    <typename Triangulation<dim,spacedim>::active_cell_iterator,
+                    spacedim>(cell, points, weights);
                 triangulation.vertices[next_unused_vertex] =
-                  cell->get_manifold().get_new_point
-                  (Manifolds::get_default_quadrature
-                   <typename Triangulation<dim,spacedim>::active_cell_iterator,
-                   spacedim>(cell));
+                  cell->get_manifold().get_new_point (points, weights, n_points);
 
                 // if the user_flag is set, i.e. if the
                 // cell is at the boundary, use a
@@ -4285,6 +4291,162 @@ namespace internal
 
 
 
+      /**
+       * Compute the location of the
+       * new vertex in the middle of
+       * each of the lines with indices
+       * <code>[begin,end)</code> in the
+       * given array. This is the
+       * worker function for
+       * compute_new_points_on_lines().
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      compute_new_points_on_line_range (const unsigned int begin,
+                                        const unsigned int end,
+                                        const Triangulation<dim,spacedim> &triangulation,
+                                        const std::vector<typename Triangulation<dim,spacedim>::line_iterator> &lines,
+                                        std::vector<Point<spacedim> > &new_points)
+      {
+        for (unsigned int i=begin; i<end; ++i)
+          {
+            const typename Triangulation<dim,spacedim>::line_iterator &line = lines[i];
+            if ((spacedim == dim) ||
+                (line->manifold_id() != numbers::invalid_manifold_id))
+              new_points[i] = line->get_manifold().get_new_point_on_line (line);
+            else
+              // if spacedim>dim and no
+              // manifold_id is set on this
+              // very line, use the manifold
+              // that was stored in
+              // line->user_index() when
+              // flagging the line
+              new_points[i] = triangulation.get_manifold(line->user_index())
+                              .get_new_point_on_line (line);
+          }
+      }
+
+
+
+      /**
+       * Compute the location of the
+       * new vertex in the middle of
+       * every active line that has its
+       * user flag set, i.e. that is
+       * going to be refined, in the
+       * order of the active line
+       * iterators. This is done
+       * before the serial loop that
+       * actually creates the children
+       * of the lines, in parallel if
+       * all the manifolds involved
+       * are thread safe (see
+       * Manifold::is_thread_safe())
+       * and one line after the other
+       * otherwise.
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      compute_new_points_on_lines (const Triangulation<dim,spacedim> &triangulation,
+                                   std::vector<Point<spacedim> > &new_points)
+      {
+        std::vector<typename Triangulation<dim,spacedim>::line_iterator> lines;
+        bool thread_safe = true;
+        for (typename Triangulation<dim,spacedim>::active_line_iterator
+             line=triangulation.begin_active_line(); line!=triangulation.end_line(); ++line)
+          if (line->user_flag_set())
+            {
+              lines.push_back (line);
+
+              // use the same manifold as
+              // compute_new_points_on_line_range()
+              const Manifold<dim,spacedim> &manifold
+                = (((spacedim == dim) ||
+                    (line->manifold_id() != numbers::invalid_manifold_id))
+                   ?
+                   line->get_manifold()
+                   :
+                   triangulation.get_manifold(line->user_index()));
+              if (manifold.is_thread_safe() == false)
+                thread_safe = false;
+            }
+
+        new_points.resize (lines.size());
+        if (thread_safe)
+          parallel::apply_to_subranges
+          (0U, lines.size(),
+           std_cxx1x::bind (&compute_new_points_on_line_range<dim,spacedim>,
+                            std_cxx1x::_1, std_cxx1x::_2,
+                            std_cxx1x::cref(triangulation),
+                            std_cxx1x::cref(lines),
+                            std_cxx1x::ref(new_points)),
+           64);
+        else
+          compute_new_points_on_line_range<dim,spacedim> (0, lines.size(),
+                                                          triangulation,
+                                                          lines, new_points);
+      }
+
+
+
+      /**
+       * For the cells with indices
+       * <code>[begin,end)</code> in the
+       * given array, note whether any
+       * of their children is
+       * distorted. This is the worker
+       * function for
+       * collect_cells_with_distorted_children().
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      check_children_for_distortion (const unsigned int begin,
+                                     const unsigned int end,
+                                     const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                                     std::vector<unsigned char> &distorted)
+      {
+        for (unsigned int i=begin; i<end; ++i)
+          distorted[i] = has_distorted_children (cells[i],
+                                                 internal::int2type<dim>(),
+                                                 internal::int2type<spacedim>());
+      }
+
+
+
+      /**
+       * Of the given list of refined
+       * cells, add those with
+       * distorted children to the
+       * list in the last argument,
+       * in the order in which they
+       * are given. The cells are
+       * checked in parallel.
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      collect_cells_with_distorted_children (const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &refined_cells,
+                                             typename Triangulation<dim,spacedim>::DistortedCellList &cells_with_distorted_children)
+      {
+        std::vector<unsigned char> distorted (refined_cells.size(), 0);
+        parallel::apply_to_subranges
+        (0U, refined_cells.size(),
+         std_cxx1x::bind (&check_children_for_distortion<dim,spacedim>,
+                          std_cxx1x::_1, std_cxx1x::_2,
+                          std_cxx1x::cref(refined_cells),
+                          std_cxx1x::ref(distorted)),
+         64);
+
+        for (unsigned int i=0; i<refined_cells.size(); ++i)
+          if (distorted[i])
+            cells_with_distorted_children.distorted_cells.push_back (refined_cells[i]);
+      }
+
+
+
       /**
        * A function that performs the
        * refinement of a triangulation in 1d.
@@ -4726,6 +4888,15 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            // the new vertices in the middle of the lines. if
+            // spacedim>dim, we always have to ask the boundary object
+            // for its answer, using the same object as for the cell
+            // (which was stored in line->user_index() before) unless
+            // a manifold_id has been set on this very line
+            std::vector<Point<spacedim> > new_points;
+            compute_new_points_on_lines (triangulation, new_points);
+            unsigned int next_new_point = 0;
+
             for (; line!=endl; ++line)
               if (line->user_flag_set())
                 {
@@ -4739,28 +4910,8 @@ namespace internal
                           ExcTooFewVerticesAllocated());
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  if (spacedim == dim)
-                    {
-                      // for the case of a domain in an
-                      // equal-dimensional space we only have to treat
-                      // boundary lines differently; for interior
-                      // lines we can compute the midpoint as the mean
-                      // of the two vertices: if (line->at_boundary())
-                      triangulation.vertices[next_unused_vertex]
-                        = line->get_manifold().get_new_point_on_line (line);
-                    }
-                  else
-                    // however, if spacedim>dim, we always have to ask
-                    // the boundary object for its answer. We use the
-                    // same object of the cell (which was stored in
-                    // line->user_index() before) unless a manifold_id
-                    // has been set on this very line.
-                    if (line->manifold_id() == numbers::invalid_manifold_id)
-                      triangulation.vertices[next_unused_vertex]
-                        = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
-                    else
-                      triangulation.vertices[next_unused_vertex]
-                        = line->get_manifold().get_new_point_on_line (line);
+                  triangulation.vertices[next_unused_vertex]
+                    = new_points[next_new_point++];
 
                   // now that we created the right point, make up the
                   // two child lines.  To this end, find a pair of
@@ -4832,6 +4983,11 @@ namespace internal
         typename Triangulation<2,spacedim>::DistortedCellList
         cells_with_distorted_children;
 
+        // the refined cells whose children need to be checked for
+        // distortion once they are all created
+        std::vector<typename Triangulation<dim,spacedim>::cell_iterator>
+        refined_cells;
+
         // reset next_unused_line, as now also single empty places in
         // the vector can be used
         typename Triangulation<dim,spacedim>::raw_line_iterator
@@ -4869,15 +5025,14 @@ namespace internal
                                    next_unused_cell,
                                    cell);
 
-                  if ((check_for_distorted_cells == true)
-                      &&
-                      has_distorted_children (cell,
-                                              internal::int2type<dim>(),
-                                              internal::int2type<spacedim>()))
-                    cells_with_distorted_children.distorted_cells.push_back (cell);
+                  if (check_for_distorted_cells == true)
+                    refined_cells.push_back (cell);
                 }
           }
 
+        collect_cells_with_distorted_children<dim,spacedim> (refined_cells,
+                                                             cells_with_distorted_children);
+
         return cells_with_distorted_children;
       }
 
@@ -5191,6 +5346,10 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            std::vector<Point<spacedim> > new_points;
+            compute_new_points_on_lines (triangulation, new_points);
+            unsigned int next_new_point = 0;
+
             for (; line!=endl; ++line)
               if (line->user_flag_set())
                 {
@@ -5205,7 +5364,7 @@ namespace internal
                   triangulation.vertices_used[next_unused_vertex] = true;
 
                   triangulation.vertices[next_unused_vertex]
-                    = line->get_manifold().get_new_point_on_line (line);
+                    = new_points[next_new_point++];
 
                   // now that we created the right point, make up the
                   // two child lines (++ takes care of the end of the
@@ -5825,11 +5984,14 @@ namespace internal
                         // derivation and values is copied over from
                         // the @p{MappingQ::set_laplace_on_vector}
                         // function
+                        Point<spacedim> points[Manifolds::max_default_points];
+                        double          weights[Manifolds::max_default_points];
+                        const unsigned int n_points
+                          = Manifolds::get_default_points_and_weights
+                            <typename Triangulation<dim,spacedim>::quad_iterator,
+                            spacedim>(quad, points, weights, true);
                         triangulation.vertices[next_unused_vertex] =
-                          quad->get_manifold().get_new_point
-                          (Manifolds::get_default_quadrature
-                           <typename Triangulation<dim,spacedim>::quad_iterator,
-                           spacedim>(quad, true));
+                          quad->get_manifold().get_new_point (points, weights, n_points);
                       }
                     triangulation.vertices_used[next_unused_vertex] = true;
                     // now that we created the right point, make up
@@ -6031,6 +6193,11 @@ namespace internal
         typename Triangulation<3,spacedim>::DistortedCellList
         cells_with_distorted_children;
 
+        // the refined cells whose children need to be checked for
+        // distortion once they are all created
+        std::vector<typename Triangulation<dim,spacedim>::cell_iterator>
+        refined_cells;
+
         for (unsigned int level=0; level!=triangulation.levels.size()-1; ++level)
           {
             // only active objects can be refined further; remember
@@ -8482,14 +8649,10 @@ namespace internal
                         new_hexes[current_child]->set_face_rotation    (f, f_ro[f]);
                       }
 
-                  // now see if we have created cells that are
-                  // distorted and if so add them to our list
-                  if ((check_for_distorted_cells == true)
-                      &&
-                      has_distorted_children (hex,
-                                              internal::int2type<dim>(),
-                                              internal::int2type<spacedim>()))
-                    cells_with_distorted_children.distorted_cells.push_back (hex);
+                  // remember the cell so that we can see later on
+                  // whether we have created cells that are distorted
+                  if (check_for_distorted_cells == true)
+                    refined_cells.push_back (hex);
 
                   // note that the refinement flag was already cleared
                   // at the beginning of this loop
@@ -8503,6 +8666,10 @@ namespace internal
         // enable the user to use whichever he likes later on.
         triangulation.faces->quads.clear_user_data();
 
+        // see which of the refined cells have distorted children
+        collect_cells_with_distorted_children<dim,spacedim> (refined_cells,
+                                                             cells_with_distorted_children);
+
         // return the list with distorted children
         return cells_with_distorted_children;
       }
@@ -13212,6 +13379,35 @@ Triangulation<dim, spacedim>::memory_consumption () const
 
 
 
+template <int dim, int spacedim>
+void
+Triangulation<dim, spacedim>::save_snapshot (std::ostream &out) const
+{
+  internal::FlatBinaryOArchive archive (out,
+                                        "Triangulation<"
+                                        + Utilities::int_to_string(dim) + ","
+                                        + Utilities::int_to_string(spacedim)
+                                        + ">");
+  save (archive, 0);
+}
+
+
+
+template <int dim, int spacedim>
+void
+Triangulation<dim, spacedim>::load_snapshot (std::istream &in)
+{
+  internal::FlatBinaryIArchive archive (in,
+                                        "Triangulation<"
+                                        + Utilities::int_to_string(dim) + ","
+                                        + Utilities::int_to_string(spacedim)
+                                        + ">");
+  load (archive, 0);
+}
+
+
+
+
 template<int dim, int spacedim>
 Triangulation<dim, spacedim>::RefinementListener::~RefinementListener ()
 {}
@@ -29,6 +29,14 @@ DEAL_II_NAMESPACE_OPEN
 /* -------------------------- Boundary --------------------- */
 
 
+template <int dim, int spacedim>
+Boundary<dim, spacedim>::Boundary ()
+{
+  this->thread_safe = false;
+}
+
+
+
 template <int dim, int spacedim>
 Boundary<dim, spacedim>::~Boundary ()
 {}
@@ -214,7 +222,10 @@ get_line_support_points (const unsigned int n_intermediate_points) const
 
 template <int dim, int spacedim>
 StraightBoundary<dim, spacedim>::StraightBoundary ()
-{}
+{
+  this->use_array_interface = true;
+  this->thread_safe = true;
+}
 
 
 template <int dim, int spacedim>
@@ -16,6 +16,9 @@
 
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/std_cxx1x/bind.h>
 #include <deal.II/lac/exceptions.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/sparsity_tools.h>
@@ -197,6 +200,74 @@ namespace SparsityTools
         return starting_point;
       }
     }
+
+
+    /**
+     * Minimal number of entries of a front of the Cuthill-McKee algorithm
+     * that are worked on by one task. Smaller fronts are worked on serially.
+     */
+    const unsigned int cuthill_mckee_grainsize = 256;
+
+    /**
+     * Add the as-yet unnumbered neighbors of the indices
+     * <tt>last_round_dofs[begin...end)</tt> to @p next_round_dofs. The
+     * neighbors are collected in a local array first, so that the lock
+     * protecting the shared array is only taken once per subrange.
+     */
+    void
+    find_unnumbered_neighbors (const std::size_t                               begin,
+                               const std::size_t                               end,
+                               const SparsityPattern                          &sparsity,
+                               const std::vector<SparsityPattern::size_type>  &last_round_dofs,
+                               const std::vector<SparsityPattern::size_type>  &new_indices,
+                               std::vector<SparsityPattern::size_type>        &next_round_dofs,
+                               Threads::Mutex                                 &mutex)
+    {
+      std::vector<SparsityPattern::size_type> neighbors;
+      for (std::size_t i=begin; i<end; ++i)
+        for (SparsityPattern::iterator j=sparsity.begin(last_round_dofs[i]);
+             j<sparsity.end(last_round_dofs[i]); ++j)
+          if (j->is_valid_entry() == false)
+            break;
+          else if (new_indices[j->column()] == numbers::invalid_size_type)
+            neighbors.push_back (j->column());
+
+      std::sort (neighbors.begin(), neighbors.end());
+      neighbors.erase (std::unique (neighbors.begin(), neighbors.end()),
+                       neighbors.end());
+
+      Threads::Mutex::ScopedLock lock (mutex);
+      next_round_dofs.insert (next_round_dofs.end(),
+                              neighbors.begin(), neighbors.end());
+    }
+
+
+
+    /**
+     * For the indices <tt>dofs[begin...end)</tt>, store pairs of the
+     * coordination number (the number of entries in the respective row of
+     * the sparsity pattern) and the index in @p dofs_by_coordination.
+     */
+    void
+    compute_coordination_numbers (const std::size_t                               begin,
+                                  const std::size_t                               end,
+                                  const SparsityPattern                          &sparsity,
+                                  const std::vector<SparsityPattern::size_type>  &dofs,
+                                  std::vector<std::pair<SparsityPattern::size_type,SparsityPattern::size_type> > &dofs_by_coordination)
+    {
+      for (std::size_t i=begin; i<end; ++i)
+        {
+          SparsityPattern::size_type coordination = 0;
+          for (SparsityPattern::iterator j=sparsity.begin(dofs[i]);
+               j<sparsity.end(dofs[i]); ++j)
+            if (j->is_valid_entry() == false)
+              break;
+            else
+              ++coordination;
+
+          dofs_by_coordination[i] = std::make_pair (coordination, dofs[i]);
+        }
+    }
   }
 
 
@@ -250,71 +321,44 @@ namespace SparsityTools
     // renumber all dofs
     while (true)
       {
-        // store the indices of the dofs to be
-        // renumbered in the next round
+        // find all as-yet unnumbered neighbors of the dofs numbered in the
+        // last round. this is done in parallel on subranges of the last
+        // front; the result is sorted below, so the order in which the
+        // subranges are merged does not matter
         std::vector<SparsityPattern::size_type> next_round_dofs;
-
-        // find all neighbors of the
-        // dofs numbered in the last
-        // round
-        for (SparsityPattern::size_type i=0; i<last_round_dofs.size(); ++i)
-          for (SparsityPattern::iterator j=sparsity.begin(last_round_dofs[i]);
-               j<sparsity.end(last_round_dofs[i]); ++j)
-            if (j->is_valid_entry() == false)
-              break;
-            else
-              next_round_dofs.push_back (j->column());
-
-        // sort dof numbers
+        Threads::Mutex next_round_mutex;
+        parallel::apply_to_subranges
+        (0U, last_round_dofs.size(),
+         std_cxx1x::bind (&internal::find_unnumbered_neighbors,
+                          std_cxx1x::_1, std_cxx1x::_2,
+                          std_cxx1x::cref(sparsity),
+                          std_cxx1x::cref(last_round_dofs),
+                          std_cxx1x::cref(new_indices),
+                          std_cxx1x::ref(next_round_dofs),
+                          std_cxx1x::ref(next_round_mutex)),
+         internal::cuthill_mckee_grainsize);
+
+        // sort dof numbers and delete multiple entries
         std::sort (next_round_dofs.begin(), next_round_dofs.end());
-
-        // delete multiple entries
-        std::vector<SparsityPattern::size_type>::iterator end_sorted;
-        end_sorted = std::unique (next_round_dofs.begin(), next_round_dofs.end());
-        next_round_dofs.erase (end_sorted, next_round_dofs.end());
-
-        // eliminate dofs which are
-        // already numbered
-        for (int s=next_round_dofs.size()-1; s>=0; --s)
-          if (new_indices[next_round_dofs[s]] != numbers::invalid_size_type)
-            next_round_dofs.erase (next_round_dofs.begin() + s);
-
-        // check whether there are
-        // any new dofs in the
-        // list. if there are none,
-        // then we have completely
-        // numbered the current
-        // component of the
-        // graph. check if there are
-        // as yet unnumbered
-        // components of the graph
-        // that we would then have to
-        // do next
+        next_round_dofs.erase (std::unique (next_round_dofs.begin(),
+                                            next_round_dofs.end()),
+                               next_round_dofs.end());
+
+        // check whether there are any new dofs in the list. if there are
+        // none, then we have completely numbered the current component of
+        // the graph. check if there are as yet unnumbered components of the
+        // graph that we would then have to do next
         if (next_round_dofs.empty())
           {
-            if (std::find (new_indices.begin(), new_indices.end(),
-                           numbers::invalid_size_type)
-                ==
-                new_indices.end())
-              // no unnumbered
-              // indices, so we can
-              // leave now
+            if (next_free_number == sparsity.n_rows())
+              // no unnumbered indices, so we can leave now
               break;
 
-            // otherwise find a valid
-            // starting point for the
-            // next component of the
-            // graph and continue
-            // with numbering that
-            // one. we only do so if
-            // no starting indices
-            // were provided by the
-            // user (see the
-            // documentation of this
-            // function) so produce
-            // an error if we got
-            // here and starting
-            // indices were given
+            // otherwise find a valid starting point for the next component
+            // of the graph and continue with numbering that one. we only do
+            // so if no starting indices were provided by the user (see the
+            // documentation of this function) so produce an error if we got
+            // here and starting indices were given
             Assert (starting_indices.empty(),
                     ExcMessage ("The input graph appears to have more than one "
                                 "component, but as stated in the documentation "
@@ -327,38 +371,27 @@ namespace SparsityTools
                                                                   new_indices));
           }
 
-
-
-        // store for each coordination
-        // number the dofs with these
-        // coordination number
-        std::multimap<SparsityPattern::size_type, int> dofs_by_coordination;
-
-        // find coordination number for
-        // each of these dofs
-        for (std::vector<SparsityPattern::size_type>::iterator s=next_round_dofs.begin();
-             s!=next_round_dofs.end(); ++s)
-          {
-            SparsityPattern::size_type coordination = 0;
-            for (SparsityPattern::iterator j=sparsity.begin(*s);
-                 j<sparsity.end(*s); ++j)
-              if (j->is_valid_entry() == false)
-                break;
-              else
-                ++coordination;
-
-            // insert this dof at its
-            // coordination number
-            const std::pair<const SparsityPattern::size_type, int> new_entry (coordination, *s);
-            dofs_by_coordination.insert (new_entry);
-          }
+        // find the coordination number for each of these dofs (again in
+        // parallel) and sort the dofs by it. since next_round_dofs is
+        // sorted, dofs with equal coordination number end up sorted by
+        // their index
+        std::vector<std::pair<SparsityPattern::size_type,SparsityPattern::size_type> >
+        dofs_by_coordination (next_round_dofs.size());
+        parallel::apply_to_subranges
+        (0U, next_round_dofs.size(),
+         std_cxx1x::bind (&internal::compute_coordination_numbers,
+                          std_cxx1x::_1, std_cxx1x::_2,
+                          std_cxx1x::cref(sparsity),
+                          std_cxx1x::cref(next_round_dofs),
+                          std_cxx1x::ref(dofs_by_coordination)),
+         internal::cuthill_mckee_grainsize);
+        std::sort (dofs_by_coordination.begin(), dofs_by_coordination.end());
 
         // assign new DoF numbers to
         // the elements of the present
         // front:
-        std::multimap<SparsityPattern::size_type, int>::iterator i;
-        for (i = dofs_by_coordination.begin(); i!=dofs_by_coordination.end(); ++i)
-          new_indices[i->second] = next_free_number++;
+        for (std::size_t i=0; i<dofs_by_coordination.size(); ++i)
+          new_indices[dofs_by_coordination[i].second] = next_free_number++;
 
         // after that: copy this round's
         // dofs for the next round
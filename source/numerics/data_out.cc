@@ -15,6 +15,7 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/work_stream.h>
+#include <deal.II/base/std_cxx1x/bind.h>
 #include <deal.II/numerics/data_out.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -27,6 +28,7 @@
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/fe/mapping_q1.h>
 
+#include <algorithm>
 #include <sstream>
 
 DEAL_II_NAMESPACE_OPEN
@@ -60,6 +62,14 @@ namespace internal
 
 
 
+template <int dim, class DH>
+DataOut<dim,DH>::DataOut ()
+  :
+  output_level (numbers::invalid_unsigned_int)
+{}
+
+
+
 template <int dim, class DH>
 void
 DataOut<dim,DH>::
@@ -67,6 +77,7 @@ build_one_patch (const std::pair<cell_iterator, unsigned int> *cell_and_index,
                  internal::DataOut::ParallelData<DH::dimension, DH::space_dimension> &data,
                  DataOutBase::Patch<DH::dimension, DH::space_dimension> &patch,
                  const CurvedCellRegion curved_cell_region,
+                 const unsigned int first_patch_index,
                  std::vector<DataOutBase::Patch<DH::dimension, DH::space_dimension> > &patches)
 {
   // use ucd_to_deal map as patch vertices are in the old, unnatural
@@ -83,7 +94,7 @@ build_one_patch (const std::pair<cell_iterator, unsigned int> *cell_and_index,
 
   if (data.n_datasets > 0)
     {
-      // create DH::active_cell_iterator and initialize FEValues
+      // create DH::cell_iterator and initialize FEValues
       data.reinit_all_fe_values(this->dof_data, cell_and_index->first);
 
       const FEValuesBase<DH::dimension,DH::space_dimension> &fe_patch_values
@@ -296,11 +307,13 @@ build_one_patch (const std::pair<cell_iterator, unsigned int> *cell_and_index,
   const unsigned int patch_idx =
     (*data.cell_to_patch_index_map)[cell_and_index->first->level()][cell_and_index->first->index()];
   // did we mess up the indices?
-  Assert(patch_idx < patches.size(), ExcInternalError());
+  Assert((patch_idx >= first_patch_index) &&
+         (patch_idx - first_patch_index < patches.size()),
+         ExcInternalError());
 
   // Put the patch in the patches vector
-  patches[patch_idx] = patch;
-  patches[patch_idx].patch_index = patch_idx;
+  patches[patch_idx-first_patch_index] = patch;
+  patches[patch_idx-first_patch_index].patch_index = patch_idx;
 }
 
 
@@ -332,6 +345,116 @@ void DataOut<dim,DH>::build_patches (const Mapping<DH::dimension,DH::space_dimen
   Assert (n_subdivisions >= 1,
           ExcInvalidNumberOfSubdivisions(n_subdivisions));
 
+  std::vector<std::pair<cell_iterator, unsigned int> > all_cells;
+  std::vector<std::vector<unsigned int> > cell_to_patch_index_map;
+  std::vector<unsigned int> subdivisions;
+  get_cells_and_patch_indices (n_subdivisions, all_cells,
+                               cell_to_patch_index_map, subdivisions);
+
+  this->patches.clear ();
+  this->patches.resize(all_cells.size());
+
+  // build the patches of each range of cells with the same number of
+  // subdivisions in one go. the patches are numbered by their position
+  // in all_cells, so they all end up in the right place in the array
+  for (unsigned int first=0; first<all_cells.size(); )
+    {
+      unsigned int last = first+1;
+      while ((last < all_cells.size()) && (subdivisions[last] == subdivisions[first]))
+        ++last;
+      build_patches_for_cells (&all_cells[0]+first, &all_cells[0]+last, 0,
+                               mapping, subdivisions[first], curved_region,
+                               cell_to_patch_index_map, this->patches);
+      first = last;
+    }
+
+  // patches with different numbers of subdivisions do not share the
+  // points on their common face, so do not mark them as neighbors
+  if (cell_subdivisions)
+    for (unsigned int i=0; i<this->patches.size(); ++i)
+      for (unsigned int f=0; f<GeometryInfo<DH::dimension>::faces_per_cell; ++f)
+        if ((this->patches[i].neighbors[f] != numbers::invalid_unsigned_int)
+            &&
+            (this->patches[this->patches[i].neighbors[f]].n_subdivisions !=
+             this->patches[i].n_subdivisions))
+          this->patches[i].neighbors[f] = numbers::invalid_unsigned_int;
+}
+
+
+
+template <int dim, class DH>
+void DataOut<dim,DH>::write_vtu_in_pieces (std::ostream &out,
+                                           const Mapping<DH::dimension,DH::space_dimension> &mapping,
+                                           const unsigned int nnnn_subdivisions,
+                                           const unsigned int n_cells_per_piece,
+                                           const CurvedCellRegion curved_region)
+{
+  // Check consistency of redundant template parameter
+  Assert (dim==DH::dimension, ExcDimensionMismatch(dim, DH::dimension));
+
+  typedef DataOut_DoFData<DH, DH::dimension, DH::space_dimension> BaseClass;
+  Assert (this->triangulation != 0,
+          typename BaseClass::ExcNoTriangulationSelected());
+  Assert (n_cells_per_piece > 0,
+          ExcMessage ("The number of cells per piece must be positive."));
+
+  const unsigned int n_subdivisions = (nnnn_subdivisions != 0)
+                                      ? nnnn_subdivisions
+                                      : this->default_subdivisions;
+  Assert (n_subdivisions >= 1,
+          ExcInvalidNumberOfSubdivisions(n_subdivisions));
+
+  std::vector<std::pair<cell_iterator, unsigned int> > all_cells;
+  std::vector<std::vector<unsigned int> > cell_to_patch_index_map;
+  std::vector<unsigned int> subdivisions;
+  get_cells_and_patch_indices (n_subdivisions, all_cells,
+                               cell_to_patch_index_map, subdivisions);
+
+  const std::vector<std::string> data_names = this->get_dataset_names();
+  const std::vector<std_cxx1x::tuple<unsigned int, unsigned int, std::string> >
+  vector_data_ranges = this->get_vector_data_ranges();
+
+  DataOutBase::write_vtu_header (out, this->get_vtk_flags());
+
+  // build the patches of one piece of cells at a time, write them as a
+  // piece of their own, and then throw them away again before we start
+  // with the next piece. a piece ends early where the number of
+  // subdivisions changes. if there are no cells at all, let
+  // write_vtu_main decide what to write
+  std::vector<DataOutBase::Patch<DH::dimension, DH::space_dimension> > piece_patches;
+  if (all_cells.size() == 0)
+    DataOutBase::write_vtu_main (piece_patches, data_names, vector_data_ranges,
+                                 this->get_vtk_flags(), out);
+  for (unsigned int first=0; first<all_cells.size(); )
+    {
+      unsigned int last = first+1;
+      while ((last < all_cells.size()) && (last-first < n_cells_per_piece)
+             && (subdivisions[last] == subdivisions[first]))
+        ++last;
+      piece_patches.clear ();
+      piece_patches.resize (last-first);
+      build_patches_for_cells (&all_cells[0]+first, &all_cells[0]+last, first,
+                               mapping, subdivisions[first], curved_region,
+                               cell_to_patch_index_map, piece_patches);
+
+      DataOutBase::write_vtu_main (piece_patches, data_names, vector_data_ranges,
+                                   this->get_vtk_flags(), out);
+      first = last;
+    }
+
+  DataOutBase::write_vtu_footer (out);
+}
+
+
+
+template <int dim, class DH>
+void
+DataOut<dim,DH>::
+get_cells_and_patch_indices (const unsigned int n_subdivisions,
+                             std::vector<std::pair<cell_iterator, unsigned int> > &all_cells,
+                             std::vector<std::vector<unsigned int> > &cell_to_patch_index_map,
+                             std::vector<unsigned int> &subdivisions)
+{
   // First count the cells we want to create patches of. Also fill the object
   // that maps the cell indices to the patch numbers, as this will be needed
   // for generation of neighborship information.
@@ -345,7 +468,7 @@ void DataOut<dim,DH>::build_patches (const Mapping<DH::dimension,DH::space_dimen
   // It turns out that we create one patch for each selected cell, so patch_index==cell_index.
   //
   // will be cell_to_patch_index_map[cell->level][cell->index] = patch_index
-  std::vector<std::vector<unsigned int> > cell_to_patch_index_map;
+  cell_to_patch_index_map.clear ();
   cell_to_patch_index_map.resize (this->triangulation->n_levels());
   for (unsigned int l=0; l<this->triangulation->n_levels(); ++l)
     {
@@ -362,7 +485,7 @@ void DataOut<dim,DH>::build_patches (const Mapping<DH::dimension,DH::space_dimen
     }
 
   // will be all_cells[patch_index] = pair(cell, active_index)
-  std::vector<std::pair<cell_iterator, unsigned int> > all_cells;
+  all_cells.clear ();
   {
     // important: we need to compute the active_index of the cell in the range
     // 0..n_active_cells() because this is where we need to look up cell
@@ -399,9 +522,53 @@ void DataOut<dim,DH>::build_patches (const Mapping<DH::dimension,DH::space_dimen
       }
   }
 
-  this->patches.clear ();
-  this->patches.resize(all_cells.size());
+  subdivisions.clear ();
+  if (!cell_subdivisions)
+    {
+      subdivisions.resize (all_cells.size(), n_subdivisions);
+      return;
+    }
+
+  // sort the cells by the number of subdivisions of their patches. the
+  // original position of each cell breaks ties so that the order among
+  // cells with the same number of subdivisions is retained
+  std::vector<std::pair<unsigned int, unsigned int> > order (all_cells.size());
+  for (unsigned int i=0; i<all_cells.size(); ++i)
+    {
+      order[i].first = cell_subdivisions (all_cells[i].first);
+      order[i].second = i;
+      Assert (order[i].first >= 1,
+              ExcInvalidNumberOfSubdivisions(order[i].first));
+    }
+  std::sort (order.begin(), order.end());
+
+  std::vector<std::pair<cell_iterator, unsigned int> > sorted_cells (all_cells.size());
+  subdivisions.resize (all_cells.size());
+  for (unsigned int i=0; i<order.size(); ++i)
+    {
+      sorted_cells[i] = all_cells[order[i].second];
+      subdivisions[i] = order[i].first;
+
+      const cell_iterator &cell = sorted_cells[i].first;
+      cell_to_patch_index_map[cell->level()][cell->index()] = i;
+    }
+  all_cells.swap (sorted_cells);
+}
+
 
+
+template <int dim, class DH>
+void
+DataOut<dim,DH>::
+build_patches_for_cells (const std::pair<cell_iterator, unsigned int> *begin,
+                         const std::pair<cell_iterator, unsigned int> *end,
+                         const unsigned int first_patch_index,
+                         const Mapping<DH::dimension,DH::space_dimension> &mapping,
+                         const unsigned int n_subdivisions,
+                         const CurvedCellRegion curved_region,
+                         const std::vector<std::vector<unsigned int> > &cell_to_patch_index_map,
+                         std::vector<DataOutBase::Patch<DH::dimension, DH::space_dimension> > &patches)
+{
   // now create a default object for the WorkStream object to work with
   unsigned int n_datasets=this->cell_data.size();
   for (unsigned int i=0; i<this->dof_data.size(); ++i)
@@ -445,12 +612,13 @@ void DataOut<dim,DH>::build_patches (const Mapping<DH::dimension,DH::space_dimen
 
 
   // now build the patches in parallel
-  if (all_cells.size() > 0)
-    WorkStream::run (&all_cells[0],
-                     &all_cells[0]+all_cells.size(),
+  if (begin != end)
+    WorkStream::run (begin,
+                     end,
                      std_cxx1x::bind(&DataOut<dim,DH>::build_one_patch,
                                      this, std_cxx1x::_1, std_cxx1x::_2, std_cxx1x::_3,
-                                     curved_cell_region,std_cxx1x::ref(this->patches)),
+                                     curved_cell_region, first_patch_index,
+                                     std_cxx1x::ref(patches)),
                      // no copy-local-to-global function needed here
                      std_cxx1x::function<void (const ::dealii::DataOutBase::Patch<DH::dimension, DH::space_dimension> &)>(),
                      thread_data,
@@ -467,11 +635,146 @@ void DataOut<dim,DH>::build_patches (const Mapping<DH::dimension,DH::space_dimen
 
 
 
+template <int dim, class DH>
+void
+DataOut<dim,DH>::
+set_cell_selection (const std_cxx1x::function<bool (const cell_iterator &)> &predicate)
+{
+  cell_selection = predicate;
+}
+
+
+
+template <int dim, class DH>
+void
+DataOut<dim,DH>::
+select_cells_in_box (const Point<DH::space_dimension> &p1,
+                     const Point<DH::space_dimension> &p2)
+{
+  Point<DH::space_dimension> lower, upper;
+  for (unsigned int d=0; d<DH::space_dimension; ++d)
+    {
+      lower[d] = std::min (p1[d], p2[d]);
+      upper[d] = std::max (p1[d], p2[d]);
+    }
+  cell_selection = std_cxx1x::bind (&DataOut<dim,DH>::cell_intersects_box,
+                                    std_cxx1x::_1, lower, upper);
+}
+
+
+
+template <int dim, class DH>
+void
+DataOut<dim,DH>::
+select_cells_with_material_id (const types::material_id material_id)
+{
+  cell_selection = std_cxx1x::bind (&DataOut<dim,DH>::cell_has_material_id,
+                                    std_cxx1x::_1, material_id);
+}
+
+
+
+template <int dim, class DH>
+void
+DataOut<dim,DH>::set_output_level (const unsigned int level)
+{
+  output_level = level;
+}
+
+
+
+template <int dim, class DH>
+void
+DataOut<dim,DH>::
+set_cell_subdivisions (const std_cxx1x::function<unsigned int (const cell_iterator &)> &n_subdivisions)
+{
+  cell_subdivisions = n_subdivisions;
+}
+
+
+
+template <int dim, class DH>
+void
+DataOut<dim,DH>::clear_cell_selection ()
+{
+  cell_selection = std_cxx1x::function<bool (const cell_iterator &)>();
+  output_level = numbers::invalid_unsigned_int;
+  cell_subdivisions = std_cxx1x::function<unsigned int (const cell_iterator &)>();
+}
+
+
+
+template <int dim, class DH>
+bool
+DataOut<dim,DH>::is_selected (const cell_iterator &cell) const
+{
+  // with an output level, take the cells on that level and the active
+  // cells on coarser levels. otherwise, take the active cells
+  if (output_level != numbers::invalid_unsigned_int)
+    {
+      if ((static_cast<unsigned int>(cell->level()) != output_level)
+          &&
+          ((static_cast<unsigned int>(cell->level()) > output_level)
+           ||
+           cell->has_children()))
+        return false;
+    }
+  else if (cell->has_children())
+    return false;
+
+  return (!cell_selection || cell_selection (cell));
+}
+
+
+
+template <int dim, class DH>
+bool
+DataOut<dim,DH>::
+cell_intersects_box (const cell_iterator &cell,
+                     const Point<DH::space_dimension> &lower,
+                     const Point<DH::space_dimension> &upper)
+{
+  for (unsigned int d=0; d<DH::space_dimension; ++d)
+    {
+      bool all_below = true,
+           all_above = true;
+      for (unsigned int v=0; v<GeometryInfo<DH::dimension>::vertices_per_cell; ++v)
+        {
+          if (cell->vertex(v)[d] >= lower[d])
+            all_below = false;
+          if (cell->vertex(v)[d] <= upper[d])
+            all_above = false;
+        }
+      if (all_below || all_above)
+        return false;
+    }
+  return true;
+}
+
+
+
+template <int dim, class DH>
+bool
+DataOut<dim,DH>::
+cell_has_material_id (const cell_iterator &cell,
+                      const types::material_id material_id)
+{
+  return (cell->material_id() == material_id);
+}
+
+
+
 template <int dim, class DH>
 typename DataOut<dim,DH>::cell_iterator
 DataOut<dim,DH>::first_cell ()
 {
-  return this->triangulation->begin_active ();
+  if (!cell_selection && (output_level == numbers::invalid_unsigned_int))
+    return this->triangulation->begin_active ();
+
+  cell_iterator cell = this->triangulation->begin();
+  while ((cell != this->triangulation->end()) && !is_selected(cell))
+    ++cell;
+  return cell;
 }
 
 
@@ -480,12 +783,23 @@ template <int dim, class DH>
 typename DataOut<dim,DH>::cell_iterator
 DataOut<dim,DH>::next_cell (const typename DataOut<dim,DH>::cell_iterator &cell)
 {
-  // convert the iterator to an active_iterator and advance this to the next
-  // active cell
-  typename Triangulation<DH::dimension,DH::space_dimension>::
-  active_cell_iterator active_cell = cell;
-  ++active_cell;
-  return active_cell;
+  if (!cell_selection && (output_level == numbers::invalid_unsigned_int))
+    {
+      // convert the iterator to an active_iterator and advance this to the
+      // next active cell
+      typename Triangulation<DH::dimension,DH::space_dimension>::
+      active_cell_iterator active_cell = cell;
+      ++active_cell;
+      return active_cell;
+    }
+
+  // otherwise walk over all cells of all levels until we find the next
+  // selected one
+  cell_iterator next = cell;
+  ++next;
+  while ((next != this->triangulation->end()) && !is_selected(next))
+    ++next;
+  return next;
 }
 
 
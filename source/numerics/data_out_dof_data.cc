@@ -222,10 +222,13 @@ namespace internal
               duplicate = true;
           if (duplicate == false)
             {
-              typename DH::active_cell_iterator dh_cell(&cell->get_triangulation(),
-                                                        cell->level(),
-                                                        cell->index(),
-                                                        dof_data[dataset]->dof_handler);
+              // the cell need not be active if output is requested on a
+              // coarser level; the FEValues objects then interpolate the
+              // data from the children of the cell
+              typename DH::cell_iterator dh_cell(&cell->get_triangulation(),
+                                                 cell->level(),
+                                                 cell->index(),
+                                                 dof_data[dataset]->dof_handler);
               if (x_fe_values.empty())
                 {
                   AssertIndexRange(face,
@@ -87,7 +87,7 @@ DataOutFaces<dim,DH>::DataOutFaces(const bool so)
 template <int dim, class DH>
 void
 DataOutFaces<dim,DH>::
-build_one_patch (const FaceDescriptor *cell_and_face,
+build_one_patch (const FaceIterator &cell_and_face,
                  internal::DataOutFaces::ParallelData<dimension, dimension> &data,
                  DataOutBase::Patch<dimension-1,space_dimension>  &patch)
 {
@@ -240,16 +240,12 @@ build_one_patch (const FaceDescriptor *cell_and_face,
           offset+=this->dof_data[dataset]->n_output_variables;
         }
 
-      // then do the cell data
+      // then do the cell data. the iterator keeps track of the number of
+      // the cell to which this face belongs
       for (unsigned int dataset=0; dataset<this->cell_data.size(); ++dataset)
         {
-          // we need to get at the number of the cell to which this face
-          // belongs in order to access the cell data. this is not readily
-          // available, so choose the following rather inefficient way:
           Assert (cell_and_face->first->active(), ExcCellNotActiveForCellData());
-          const unsigned int cell_number
-            = std::distance (this->triangulation->begin_active(),
-                             typename Triangulation<dimension,space_dimension>::active_cell_iterator(cell_and_face->first));
+          const unsigned int cell_number = cell_and_face.active_cell_index();
 
           const double value
             = this->cell_data[dataset]->get_cell_data_value (cell_number);
@@ -292,18 +288,23 @@ void DataOutFaces<dim,DH>::build_patches (const Mapping<dimension> &mapping,
   for (unsigned int i=0; i<this->dof_data.size(); ++i)
     n_datasets += this->dof_data[i]->n_output_variables;
 
-  // first count the cells we want to create patches of and make sure there is
-  // enough memory for that
-  std::vector<FaceDescriptor> all_faces;
-  for (FaceDescriptor face=first_face();
-       face.first != this->triangulation->end();
-       face = next_face(face))
-    all_faces.push_back (face);
-
-  // clear the patches array and allocate the right number of elements
+  // clear the patches array and make room for the patches that are
+  // appended as they are built. without surface_only, every face of
+  // every active cell is an upper bound for their number. otherwise
+  // count the faces, which is cheap compared to building their patches
   this->patches.clear ();
-  this->patches.reserve (all_faces.size());
-  Assert (this->patches.size() == 0, ExcInternalError());
+  if (surface_only == false)
+    this->patches.reserve (this->triangulation->n_active_cells() *
+                           GeometryInfo<dimension>::faces_per_cell);
+  else
+    {
+      unsigned int n_faces = 0;
+      for (FaceDescriptor face=first_face();
+           face.first != this->triangulation->end();
+           face = next_face(face))
+        ++n_faces;
+      this->patches.reserve (n_faces);
+    }
 
 
   std::vector<unsigned int> n_postprocessor_outputs (this->dof_data.size());
@@ -331,9 +332,13 @@ void DataOutFaces<dim,DH>::build_patches (const Mapping<dimension> &mapping,
   sample_patch.data.reinit (n_datasets,
                             Utilities::fixed_power<dimension-1>(n_subdivisions+1));
 
-  // now build the patches in parallel
-  WorkStream::run (&all_faces[0],
-                   &all_faces[0]+all_faces.size(),
+  // now build the patches in parallel. the faces are produced by
+  // first_face() and next_face() while the patches of the previous ones
+  // are being built. the iterator only keeps track of the index of the
+  // cells if there is cell data
+  WorkStream::run (FaceIterator (first_face(), this, &DataOutFaces<dim,DH>::next_face,
+                                 this->cell_data.size() != 0),
+                   FaceIterator (FaceDescriptor (this->triangulation->end(), 0)),
                    std_cxx1x::bind(&DataOutFaces<dim,DH>::build_one_patch,
                                    this, std_cxx1x::_1, std_cxx1x::_2, std_cxx1x::_3),
                    std_cxx1x::bind(&internal::DataOutFaces::
@@ -349,19 +354,18 @@ template <int dim, class DH>
 typename DataOutFaces<dim,DH>::FaceDescriptor
 DataOutFaces<dim,DH>::first_face ()
 {
-  // simply find first active cell
+  // simply find first locally owned active cell
   // with a face on the boundary
   typename Triangulation<dimension,space_dimension>::active_cell_iterator cell = this->triangulation->begin_active();
   for (; cell != this->triangulation->end(); ++cell)
-    for (unsigned int f=0; f<GeometryInfo<dimension>::faces_per_cell; ++f)
-      if (!surface_only || cell->face(f)->at_boundary())
-        return FaceDescriptor(cell, f);
-
-  // ups, triangulation has no
-  // boundary? impossible!
-  Assert (false, ExcInternalError());
+    if (cell->is_locally_owned())
+      for (unsigned int f=0; f<GeometryInfo<dimension>::faces_per_cell; ++f)
+        if (!surface_only || cell->face(f)->at_boundary())
+          return FaceDescriptor(cell, f);
 
-  return FaceDescriptor();
+  // there is no such face. this can happen if the
+  // present processor owns no cell at the boundary
+  return FaceDescriptor(this->triangulation->end(), 0);
 }
 
 
@@ -393,14 +397,15 @@ DataOutFaces<dim,DH>::next_face (const FaceDescriptor &old_face)
   // while there are active cells
   while (active_cell != this->triangulation->end())
     {
-      // check all the faces of this active cell
-      for (unsigned int f=0; f<GeometryInfo<dimension>::faces_per_cell; ++f)
-        if (!surface_only || active_cell->face(f)->at_boundary())
-          {
-            face.first  = active_cell;
-            face.second = f;
-            return face;
-          };
+      // check all the faces of this active cell if it is locally owned
+      if (active_cell->is_locally_owned())
+        for (unsigned int f=0; f<GeometryInfo<dimension>::faces_per_cell; ++f)
+          if (!surface_only || active_cell->face(f)->at_boundary())
+            {
+              face.first  = active_cell;
+              face.second = f;
+              return face;
+            };
       // the present cell had no faces on the boundary, so check next cell
       ++active_cell;
     };
@@ -94,7 +94,7 @@ namespace internal
 template <int dim, class DH>
 void
 DataOutRotation<dim,DH>::
-build_one_patch (const cell_iterator *cell,
+build_one_patch (const CellIterator &cell,
                  internal::DataOutRotation::ParallelData<dimension, space_dimension> &data,
                  std::vector<DataOutBase::Patch<dimension+1,space_dimension+1> > &patches)
 {
@@ -354,17 +354,13 @@ build_one_patch (const cell_iterator *cell,
               offset+=this->dof_data[dataset]->n_output_variables;
             }
 
-          // then do the cell data
+          // then do the cell data. the iterator keeps track of the number
+          // of the cell
           for (unsigned int dataset=0; dataset<this->cell_data.size(); ++dataset)
             {
-              // we need to get at the number of the cell to which this face
-              // belongs in order to access the cell data. this is not readily
-              // available, so choose the following rather inefficient way:
               Assert ((*cell)->active(),
                       ExcMessage("Cell must be active for cell data"));
-              const unsigned int cell_number
-                = std::distance (this->triangulation->begin_active(),
-                                 typename Triangulation<dimension,space_dimension>::active_cell_iterator(*cell));
+              const unsigned int cell_number = cell.active_cell_index();
               const double value
                 = this->cell_data[dataset]->get_cell_data_value (cell_number);
               switch (dimension)
@@ -431,21 +427,14 @@ void DataOutRotation<dim,DH>::build_patches (const unsigned int n_patches_per_ci
           ExcMessage("The update of normal vectors may not be requested for "
                      "evaluation of data on cells via DataPostprocessor."));
 
-  // first count the cells we want to
-  // create patches of and make sure
-  // there is enough memory for that
-  std::vector<cell_iterator> all_cells;
-  for (cell_iterator cell=first_cell(); cell != this->triangulation->end();
-       cell = next_cell(cell))
-    all_cells.push_back (cell);
-
-  // then also take into account that
-  // we want more than one patch to
-  // come out of every cell, as they
-  // are repeated around the axis of
-  // rotation
+  // clear the patches array. the
+  // patches are appended as they are
+  // built, and every active cell
+  // gives at most
+  // n_patches_per_circle of them
   this->patches.clear();
-  this->patches.reserve (all_cells.size() * n_patches_per_circle);
+  this->patches.reserve (this->triangulation->n_active_cells() *
+                         n_patches_per_circle);
 
 
   std::vector<unsigned int> n_postprocessor_outputs (this->dof_data.size());
@@ -470,9 +459,16 @@ void DataOutRotation<dim,DH>::build_patches (const unsigned int n_patches_per_ci
                                   Utilities::fixed_power<dimension+1>(n_subdivisions+1));
     }
 
-  // now build the patches in parallel
-  WorkStream::run (&all_cells[0],
-                   &all_cells[0]+all_cells.size(),
+  // now build the patches in
+  // parallel. the cells are produced
+  // by first_cell() and next_cell()
+  // while the patches of the previous
+  // ones are being built. the index
+  // of the cells is only tracked if
+  // there is cell data
+  WorkStream::run (CellIterator (first_cell(), this, &DataOutRotation<dim,DH>::next_cell,
+                                 this->cell_data.size() != 0),
+                   CellIterator (this->triangulation->end()),
                    std_cxx1x::bind(&DataOutRotation<dim,DH>::build_one_patch,
                                    this, std_cxx1x::_1, std_cxx1x::_2, std_cxx1x::_3),
                    std_cxx1x::bind(&internal::DataOutRotation
@@ -488,7 +484,14 @@ template <int dim, class DH>
 typename DataOutRotation<dim,DH>::cell_iterator
 DataOutRotation<dim,DH>::first_cell ()
 {
-  return this->triangulation->begin_active ();
+  typename Triangulation<dimension,space_dimension>::active_cell_iterator
+  cell = this->triangulation->begin_active ();
+
+  // skip cells that are not locally
+  // owned
+  while ((cell != this->triangulation->end()) && !cell->is_locally_owned())
+    ++cell;
+  return cell;
 }
 
 
@@ -501,6 +504,8 @@ DataOutRotation<dim,DH>::next_cell (const cell_iterator &cell)
   // this to the next active cell
   typename Triangulation<dimension,space_dimension>::active_cell_iterator active_cell = cell;
   ++active_cell;
+  while ((active_cell != this->triangulation->end()) && !active_cell->is_locally_owned())
+    ++active_cell;
   return active_cell;
 }
 
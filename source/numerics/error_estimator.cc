@@ -297,36 +297,55 @@ namespace internal
 
 
     /**
-     * Copy data from the local_face_integrals map of a single ParallelData
-     * object into a global such map. This is the copier stage of a WorkStream
-     * pipeline.
+     * The integrated jumps of the normal gradients on all faces of the
+     * mesh, stored as a flat array with one entry per solution vector for
+     * each face, indexed by the index of the face. Every face is computed
+     * by exactly one cell (see estimate_one_cell()), so that the threads
+     * working on different cells write to disjoint parts of this array
+     * and need not synchronize.
+     *
+     * All entries are initialized with a negative value, which allows to
+     * check that a face has been computed before its value is used.
      */
-    template <class DH>
-    void
-    copy_local_to_global (const std::map<typename DH::face_iterator,std::vector<double> > &local_face_integrals,
-                          std::map<typename DH::face_iterator,std::vector<double> > &face_integrals)
+    class FaceIntegrals
     {
+    public:
+      FaceIntegrals (const unsigned int n_faces,
+                     const unsigned int n_solution_vectors)
+        :
+        n_solution_vectors (n_solution_vectors),
+        values (static_cast<std::size_t>(n_faces) * n_solution_vectors, -1e20)
+      {}
 
-      // now copy locally computed elements into the global map
-      for (typename std::map<typename DH::face_iterator,std::vector<double> >::const_iterator
-           p=local_face_integrals.begin();
-           p!=local_face_integrals.end();
-           ++p)
-        {
-          // double check that the element does not already exists in the
-          // global map
-          Assert (face_integrals.find (p->first) == face_integrals.end(),
-                  ExcInternalError());
+      /**
+       * Return a pointer to the @p n_solution_vectors values that belong
+       * to the given face.
+       */
+      template <class FaceIterator>
+      double *operator [] (const FaceIterator &face)
+      {
+        Assert (static_cast<std::size_t>(face->index()) * n_solution_vectors
+                < values.size(),
+                ExcIndexRange (face->index(), 0,
+                               values.size() / n_solution_vectors));
+        return &values[static_cast<std::size_t>(face->index()) *
+                       n_solution_vectors];
+      }
 
-          for (unsigned int i=0; i<p->second.size(); ++i)
-            {
-              Assert (numbers::is_finite(p->second[i]), ExcInternalError());
-              Assert (p->second[i] >= 0, ExcInternalError());
-            }
+      /**
+       * Return whether the values for the given face have been computed.
+       */
+      template <class FaceIterator>
+      bool is_set (const FaceIterator &face)
+      {
+        return ((*this)[face][0] >= 0);
+      }
+
+    private:
+      const unsigned int  n_solution_vectors;
+      std::vector<double> values;
+    };
 
-          face_integrals[p->first] = p->second;
-        }
-    }
 
 
     /**
@@ -334,10 +353,11 @@ namespace internal
      * ParallelData.
      */
     template <class DH>
-    std::vector<double>
+    void
     integrate_over_face (ParallelData<DH>                        &parallel_data,
                          const typename DH::face_iterator        &face,
-                         dealii::hp::FEFaceValues<DH::dimension, DH::space_dimension> &fe_face_values_cell)
+                         dealii::hp::FEFaceValues<DH::dimension, DH::space_dimension> &fe_face_values_cell,
+                         double                                  *face_integral)
     {
       const unsigned int n_q_points         = parallel_data.psi[0].size(),
                          n_components       = parallel_data.finite_element.n_components(),
@@ -454,7 +474,8 @@ namespace internal
         = fe_face_values_cell.get_present_fe_values().get_JxW_values();
 
       // take the square of the phi[i] for integration, and sum up
-      std::vector<double> face_integral (n_solution_vectors, 0);
+      for (unsigned int n=0; n<n_solution_vectors; ++n)
+        face_integral[n] = 0;
       for (unsigned int n=0; n<n_solution_vectors; ++n)
         for (unsigned int component=0; component<n_components; ++component)
           if (parallel_data.component_mask[component] == true)
@@ -462,7 +483,8 @@ namespace internal
               face_integral[n] += Utilities::fixed_power<2>(parallel_data.phi[n][p][component]) *
                                   parallel_data.JxW_values[p];
 
-      return face_integral;
+      for (unsigned int n=0; n<n_solution_vectors; ++n)
+        Assert (numbers::is_finite(face_integral[n]), ExcInternalError());
     }
 
 
@@ -477,7 +499,7 @@ namespace internal
     void
     integrate_over_regular_face (const std::vector<const InputVector *>   &solutions,
                                  ParallelData<DH>                        &parallel_data,
-                                 std::map<typename DH::face_iterator,std::vector<double> > &local_face_integrals,
+                                 FaceIntegrals                           &face_integrals,
                                  const typename DH::active_cell_iterator &cell,
                                  const unsigned int                       face_no,
                                  dealii::hp::FEFaceValues<DH::dimension, DH::space_dimension> &fe_face_values_cell,
@@ -532,8 +554,8 @@ namespace internal
         }
 
       // now go to the generic function that does all the other things
-      local_face_integrals[face] =
-        integrate_over_face (parallel_data, face, fe_face_values_cell);
+      integrate_over_face (parallel_data, face, fe_face_values_cell,
+                           face_integrals[face]);
     }
 
 
@@ -553,7 +575,7 @@ namespace internal
     void
     integrate_over_irregular_face (const std::vector<const InputVector *>   &solutions,
                                    ParallelData<DH>                         &parallel_data,
-                                   std::map<typename DH::face_iterator,std::vector<double> > &local_face_integrals,
+                                   FaceIntegrals                              &face_integrals,
                                    const typename DH::active_cell_iterator    &cell,
                                    const unsigned int                          face_no,
                                    dealii::hp::FEFaceValues<DH::dimension,DH::space_dimension>    &fe_face_values,
@@ -612,26 +634,24 @@ namespace internal
             .get_function_gradients (*solutions[n], parallel_data.neighbor_psi[n]);
 
           // call generic evaluate function
-          local_face_integrals[neighbor_child->face(neighbor_neighbor)] =
-            integrate_over_face (parallel_data, face, fe_face_values);
+          integrate_over_face (parallel_data, face, fe_face_values,
+                               face_integrals[neighbor_child->face(neighbor_neighbor)]);
         }
 
       // finally loop over all subfaces to collect the contributions of the
       // subfaces and store them with the mother face
-      std::vector<double> sum (n_solution_vectors, 0);
+      double *sum = face_integrals[face];
+      for (unsigned int n=0; n<n_solution_vectors; ++n)
+        sum[n] = 0;
       for (unsigned int subface_no=0; subface_no<face->n_children(); ++subface_no)
         {
-          Assert (local_face_integrals.find(face->child(subface_no)) !=
-                  local_face_integrals.end(),
-                  ExcInternalError());
-          Assert (local_face_integrals[face->child(subface_no)][0] >= 0,
+          Assert (face_integrals.is_set(face->child(subface_no)),
                   ExcInternalError());
 
+          const double *child_integral = face_integrals[face->child(subface_no)];
           for (unsigned int n=0; n<n_solution_vectors; ++n)
-            sum[n] += local_face_integrals[face->child(subface_no)][n];
+            sum[n] += child_integral[n];
         }
-
-      local_face_integrals[face] = sum;
     }
 
 
@@ -645,7 +665,7 @@ namespace internal
     void
     estimate_one_cell (const typename DH::active_cell_iterator &cell,
                        ParallelData<DH>                    &parallel_data,
-                       std::map<typename DH::face_iterator,std::vector<double> > &local_face_integrals,
+                       FaceIntegrals                       &face_integrals,
                        const std::vector<const InputVector *> &solutions)
     {
       const unsigned int dim = DH::dimension;
@@ -654,9 +674,6 @@ namespace internal
       const types::subdomain_id subdomain_id = parallel_data.subdomain_id;
       const unsigned int material_id  = parallel_data.material_id;
 
-      // empty our own copy of the local face integrals
-      local_face_integrals.clear();
-
       // loop over all faces of this cell
       for (unsigned int face_no=0;
            face_no<GeometryInfo<dim>::faces_per_cell; ++face_no)
@@ -693,8 +710,9 @@ namespace internal
               (parallel_data.neumann_bc->find(face->boundary_indicator()) ==
                parallel_data.neumann_bc->end()))
             {
-              local_face_integrals[face]
-                = std::vector<double> (n_solution_vectors, 0.);
+              double *face_integral = face_integrals[face];
+              for (unsigned int n=0; n<n_solution_vectors; ++n)
+                face_integral[n] = 0;
               continue;
             }
 
@@ -764,7 +782,7 @@ namespace internal
             // the integration of these both cases together
             integrate_over_regular_face (solutions,
                                          parallel_data,
-                                         local_face_integrals,
+                                         face_integrals,
                                          cell, face_no,
                                          parallel_data.fe_face_values_cell,
                                          parallel_data.fe_face_values_neighbor);
@@ -774,7 +792,7 @@ namespace internal
             // fit into the framework of the above function
             integrate_over_irregular_face (solutions,
                                            parallel_data,
-                                           local_face_integrals,
+                                           face_integrals,
                                            cell, face_no,
                                            parallel_data.fe_face_values_cell,
                                            parallel_data.fe_subface_values);
@@ -953,11 +971,12 @@ estimate (const Mapping<dim, spacedim>                  &mapping,
 
   const unsigned int n_solution_vectors = solutions.size();
 
-  // Map of integrals indexed by the corresponding face. In this map we store
-  // the integrated jump of the gradient for each face.  At the end of the
-  // function, we again loop over the cells and collect the contributions of
-  // the different faces of the cell.
-  std::map<typename DH::face_iterator,std::vector<double> > face_integrals;
+  // Array of integrals indexed by the index of the corresponding face. In
+  // this array we store the integrated jump of the gradient for each face.
+  // At the end of the function, we again loop over the cells and collect
+  // the contributions of the different faces of the cell.
+  internal::FaceIntegrals face_integrals (dof_handler.get_tria().n_raw_faces(),
+                                          n_solution_vectors);
 
   // all the data needed in the error estimator by each of the threads is
   // gathered in the following structures
@@ -973,17 +992,20 @@ estimate (const Mapping<dim, spacedim>                  &mapping,
                  &neumann_bc,
                  component_mask,
                  coefficients);
-  std::map<typename DH::face_iterator,std::vector<double> > sample_local_face_integrals;
 
-  // now let's work on all those cells:
+  // now let's work on all those cells. every face is computed by exactly
+  // one cell, which writes the result directly into its slot of
+  // face_integrals, so there is nothing to copy: the copier is empty and
+  // the worker ignores its (unused) copy data argument
   WorkStream::run (dof_handler.begin_active(),
                    static_cast<typename DH::active_cell_iterator>(dof_handler.end()),
                    std_cxx1x::bind (&internal::estimate_one_cell<InputVector,DH>,
-                                    std_cxx1x::_1, std_cxx1x::_2, std_cxx1x::_3, std_cxx1x::ref(solutions)),
-                   std_cxx1x::bind (&internal::copy_local_to_global<DH>,
-                                    std_cxx1x::_1, std_cxx1x::ref(face_integrals)),
+                                    std_cxx1x::_1, std_cxx1x::_2,
+                                    std_cxx1x::ref(face_integrals),
+                                    std_cxx1x::ref(solutions)),
+                   std_cxx1x::function<void (const unsigned int &)>(),
                    parallel_data,
-                   sample_local_face_integrals);
+                   static_cast<unsigned int>(0));
 
   // finally add up the contributions of the faces for each cell
 
@@ -1010,23 +1032,20 @@ estimate (const Mapping<dim, spacedim>                  &mapping,
           (cell->material_id() == material_id)))
       {
         // loop over all faces of this cell
+        const double factor = cell->diameter() / 24;
         for (unsigned int face_no=0; face_no<GeometryInfo<dim>::faces_per_cell;
              ++face_no)
           {
-            Assert(face_integrals.find(cell->face(face_no))
-                   != face_integrals.end(),
-                   ExcInternalError());
-            const double factor = cell->diameter() / 24;
-
+            const double *face_integral = face_integrals[cell->face(face_no)];
             for (unsigned int n=0; n<n_solution_vectors; ++n)
               {
                 // make sure that we have written a meaningful value into this
                 // slot
-                Assert (face_integrals[cell->face(face_no)][n] >= 0,
+                Assert (face_integral[n] >= 0,
                         ExcInternalError());
 
                 (*errors[n])(present_cell)
-                += (face_integrals[cell->face(face_no)][n] * factor);
+                += (face_integral[n] * factor);
               }
           }
 
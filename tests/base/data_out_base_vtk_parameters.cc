@@ -0,0 +1,67 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// read the flags of the VTU writer from an input file, once with the
+// default values and once with all of them changed
+
+
+#include "../tests.h"
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/parameter_handler.h>
+#include <deal.II/base/logstream.h>
+
+#include <fstream>
+
+
+void print (const DataOutBase::VtkFlags &flags)
+{
+  deallog << "print_date_and_time=" << flags.print_date_and_time
+          << " compression_level=" << flags.compression_level
+          << " filter_duplicate_vertices=" << flags.filter_duplicate_vertices
+          << " coordinate_precision="
+          << (flags.coordinate_precision == DataOutBase::VtkFlags::single_precision
+              ? "Float32" : "Float64")
+          << " data_precision="
+          << (flags.data_precision == DataOutBase::VtkFlags::single_precision
+              ? "Float32" : "Float64")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  ParameterHandler prm;
+  DataOutBase::VtkFlags::declare_parameters (prm);
+
+  DataOutBase::VtkFlags flags;
+  flags.parse_parameters (prm);
+  print (flags);
+
+  prm.read_input_from_string ("set Print date and time = false\n"
+                              "set Compression level = best speed\n"
+                              "set Filter duplicate vertices = true\n"
+                              "set Coordinate precision = Float32\n"
+                              "set Data precision = Float32\n");
+  flags.parse_parameters (prm);
+  print (flags);
+}
@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// write a patch that is so large that its points are split into several
+// compressed blocks by write_vtu, for all compression levels, and check
+// that decoding and decompressing the blocks yields the coordinates of the
+// points again
+
+#include "../tests.h"
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/logstream.h>
+
+#include <zlib.h>
+#include <stdint.h>
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+
+
+std::vector<unsigned char> decode_base64 (const std::string &encoded)
+{
+  static const std::string alphabet
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  std::vector<unsigned char> decoded;
+  unsigned int buffer = 0, n_bits = 0;
+  for (unsigned int i=0; i<encoded.size() && encoded[i] != '='; ++i)
+    {
+      buffer = (buffer << 6) | alphabet.find (encoded[i]);
+      n_bits += 6;
+      if (n_bits >= 8)
+        {
+          n_bits -= 8;
+          decoded.push_back ((buffer >> n_bits) & 0xff);
+        }
+    }
+  return decoded;
+}
+
+
+void check (const DataOutBase::VtkFlags::ZlibCompressionLevel level)
+{
+  const unsigned int n_subdivisions = 299;
+
+  std::vector<DataOutBase::Patch<2,2> > patches (1);
+  patches[0].n_subdivisions = n_subdivisions;
+  for (unsigned int v=0; v<GeometryInfo<2>::vertices_per_cell; ++v)
+    patches[0].vertices[v] = GeometryInfo<2>::unit_cell_vertex (v);
+  patches[0].data.reinit (1, (n_subdivisions+1)*(n_subdivisions+1));
+
+  std::vector<std::string> names (1, "u");
+  std::vector<std_cxx1x::tuple<unsigned int, unsigned int, std::string> > vectors;
+
+  DataOutBase::VtkFlags flags;
+  flags.compression_level = level;
+
+  std::ostringstream out;
+  DataOutBase::write_vtu (patches, names, vectors, flags, out);
+
+  // extract the encoded array of points
+  std::istringstream in (out.str());
+  std::string line;
+  while (std::getline (in, line))
+    if (line.find ("<Points>") != std::string::npos)
+      break;
+  std::getline (in, line);
+  std::string encoded;
+  std::getline (in, encoded);
+
+  // the header is encoded separately. its first entry is the number of
+  // blocks, which determines the length of the rest
+  const std::vector<unsigned char> first = decode_base64 (encoded.substr (0, 8));
+  uint32_t n_blocks;
+  std::memcpy (&n_blocks, &first[0], sizeof(n_blocks));
+  const unsigned int header_length = ((3+n_blocks)*4 + 2) / 3 * 4;
+
+  const std::vector<unsigned char> header_bytes
+    = decode_base64 (encoded.substr (0, header_length));
+  std::vector<uint32_t> header (3+n_blocks);
+  std::memcpy (&header[0], &header_bytes[0], header.size()*sizeof(uint32_t));
+
+  deallog << "blocks: " << header[0]
+          << ", block size: " << header[1]
+          << ", last block size: " << header[2]
+          << std::endl;
+
+  // decompress the blocks one after the other
+  const std::vector<unsigned char> compressed
+    = decode_base64 (encoded.substr (header_length));
+  std::vector<double> points;
+  std::size_t offset = 0;
+  for (unsigned int block=0; block<n_blocks; ++block)
+    {
+      uLongf size = (block == n_blocks-1 ? header[2] : header[1]);
+      std::vector<double> block_points (size / sizeof(double));
+      const int err = uncompress ((Bytef *) &block_points[0], &size,
+                                  &compressed[offset], header[3+block]);
+      Assert (err == Z_OK, ExcInternalError());
+      offset += header[3+block];
+      points.insert (points.end(), block_points.begin(), block_points.end());
+    }
+  Assert (offset == compressed.size(), ExcInternalError());
+
+  // compare with the locations of the points
+  Assert (points.size() == 3*(n_subdivisions+1)*(n_subdivisions+1),
+          ExcInternalError());
+  for (unsigned int j=0; j<=n_subdivisions; ++j)
+    for (unsigned int i=0; i<=n_subdivisions; ++i)
+      {
+        const double *p = &points[3*(j*(n_subdivisions+1)+i)];
+        Assert (std::fabs (p[0] - 1.*i/n_subdivisions) < 1e-12, ExcInternalError());
+        Assert (std::fabs (p[1] - 1.*j/n_subdivisions) < 1e-12, ExcInternalError());
+        Assert (p[2] == 0, ExcInternalError());
+      }
+
+  deallog << "OK" << std::endl;
+}
+
+
+int main()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  check (DataOutBase::VtkFlags::no_compression);
+  check (DataOutBase::VtkFlags::best_speed);
+  check (DataOutBase::VtkFlags::best_compression);
+  check (DataOutBase::VtkFlags::default_compression);
+}
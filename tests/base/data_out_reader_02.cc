@@ -0,0 +1,147 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include "../tests.h"
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/logstream.h>
+
+#include <vector>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "patches.h"
+
+// test the binary version of the intermediate format: reading it back
+// must give the same patches as reading the text version, and
+// DataOutReader::write_merged_vtu must produce one piece per file,
+// regardless of the format the files were written in
+
+unsigned int count (const std::string &s, const std::string &what)
+{
+  unsigned int n = 0;
+  for (std::string::size_type p = s.find (what); p != std::string::npos;
+       p = s.find (what, p+1))
+    ++n;
+  return n;
+}
+
+
+template <int dim, int spacedim>
+void check()
+{
+  const unsigned int np = 4;
+
+  std::vector<DataOutBase::Patch<dim, spacedim> > patches(np);
+
+  create_patches(patches);
+
+  std::vector<std::string> names(5);
+  names[0] = "x1";
+  names[1] = "x2";
+  names[2] = "x3";
+  names[3] = "x4";
+  names[4] = "i";
+  std::vector<std_cxx1x::tuple<unsigned int, unsigned int, std::string> > vectors;
+  if (spacedim > 1)
+    vectors.push_back (std_cxx1x::tuple<unsigned int, unsigned int, std::string>
+                       (0, spacedim-1, "vector data"));
+
+  std::ostringstream text_data;
+  DataOutBase::write_deal_II_intermediate(patches, names, vectors,
+                                          DataOutBase::Deal_II_IntermediateFlags(false),
+                                          text_data);
+  std::ostringstream binary_data;
+  DataOutBase::write_deal_II_intermediate(patches, names, vectors,
+                                          DataOutBase::Deal_II_IntermediateFlags(true),
+                                          binary_data);
+
+  // the binary file must identify its dimensions like the text file
+  {
+    std::istringstream input(binary_data.str());
+    const std::pair<unsigned int, unsigned int> dims
+      = DataOutBase::determine_intermediate_format_dimensions (input);
+    deallog << dim << ' ' << spacedim
+            << ": dimensions of the binary file " << dims.first
+            << ' ' << dims.second << std::endl;
+  }
+
+  // reading either file and writing it as text again must give the
+  // same result
+  DataOutReader<dim,spacedim> text_reader, binary_reader;
+  {
+    std::istringstream input(text_data.str());
+    text_reader.read (input);
+  }
+  {
+    std::istringstream input(binary_data.str());
+    binary_reader.read (input);
+  }
+  std::ostringstream from_text, from_binary;
+  text_reader.write_deal_II_intermediate (from_text);
+  binary_reader.write_deal_II_intermediate (from_binary);
+  deallog << dim << ' ' << spacedim
+          << ": text and binary file read back "
+          << (from_text.str() == from_binary.str() ? "identically" : "differently")
+          << ", " << from_text.str().size() << " characters" << std::endl;
+
+  // merge two binary files and a text file into a single VTU file and
+  // compare with the VTU file written for all patches at once
+  std::vector<std::string> filenames;
+  for (unsigned int i=0; i<3; ++i)
+    {
+      std::ostringstream filename;
+      filename << "piece-" << i;
+      filenames.push_back (filename.str());
+
+      std::ofstream out (filename.str().c_str(), std::ios::out | std::ios::binary);
+      if (i == 2)
+        out << text_data.str();
+      else
+        out << binary_data.str();
+    }
+
+  std::ostringstream merged;
+  DataOutReader<dim,spacedim>::write_merged_vtu (filenames, merged);
+  for (unsigned int i=0; i<filenames.size(); ++i)
+    std::remove (filenames[i].c_str());
+
+  std::ostringstream single;
+  DataOutBase::write_vtu (patches, names, vectors, DataOutBase::VtkFlags(),
+                          single);
+
+  deallog << dim << ' ' << spacedim
+          << ": pieces " << count (merged.str(), "<Piece ")
+          << ", data arrays " << count (merged.str(), "<DataArray")
+          << " vs. " << 3 * count (single.str(), "<DataArray")
+          << std::endl;
+}
+
+
+int main()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+
+  check<1,1>();
+  check<1,2>();
+  check<2,2>();
+  check<2,3>();
+  check<3,3>();
+}
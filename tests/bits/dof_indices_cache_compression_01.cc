@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DoFHandler::set_compressed_dof_indices_cache: the cache must actually
+// be stored in compressed form, and the DoF indices and values read and
+// written through cell accessors must be the same with and without
+// compression of the cache, also after renumbering and after switching the
+// compression off again. the element with more than
+// CellDoFIndicesScratch::max_stack_dofs degrees of freedom per cell tests the
+// case where the indices of a cell do not fit into the fixed-size buffer
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <fstream>
+#include <vector>
+
+
+
+template <int dim>
+bool compare (const DoFHandler<dim> &dof_1,
+              const DoFHandler<dim> &dof_2)
+{
+  Vector<double> values (dof_1.n_dofs());
+  for (unsigned int i=0; i<values.size(); ++i)
+    values(i) = i;
+
+  const unsigned int dofs_per_cell = dof_1.get_fe().dofs_per_cell;
+  std::vector<types::global_dof_index> indices_1 (dofs_per_cell),
+      indices_2 (dofs_per_cell);
+  Vector<double> values_1 (dofs_per_cell), values_2 (dofs_per_cell);
+  Vector<double> sum_1 (dof_1.n_dofs()), sum_2 (dof_2.n_dofs());
+  typename DoFHandler<dim>::active_cell_iterator
+  cell_1 = dof_1.begin_active(),
+  cell_2 = dof_2.begin_active();
+  for (; cell_1 != dof_1.end(); ++cell_1, ++cell_2)
+    {
+      cell_1->get_dof_indices (indices_1);
+      cell_2->get_dof_indices (indices_2);
+      cell_1->get_dof_values (values, values_1);
+      cell_2->get_dof_values (values, values_2);
+      if (indices_1 != indices_2)
+        return false;
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        if (values_1(i) != values_2(i) || values_1(i) != indices_1[i])
+          return false;
+
+      cell_1->distribute_local_to_global (values_1, sum_1);
+      cell_2->distribute_local_to_global (values_2, sum_2);
+    }
+
+  for (unsigned int i=0; i<sum_1.size(); ++i)
+    if (sum_1(i) != sum_2(i))
+      return false;
+  return true;
+}
+
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe)
+{
+  deallog << fe.get_name() << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement ();
+
+  DoFHandler<dim> dof (tria), dof_compressed (tria);
+  dof.distribute_dofs (fe);
+  dof_compressed.set_compressed_dof_indices_cache (true);
+  dof_compressed.distribute_dofs (fe);
+
+  deallog << "After distribute_dofs: "
+          << (compare (dof, dof_compressed) ? "OK" : "Failed")
+          << ", compressed: " << dof.dof_indices_cache_is_compressed()
+          << ' ' << dof_compressed.dof_indices_cache_is_compressed()
+          << std::endl;
+
+  DoFRenumbering::Cuthill_McKee (dof);
+  DoFRenumbering::Cuthill_McKee (dof_compressed);
+  deallog << "After renumbering: "
+          << (compare (dof, dof_compressed) ? "OK" : "Failed")
+          << ", compressed: " << dof.dof_indices_cache_is_compressed()
+          << ' ' << dof_compressed.dof_indices_cache_is_compressed()
+          << std::endl;
+
+  dof_compressed.set_compressed_dof_indices_cache (false);
+  deallog << "After uncompressing: "
+          << (compare (dof, dof_compressed) ? "OK" : "Failed")
+          << ", compressed: " << dof.dof_indices_cache_is_compressed()
+          << ' ' << dof_compressed.dof_indices_cache_is_compressed()
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test (FESystem<1>(FE_Q<1>(2), 2, FE_Q<1>(1), 1));
+  test (FESystem<2>(FE_Q<2>(2), 2, FE_Q<2>(1), 1));
+  test (FESystem<3>(FE_Q<3>(2), 2, FE_Q<3>(1), 1));
+  test (FE_Q<2>(12));
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DataOutInterface::write_vtu_in_background: rebuild the patches of
+// a DataOut object for a sequence of "time steps" while earlier output is
+// still being written, and make sure every file contains exactly what
+// write_vtu generated for the data at the time the output was started.
+// also make sure that a file that can not be opened is reported to the
+// caller rather than on the background task
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (5-dim);
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+
+  DataOut<dim> data_out;
+  data_out.set_flags (DataOutBase::VtkFlags (std::numeric_limits<double>::min(),
+                                             std::numeric_limits<unsigned int>::min(),
+                                             false));
+
+  const unsigned int n_steps = 5;
+  std::vector<std::string> expected (n_steps);
+  std::vector<std::string> filenames (n_steps);
+  for (unsigned int step=0; step<n_steps; ++step)
+    {
+      for (unsigned int i=0; i<solution.size(); ++i)
+        solution(i) = step + 1.*i/solution.size();
+
+      data_out.clear ();
+      data_out.attach_dof_handler (dof_handler);
+      data_out.add_data_vector (solution, "solution");
+      data_out.build_patches (2);
+
+      std::ostringstream reference;
+      data_out.write_vtu (reference);
+      expected[step] = reference.str();
+
+      filenames[step] = "output-" + Utilities::int_to_string (dim) +
+                        "-" + Utilities::int_to_string (step) + ".vtu";
+      data_out.write_vtu_in_background (filenames[step]);
+    }
+
+  data_out.wait_for_background_output ();
+
+  for (unsigned int step=0; step<n_steps; ++step)
+    {
+      std::ifstream in (filenames[step].c_str());
+      std::ostringstream written;
+      written << in.rdbuf();
+
+      deallog << "dim=" << dim << ", step " << step << ": "
+              << (written.str() == expected[step] ? "identical" : "different")
+              << std::endl;
+    }
+
+  try
+    {
+      data_out.write_vtu_in_background ("no-such-directory/output.vtu");
+      deallog << "dim=" << dim << ", missing directory: no exception"
+              << std::endl;
+    }
+  catch (const ExceptionBase &)
+    {
+      deallog << "dim=" << dim << ", missing directory: exception caught"
+              << std::endl;
+    }
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<1>();
+  test<2>();
+  test<3>();
+
+  return 0;
+}
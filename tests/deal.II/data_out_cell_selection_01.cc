@@ -0,0 +1,210 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+
+// check the cell selection functions of DataOut: restriction to a box and
+// to a material id, output on a coarser level with interpolated values,
+// and a number of subdivisions that depends on the size of the cell. the
+// solution is linear, so its values on the patches must be exact in all
+// cases
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/function.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+
+
+template <int dim>
+class LinearFunction : public Function<dim>
+{
+public:
+  double value (const Point<dim> &p,
+                const unsigned int /*component*/ = 0) const
+  {
+    double v = 0;
+    for (unsigned int d=0; d<dim; ++d)
+      v += (d+1) * p[d];
+    return v;
+  }
+};
+
+
+
+// give access to the patches
+template <int dim>
+class TestDataOut : public DataOut<dim>
+{
+public:
+  const std::vector<DataOutBase::Patch<dim,dim> > &
+  patches () const
+  {
+    return this->get_patches();
+  }
+};
+
+
+
+template <int dim>
+unsigned int subdivisions_by_size (const typename Triangulation<dim>::cell_iterator &cell)
+{
+  return (cell->diameter() > 0.3 ? 3 : 1);
+}
+
+
+
+template <int dim>
+void check (const TestDataOut<dim> &data_out,
+            const std::string      &name)
+{
+  const std::vector<DataOutBase::Patch<dim,dim> > &patches = data_out.patches();
+
+  // the patches of the cells on the unit cube are axis-parallel, so the
+  // location of the points of a patch can be computed from its vertices
+  std::map<unsigned int, unsigned int> n_patches;
+  double max_error = 0;
+  for (unsigned int p=0; p<patches.size(); ++p)
+    {
+      const unsigned int n = patches[p].n_subdivisions;
+      ++n_patches[n];
+
+      for (unsigned int q=0; q<patches[p].data.n_cols(); ++q)
+        {
+          Point<dim> x = patches[p].vertices[0];
+          for (unsigned int d=0, stride=1; d<dim; ++d, stride*=(n+1))
+            x += (1.*((q/stride)%(n+1))/n) *
+                 (patches[p].vertices[1<<d] - patches[p].vertices[0]);
+          max_error = std::max (max_error,
+                                std::fabs (patches[p].data(0,q) -
+                                           LinearFunction<dim>().value(x)));
+        }
+
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (patches[p].neighbors[f] != numbers::invalid_unsigned_int)
+          Assert (patches[patches[p].neighbors[f]].n_subdivisions == n,
+                  ExcInternalError());
+    }
+
+  deallog << name << ":";
+  for (std::map<unsigned int, unsigned int>::const_iterator
+       p = n_patches.begin(); p != n_patches.end(); ++p)
+    deallog << ' ' << p->second << " patches with " << p->first
+            << " subdivisions";
+  // the patches store their data in single precision
+  deallog << (max_error < 1e-6 ? ", values exact" : ", values wrong")
+          << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  tria.begin_active()->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (cell->center()[0] < 0.5)
+      cell->set_material_id (1);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  VectorTools::interpolate (dof_handler, LinearFunction<dim>(), solution);
+
+  TestDataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, "solution");
+
+  data_out.build_patches ();
+  check (data_out, "all cells");
+
+  data_out.select_cells_with_material_id (1);
+  data_out.build_patches ();
+  check (data_out, "material id 1");
+
+  Point<dim> p1, p2;
+  for (unsigned int d=0; d<dim; ++d)
+    p2[d] = 0.3;
+  data_out.select_cells_in_box (p2, p1);
+  data_out.build_patches ();
+  check (data_out, "box");
+
+  data_out.clear_cell_selection ();
+  data_out.set_output_level (1);
+  data_out.build_patches (2);
+  check (data_out, "level 1");
+
+  data_out.select_cells_in_box (p1, p2);
+  data_out.build_patches ();
+  check (data_out, "level 1 in box");
+
+  data_out.clear_cell_selection ();
+  data_out.set_cell_subdivisions (&subdivisions_by_size<dim>);
+  data_out.build_patches ();
+  check (data_out, "subdivisions by size");
+
+  std::ostringstream vtu;
+  data_out.write_vtu_in_pieces (vtu, MappingQ1<dim>());
+  unsigned int n_pieces = 0;
+  for (std::string::size_type p = vtu.str().find ("<Piece "); p != std::string::npos;
+       p = vtu.str().find ("<Piece ", p+1))
+    ++n_pieces;
+  deallog << "pieces: " << n_pieces << std::endl;
+
+  data_out.clear_cell_selection ();
+  data_out.build_patches ();
+  check (data_out, "cleared");
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<2>();
+  test<3>();
+
+  return 0;
+}
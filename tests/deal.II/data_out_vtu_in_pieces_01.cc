@@ -0,0 +1,122 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+
+// check DataOut::write_vtu_in_pieces: the cells must be distributed to
+// pieces of the requested size that together contain all points and
+// cells, and with a single piece the output must be the same as that of
+// build_patches() followed by write_vtu()
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+
+// sum up the values of the given attribute over all <Piece> elements
+unsigned int sum_attribute (const std::string &vtu,
+                            const std::string &name,
+                            unsigned int      &n_pieces)
+{
+  unsigned int sum = 0;
+  n_pieces = 0;
+  for (std::string::size_type p = vtu.find ("<Piece "); p != std::string::npos;
+       p = vtu.find ("<Piece ", p+1))
+    {
+      const std::string::size_type begin = vtu.find (name + "=\"", p) + name.size() + 2;
+      sum += std::atoi (vtu.substr (begin, vtu.find ('"', begin) - begin).c_str());
+      ++n_pieces;
+    }
+  return sum;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (dim<3 ? 2 : 1);
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  for (unsigned int i=0; i<solution.size(); ++i)
+    solution(i) = i;
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, "solution");
+  data_out.set_flags (DataOutBase::VtkFlags (std::numeric_limits<double>::min(),
+                                             std::numeric_limits<unsigned int>::min(),
+                                             false));
+
+  std::ostringstream pieces;
+  data_out.write_vtu_in_pieces (pieces, MappingQ1<dim>(), 2, 3);
+  unsigned int n_pieces;
+  const unsigned int n_points = sum_attribute (pieces.str(), "NumberOfPoints", n_pieces);
+  const unsigned int n_cells = sum_attribute (pieces.str(), "NumberOfCells", n_pieces);
+  deallog << "dim=" << dim
+          << ": pieces=" << n_pieces
+          << ", points=" << n_points
+          << ", cells=" << n_cells
+          << std::endl;
+
+  std::ostringstream single_piece;
+  data_out.write_vtu_in_pieces (single_piece, MappingQ1<dim>(), 2,
+                                tria.n_active_cells(),
+                                DataOut<dim>::no_curved_cells);
+
+  data_out.build_patches (2);
+  std::ostringstream reference;
+  data_out.write_vtu (reference);
+
+  deallog << "dim=" << dim << ": "
+          << (single_piece.str() == reference.str() ? "identical" : "different")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<1>();
+  test<2>();
+  test<3>();
+
+  return 0;
+}
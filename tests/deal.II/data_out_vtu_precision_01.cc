@@ -0,0 +1,117 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+
+// check the precision settings of VtkFlags: coordinates and fields must be
+// declared with the requested data types in VTU files and pvtu records
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+// return the value of the given attribute in the line, or an empty string
+std::string get_attribute (const std::string &line,
+                           const std::string &name)
+{
+  const std::string::size_type p = line.find (" " + name + "=\"");
+  if (p == std::string::npos)
+    return "";
+  const std::string::size_type begin = p + name.size() + 3;
+  return line.substr (begin, line.find ('"', begin) - begin);
+}
+
+
+
+// print the type and name of all data arrays
+void print_data_arrays (const std::string &vtu)
+{
+  std::istringstream in (vtu);
+  std::string line;
+  while (std::getline (in, line))
+    if (line.find ("DataArray type=") != std::string::npos)
+      deallog << get_attribute (line, "type") << ' '
+              << get_attribute (line, "Name") << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (1);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> a (dof_handler.n_dofs()), b (dof_handler.n_dofs());
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (a, "a");
+  data_out.add_data_vector (b, "b");
+  data_out.build_patches ();
+
+  DataOutBase::VtkFlags flags (std::numeric_limits<double>::min(),
+                               std::numeric_limits<unsigned int>::min(),
+                               false);
+  flags.coordinate_precision = DataOutBase::VtkFlags::single_precision;
+  flags.data_precision = DataOutBase::VtkFlags::single_precision;
+  flags.field_precision["b"] = DataOutBase::VtkFlags::double_precision;
+  data_out.set_flags (flags);
+
+  deallog << "dim=" << dim << std::endl;
+
+  std::ostringstream vtu;
+  data_out.write_vtu (vtu);
+  print_data_arrays (vtu.str());
+
+  std::ostringstream pvtu;
+  data_out.write_pvtu_record (pvtu, std::vector<std::string>(1, "piece.vtu"));
+  print_data_arrays (pvtu.str());
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<1>();
+  test<2>();
+  test<3>();
+
+  return 0;
+}
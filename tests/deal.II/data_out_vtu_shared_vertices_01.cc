@@ -0,0 +1,101 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+
+// check VtkFlags::filter_duplicate_vertices: with the flag set, every
+// vertex of the mesh must be written exactly once to VTU files, while the
+// number of cells stays the same
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+
+// extract the value of the given attribute of the <Piece> element
+std::string get_attribute (const std::string &vtu,
+                           const std::string &name)
+{
+  const std::string::size_type begin = vtu.find (name + "=\"") + name.size() + 2;
+  return vtu.substr (begin, vtu.find ('"', begin) - begin);
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  for (unsigned int i=0; i<solution.size(); ++i)
+    solution(i) = i;
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, "solution");
+  data_out.build_patches ();
+
+  for (unsigned int filter=0; filter<2; ++filter)
+    {
+      data_out.set_flags (DataOutBase::VtkFlags (std::numeric_limits<double>::min(),
+                                                 std::numeric_limits<unsigned int>::min(),
+                                                 false,
+                                                 DataOutBase::VtkFlags::best_compression,
+                                                 filter == 1));
+      std::ostringstream out;
+      data_out.write_vtu (out);
+
+      deallog << "dim=" << dim
+              << ", filter=" << filter
+              << ": points=" << get_attribute (out.str(), "NumberOfPoints")
+              << ", cells=" << get_attribute (out.str(), "NumberOfCells")
+              << std::endl;
+    }
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<1>();
+  test<2>();
+  test<3>();
+
+  return 0;
+}
@@ -0,0 +1,160 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// DoFHandler::distribute_dofs numbers the degrees of freedom on chunks
+// of cells in parallel. check on adaptively refined meshes with many
+// chunks that the result is the sequential numbering: walking over the
+// active cells and their degrees of freedom in order, every index that
+// has not been seen before is the next one. also check that the
+// numbering does not depend on the number of threads, and that the user
+// flags of the triangulation are left alone
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_system.h>
+
+#ifdef DEAL_II_WITH_THREADS
+#  include <tbb/task_scheduler_init.h>
+#endif
+
+#include <fstream>
+#include <vector>
+
+
+
+template <int dim>
+void distribute (DoFHandler<dim>          &dof_handler,
+                 const FiniteElement<dim> &fe,
+                 const bool                single_thread)
+{
+#ifdef DEAL_II_WITH_THREADS
+  // the tasks spawned by this thread only run on this thread
+  tbb::task_scheduler_init init (single_thread ? 1 :
+                                 tbb::task_scheduler_init::automatic);
+#else
+  (void)single_thread;
+#endif
+
+  dof_handler.distribute_dofs (fe);
+}
+
+
+
+template <int dim>
+void check (const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube (tr);
+  tr.refine_global (8/dim);
+  for (unsigned int step=0; step<2; ++step)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tr.begin_active(); cell != tr.end(); ++cell, ++index)
+        if (index % 5 == 0)
+          cell->set_refine_flag ();
+      tr.execute_coarsening_and_refinement ();
+    }
+
+  // set the user flag on every other cell
+  tr.clear_user_flags ();
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::cell_iterator
+       cell = tr.begin(); cell != tr.end(); ++cell, ++index)
+    if (index % 2 == 0)
+      cell->set_user_flag ();
+
+  DoFHandler<dim> dof_handler (tr);
+  distribute (dof_handler, fe, false);
+
+  DoFHandler<dim> dof_handler_1 (tr);
+  Threads::Thread<> thread
+    = Threads::new_thread (&distribute<dim>, dof_handler_1, fe, true);
+  thread.join ();
+
+  std::vector<bool> seen (dof_handler.n_dofs(), false);
+  types::global_dof_index n_seen = 0;
+  unsigned int n_wrong = 0, n_different = 0;
+  std::vector<types::global_dof_index> dof_indices (fe.dofs_per_cell),
+      dof_indices_1 (fe.dofs_per_cell);
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(), cell_1 = dof_handler_1.begin_active();
+       cell != dof_handler.end(); ++cell, ++cell_1)
+    {
+      cell->get_dof_indices (dof_indices);
+      cell_1->get_dof_indices (dof_indices_1);
+      if (dof_indices != dof_indices_1)
+        ++n_different;
+
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        if (seen[dof_indices[i]] == false)
+          {
+            if (dof_indices[i] != n_seen)
+              ++n_wrong;
+            seen[dof_indices[i]] = true;
+            ++n_seen;
+          }
+    }
+
+  unsigned int n_user_flags_changed = 0;
+  index = 0;
+  for (typename Triangulation<dim>::cell_iterator
+       cell = tr.begin(); cell != tr.end(); ++cell, ++index)
+    if (cell->user_flag_set() != (index % 2 == 0))
+      ++n_user_flags_changed;
+
+  deallog << fe.get_name() << ": " << tr.n_active_cells() << " cells, "
+          << dof_handler.n_dofs() << " dofs, "
+          << n_seen << " seen, "
+          << n_wrong << " out of order, "
+          << n_different << " cells numbered differently with one thread, "
+          << n_user_flags_changed << " user flags changed"
+          << std::endl;
+}
+
+
+
+template <int dim>
+void check ()
+{
+  check (FE_Q<dim>(2));
+  check (FESystem<dim> (FE_Q<dim>(2), 2, FE_DGQ<dim>(1), 1));
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  check<1> ();
+  check<2> ();
+  check<3> ();
+}
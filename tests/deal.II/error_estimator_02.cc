@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// the workers of the Kelly estimator write the face integrals directly
+// into a shared array. make sure that the estimate on an adaptively
+// refined mesh, for several solution vectors, does not depend on the
+// number of threads: compute it once on a thread whose task scheduler
+// only allows one thread, and once with the default number of threads
+
+
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/function_lib.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/numerics/error_estimator.h>
+
+#ifdef DEAL_II_WITH_THREADS
+#  include <tbb/task_scheduler_init.h>
+#endif
+
+#include <fstream>
+
+
+template <int dim>
+void
+estimate (const DoFHandler<dim>                     &dof,
+          const std::vector<const Vector<double> *> &solutions,
+          std::vector<Vector<float> *>              &errors,
+          const bool                                 single_thread)
+{
+#ifdef DEAL_II_WITH_THREADS
+  // the tasks spawned by this thread only run on this thread
+  tbb::task_scheduler_init init (single_thread ? 1 :
+                                 tbb::task_scheduler_init::automatic);
+#else
+  (void)single_thread;
+#endif
+
+  typename FunctionMap<dim>::type neumann_bc;
+  KellyErrorEstimator<dim>::estimate (dof, QGauss<dim-1>(3), neumann_bc,
+                                      solutions, errors);
+}
+
+
+
+template <int dim>
+void
+check ()
+{
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube(tr, -1, 1);
+  tr.refine_global (2);
+  for (unsigned int step=0; step<2; ++step)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tr.begin_active(); cell != tr.end(); ++cell, ++index)
+        if (index % 3 == 0)
+          cell->set_refine_flag ();
+      tr.execute_coarsening_and_refinement ();
+    }
+
+  FESystem<dim> element (FE_Q<dim>(2), 2);
+  DoFHandler<dim> dof(tr);
+  dof.distribute_dofs(element);
+
+  Functions::CosineFunction<dim> cosine (2);
+  Vector<double> v1 (dof.n_dofs()), v2 (dof.n_dofs());
+  VectorTools::interpolate (dof, cosine, v1);
+  for (unsigned int i=0; i<v2.size(); ++i)
+    v2(i) = v1(i) * v1(i) + 0.1 * (i % 7);
+
+  std::vector<const Vector<double> *> solutions (2);
+  solutions[0] = &v1;
+  solutions[1] = &v2;
+
+  Vector<float> error_1a (tr.n_active_cells()), error_1b (tr.n_active_cells());
+  Vector<float> error_na (tr.n_active_cells()), error_nb (tr.n_active_cells());
+  std::vector<Vector<float> *> errors_1 (2), errors_n (2);
+  errors_1[0] = &error_1a;
+  errors_1[1] = &error_1b;
+  errors_n[0] = &error_na;
+  errors_n[1] = &error_nb;
+
+  Threads::Thread<> thread
+    = Threads::new_thread (&estimate<dim>, dof, solutions, errors_1, true);
+  thread.join ();
+  estimate (dof, solutions, errors_n, false);
+
+  deallog << tr.n_active_cells() << " cells, "
+          << dof.n_dofs() << " dofs" << std::endl;
+  deallog << "estimate: " << error_1a.l2_norm() << ' '
+          << error_1b.l2_norm() << std::endl;
+
+  error_na -= error_1a;
+  error_nb -= error_1b;
+  deallog << "difference: " << error_na.linfty_norm() << ' '
+          << error_nb.linfty_norm() << std::endl;
+}
+
+
+int main ()
+{
+  std::ofstream logfile ("output");
+  deallog << std::setprecision (4);
+  deallog.attach(logfile);
+  deallog.depth_console (0);
+  deallog.threshold_double(1.e-10);
+
+  check<2> ();
+  check<3> ();
+}
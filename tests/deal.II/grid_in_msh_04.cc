@@ -0,0 +1,183 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// read the same mesh from a version 2 MSH file in ASCII and in binary
+// form, once with consecutive and once with sparse vertex numbers, and
+// check that the same triangulation results
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_in.h>
+#include <deal.II/base/logstream.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+std::ofstream logfile("output");
+
+
+// two quads with material ids 7 and 8, six boundary lines and one node
+const double node_coordinates[6][2]
+= { {0,0}, {1,0}, {2,0}, {0,1}, {1,1}, {2,1} };
+const int quads[2][5]
+= { {7, 1,2,5,4}, {8, 2,3,6,5} };
+const int lines[6][3]
+= { {1, 1,2}, {1, 2,3}, {2, 3,6}, {3, 6,5}, {3, 5,4}, {4, 4,1} };
+
+
+template <typename T>
+void write_binary (std::ostream &out, const T &t)
+{
+  out.write (reinterpret_cast<const char *>(&t), sizeof(t));
+}
+
+
+void write_msh (std::ostream &out,
+                const bool binary,
+                const int vertex_number_stride)
+{
+  out << "$MeshFormat\n2.2 " << (binary ? 1 : 0) << ' ' << sizeof(double) << '\n';
+  if (binary)
+    {
+      write_binary (out, 1);
+      out << '\n';
+    }
+  out << "$EndMeshFormat\n";
+
+  out << "$Nodes\n6\n";
+  for (unsigned int i=0; i<6; ++i)
+    if (binary)
+      {
+        write_binary (out, static_cast<int>((i+1)*vertex_number_stride));
+        write_binary (out, node_coordinates[i][0]);
+        write_binary (out, node_coordinates[i][1]);
+        write_binary (out, 0.);
+      }
+    else
+      out << (i+1)*vertex_number_stride << ' '
+          << node_coordinates[i][0] << ' ' << node_coordinates[i][1] << " 0\n";
+  if (binary)
+    out << '\n';
+  out << "$EndNodes\n";
+
+  out << "$Elements\n9\n";
+  if (binary)
+    {
+      // one block per element type, each with two tags
+      const int point_header[3] = { 15, 1, 2 };
+      for (unsigned int i=0; i<3; ++i)
+        write_binary (out, point_header[i]);
+      write_binary (out, 1);
+      write_binary (out, 0);
+      write_binary (out, 0);
+      write_binary (out, vertex_number_stride);
+
+      const int line_header[3] = { 1, 6, 2 };
+      for (unsigned int i=0; i<3; ++i)
+        write_binary (out, line_header[i]);
+      for (unsigned int l=0; l<6; ++l)
+        {
+          write_binary (out, static_cast<int>(l+2));
+          write_binary (out, lines[l][0]);
+          write_binary (out, 0);
+          for (unsigned int v=1; v<3; ++v)
+            write_binary (out, lines[l][v]*vertex_number_stride);
+        }
+
+      const int quad_header[3] = { 3, 2, 2 };
+      for (unsigned int i=0; i<3; ++i)
+        write_binary (out, quad_header[i]);
+      for (unsigned int q=0; q<2; ++q)
+        {
+          write_binary (out, static_cast<int>(q+8));
+          write_binary (out, quads[q][0]);
+          write_binary (out, 0);
+          for (unsigned int v=1; v<5; ++v)
+            write_binary (out, quads[q][v]*vertex_number_stride);
+        }
+      out << '\n';
+    }
+  else
+    {
+      out << "1 15 2 0 0 " << vertex_number_stride << '\n';
+      for (unsigned int l=0; l<6; ++l)
+        out << l+2 << " 1 2 " << lines[l][0] << " 0 "
+            << lines[l][1]*vertex_number_stride << ' '
+            << lines[l][2]*vertex_number_stride << '\n';
+      for (unsigned int q=0; q<2; ++q)
+        {
+          out << q+8 << " 3 2 " << quads[q][0] << " 0";
+          for (unsigned int v=1; v<5; ++v)
+            out << ' ' << quads[q][v]*vertex_number_stride;
+          out << '\n';
+        }
+    }
+  out << "$EndElements\n";
+}
+
+
+
+std::string read_and_describe (const bool binary,
+                               const int vertex_number_stride)
+{
+  std::stringstream file;
+  write_msh (file, binary, vertex_number_stride);
+
+  Triangulation<2> tria;
+  GridIn<2> gi;
+  gi.attach_triangulation (tria);
+  gi.read_msh (file);
+
+  std::ostringstream description;
+  description << tria.n_vertices() << " vertices, "
+              << tria.n_active_cells() << " cells" << std::endl;
+  for (Triangulation<2>::active_cell_iterator cell = tria.begin_active();
+       cell != tria.end(); ++cell)
+    {
+      description << "cell at " << cell->center()
+                  << ", material " << static_cast<int>(cell->material_id())
+                  << ", boundary ids";
+      for (unsigned int f=0; f<GeometryInfo<2>::faces_per_cell; ++f)
+        if (cell->at_boundary(f))
+          description << ' ' << static_cast<int>(cell->face(f)->boundary_indicator());
+      description << std::endl;
+    }
+  return description.str();
+}
+
+
+
+int main ()
+{
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  for (int stride=1; stride<=10; stride+=9)
+    {
+      const std::string ascii = read_and_describe (false, stride);
+      const std::string binary = read_and_describe (true, stride);
+      Assert (ascii == binary, ExcInternalError());
+
+      deallog << "vertex number stride " << stride << std::endl;
+      deallog.get_file_stream() << ascii;
+    }
+}
@@ -0,0 +1,93 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check GridReordering::is_consistent: the cells of a mesh generated
+// by GridGenerator are consistently oriented, rotating one of them
+// breaks this, and reorder_cells() repairs it again
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_reordering.h>
+
+#include <fstream>
+#include <vector>
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube (tria, 3);
+
+  std::vector<CellData<dim> > cells (tria.n_active_cells());
+  unsigned int c = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell, ++c)
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      cells[c].vertices[v] = cell->vertex_index(v);
+
+  deallog << "dim=" << dim << std::endl;
+  deallog << "generated mesh: "
+          << GridReordering<dim>::is_consistent (cells, true) << std::endl;
+
+  // rotate the middle cell by 90 degrees around the z-axis
+  const unsigned int rotation[8] = { 1, 3, 0, 2, 5, 7, 4, 6 };
+  CellData<dim> &middle = cells[cells.size()/2];
+  const CellData<dim> original = middle;
+  for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+    middle.vertices[v] = original.vertices[rotation[v]];
+  deallog << "rotated cell: "
+          << GridReordering<dim>::is_consistent (cells, true) << std::endl;
+
+  GridReordering<dim>::reorder_cells (cells, true);
+  deallog << "reordered: "
+          << GridReordering<dim>::is_consistent (cells, true) << std::endl;
+
+  // the old-style numbering of the same cells is consistent as well
+  for (unsigned int c=0; c<cells.size(); ++c)
+    if (dim == 2)
+      std::swap (cells[c].vertices[2], cells[c].vertices[3]);
+    else
+      {
+        const CellData<dim> new_style = cells[c];
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          cells[c].vertices[v] = new_style.vertices[GeometryInfo<dim>::ucd_to_deal[v]];
+      }
+  deallog << "old-style numbering: "
+          << GridReordering<dim>::is_consistent (cells) << std::endl;
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<2> ();
+  test<3> ();
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DoFHandler::redistribute_dofs: after refining and coarsening some
+// cells, the degrees of freedom on cells that did not change must be
+// numbered as given by the returned map, the kept degrees of freedom must
+// come first, and the result must be a complete numbering of the same size
+// as the one distribute_dofs() generates
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+
+
+template <int dim>
+void check (const DoFHandler<dim> &dof_handler,
+            const std::map<CellId,std::vector<types::global_dof_index> > &old_indices,
+            const std::vector<types::global_dof_index> &old_to_new)
+{
+  const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+
+  // the kept degrees of freedom are numbered first, in their old order
+  types::global_dof_index n_kept = 0;
+  for (unsigned int i=0; i<old_to_new.size(); ++i)
+    if (old_to_new[i] != DoFHandler<dim>::invalid_dof_index)
+      {
+        Assert (old_to_new[i] == n_kept, ExcInternalError());
+        ++n_kept;
+      }
+
+  std::set<types::global_dof_index> all_dofs;
+  std::vector<types::global_dof_index> indices (dofs_per_cell);
+  unsigned int n_unchanged_cells = 0;
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      cell->get_dof_indices (indices);
+      all_dofs.insert (indices.begin(), indices.end());
+
+      const typename std::map<CellId,std::vector<types::global_dof_index> >::const_iterator
+      p = old_indices.find (cell->id());
+      if (p != old_indices.end())
+        {
+          ++n_unchanged_cells;
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            Assert (indices[i] == old_to_new[p->second[i]], ExcInternalError());
+        }
+    }
+
+  // the numbering must be complete and have the same size as a fresh one
+  Assert (all_dofs.size() == dof_handler.n_dofs(), ExcInternalError());
+  Assert (*all_dofs.rbegin() == dof_handler.n_dofs()-1, ExcInternalError());
+
+  DoFHandler<dim> reference (dof_handler.get_tria());
+  reference.distribute_dofs (dof_handler.get_fe());
+  Assert (reference.n_dofs() == dof_handler.n_dofs(), ExcInternalError());
+
+  deallog << "unchanged cells: " << n_unchanged_cells
+          << ", kept dofs: " << n_kept
+          << " of " << old_to_new.size()
+          << ", new dofs: " << dof_handler.n_dofs() - n_kept
+          << std::endl;
+}
+
+
+
+template <int dim>
+void record (const DoFHandler<dim> &dof_handler,
+             std::map<CellId,std::vector<types::global_dof_index> > &indices)
+{
+  indices.clear ();
+  std::vector<types::global_dof_index> local (dof_handler.get_fe().dofs_per_cell);
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      cell->get_dof_indices (local);
+      indices[cell->id()] = local;
+    }
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+
+  FESystem<dim> fe (FE_Q<dim>(2), 1, FE_Q<dim>(1), 1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.set_incremental_dof_distribution (true);
+  dof_handler.distribute_dofs (fe);
+
+  std::map<CellId,std::vector<types::global_dof_index> > old_indices;
+  std::vector<types::global_dof_index> old_to_new;
+
+  // refine the first cell
+  record (dof_handler, old_indices);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement ();
+  dof_handler.redistribute_dofs (old_to_new);
+  check (dof_handler, old_indices, old_to_new);
+
+  // coarsen the children of the first cell again and refine the last cell
+  record (dof_handler, old_indices);
+  for (unsigned int c=0; c<tria.begin(2)->n_children(); ++c)
+    tria.begin(2)->child(c)->set_coarsen_flag();
+  typename Triangulation<dim>::cell_iterator last_cell = tria.end(2);
+  --last_cell;
+  last_cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement ();
+  dof_handler.redistribute_dofs (old_to_new);
+  check (dof_handler, old_indices, old_to_new);
+
+  // two refinement cycles without redistributing in between: only the
+  // numbering from before the first of them can be kept
+  record (dof_handler, old_indices);
+  tria.begin_active(2)->set_refine_flag();
+  tria.execute_coarsening_and_refinement ();
+  tria.last_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement ();
+  dof_handler.redistribute_dofs (old_to_new);
+  check (dof_handler, old_indices, old_to_new);
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<1>();
+  test<2>();
+  test<3>();
+
+  return 0;
+}
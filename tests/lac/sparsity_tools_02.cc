@@ -0,0 +1,215 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// SparsityTools::reorder_Cuthill_McKee processes the fronts in
+// parallel. compare its result with a straightforward sequential
+// implementation of the algorithm, on graphs large enough that the
+// fronts are split between several tasks, with and without starting
+// indices, and on a graph with two components. also make sure that the
+// result is the same if the tasks may only use one thread
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/lac/sparsity_tools.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/compressed_sparsity_pattern.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+
+#ifdef DEAL_II_WITH_THREADS
+#  include <tbb/task_scheduler_init.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+
+
+typedef SparsityPattern::size_type size_type;
+
+
+size_type
+n_entries (const SparsityPattern &sparsity,
+           const size_type        row)
+{
+  return sparsity.row_length (row);
+}
+
+
+
+// number the graph front by front. each front consists of the as yet
+// unnumbered neighbors of the previous one, sorted by the number of
+// their neighbors and then by index
+void
+reference_Cuthill_McKee (const SparsityPattern        &sparsity,
+                         std::vector<size_type>       &new_indices,
+                         const std::vector<size_type> &starting_indices)
+{
+  const size_type n = sparsity.n_rows();
+  std::fill (new_indices.begin(), new_indices.end(),
+             numbers::invalid_size_type);
+
+  size_type next_free_number = 0;
+  std::vector<size_type> front (starting_indices);
+  while (next_free_number < n)
+    {
+      if (front.empty())
+        {
+          // start a new component at the unnumbered index with the
+          // fewest neighbors
+          size_type start = numbers::invalid_size_type;
+          for (size_type i=0; i<n; ++i)
+            if ((new_indices[i] == numbers::invalid_size_type) &&
+                ((start == numbers::invalid_size_type) ||
+                 (n_entries(sparsity,i) < n_entries(sparsity,start))))
+              start = i;
+          front.push_back (start);
+        }
+
+      for (unsigned int i=0; i<front.size(); ++i)
+        new_indices[front[i]] = next_free_number++;
+
+      std::vector<std::pair<size_type,size_type> > next_front;
+      for (unsigned int i=0; i<front.size(); ++i)
+        for (SparsityPattern::iterator j=sparsity.begin(front[i]);
+             j!=sparsity.end(front[i]); ++j)
+          if (new_indices[j->column()] == numbers::invalid_size_type)
+            next_front.push_back (std::make_pair (n_entries(sparsity, j->column()),
+                                                  j->column()));
+      std::sort (next_front.begin(), next_front.end());
+      next_front.erase (std::unique (next_front.begin(), next_front.end()),
+                        next_front.end());
+
+      front.resize (next_front.size());
+      for (unsigned int i=0; i<next_front.size(); ++i)
+        front[i] = next_front[i].second;
+    }
+}
+
+
+
+void
+reorder (const SparsityPattern        &sparsity,
+         std::vector<size_type>       &new_indices,
+         const std::vector<size_type> &starting_indices,
+         const bool                    single_thread)
+{
+#ifdef DEAL_II_WITH_THREADS
+  // the tasks spawned by this thread only run on this thread
+  tbb::task_scheduler_init init (single_thread ? 1 :
+                                 tbb::task_scheduler_init::automatic);
+#else
+  (void)single_thread;
+#endif
+
+  SparsityTools::reorder_Cuthill_McKee (sparsity, new_indices,
+                                        starting_indices);
+}
+
+
+
+void
+check (const SparsityPattern        &sparsity,
+       const std::vector<size_type> &starting_indices)
+{
+  const size_type n = sparsity.n_rows();
+  std::vector<size_type> reference (n), threaded (n), sequential (n);
+
+  reference_Cuthill_McKee (sparsity, reference, starting_indices);
+  reorder (sparsity, threaded, starting_indices, false);
+  Threads::Thread<> thread
+    = Threads::new_thread (&reorder, sparsity, sequential,
+                           starting_indices, true);
+  thread.join ();
+
+  deallog << n << " rows, " << starting_indices.size()
+          << " starting indices: "
+          << (threaded == reference ? "same" : "different")
+          << ' '
+          << (sequential == reference ? "same" : "different")
+          << std::endl;
+}
+
+
+
+template <int dim>
+void
+make_pattern (const unsigned int n_refinements,
+              const unsigned int n_copies,
+              SparsityPattern   &sparsity)
+{
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube (tr);
+  tr.refine_global (n_refinements);
+  tr.begin_active()->set_refine_flag ();
+  tr.last()->set_refine_flag ();
+  tr.execute_coarsening_and_refinement ();
+
+  FE_Q<dim> fe(2);
+  DoFHandler<dim> dof (tr);
+  dof.distribute_dofs (fe);
+
+  // the refined cells give rows of many different lengths, so that
+  // there are many different coordination numbers
+  const types::global_dof_index n_dofs = dof.n_dofs();
+  CompressedSparsityPattern csp (n_dofs);
+  DoFTools::make_sparsity_pattern (dof, csp);
+
+  CompressedSparsityPattern copies (n_copies*n_dofs);
+  for (unsigned int c=0; c<n_copies; ++c)
+    for (types::global_dof_index i=0; i<n_dofs; ++i)
+      for (CompressedSparsityPattern::row_iterator
+           j = csp.row_begin(i); j != csp.row_end(i); ++j)
+        copies.add (c*n_dofs+i, c*n_dofs+*j);
+  sparsity.copy_from (copies);
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  SparsityPattern sparsity;
+  std::vector<size_type> starting_indices;
+
+  make_pattern<2> (6, 1, sparsity);
+  check (sparsity, starting_indices);
+  starting_indices.push_back (sparsity.n_rows()/2);
+  starting_indices.push_back (sparsity.n_rows()/3);
+  check (sparsity, starting_indices);
+
+  make_pattern<3> (3, 1, sparsity);
+  starting_indices.clear ();
+  check (sparsity, starting_indices);
+  starting_indices.push_back (7);
+  check (sparsity, starting_indices);
+
+  // two unconnected copies of the same graph
+  make_pattern<3> (3, 2, sparsity);
+  starting_indices.clear ();
+  check (sparsity, starting_indices);
+}
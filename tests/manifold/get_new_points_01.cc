@@ -0,0 +1,102 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that the array variant of Manifold::get_new_point() and the
+// batched Manifold::get_new_points() give the same points as
+// get_new_point() with a Quadrature object
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/table.h>
+#include <deal.II/grid/manifold_lib.h>
+
+#include <fstream>
+#include <cmath>
+#include <vector>
+
+
+
+template <int dim, int spacedim>
+void test (const Manifold<dim,spacedim> &manifold,
+           const std::vector<Point<spacedim> > &points,
+           const std::string &name)
+{
+  const unsigned int n_points = points.size();
+
+  Table<2,double> weights (3, n_points);
+  for (unsigned int i=0; i<n_points; ++i)
+    weights[0][i] = 1./n_points;
+  weights[1][0] = weights[1][1] = .5;
+  for (unsigned int i=0; i<n_points; ++i)
+    weights[2][i] = (i+1.) / (n_points*(n_points+1)/2);
+
+  std::vector<Point<spacedim> > new_points;
+  manifold.get_new_points (points, weights, new_points);
+  Assert (new_points.size() == 3, ExcInternalError());
+
+  for (unsigned int r=0; r<3; ++r)
+    {
+      const std::vector<double> w (&weights[r][0], &weights[r][0]+n_points);
+      const Point<spacedim> p_quad
+        = manifold.get_new_point (Quadrature<spacedim>(points, w));
+      const Point<spacedim> p_array
+        = manifold.get_new_point (&points[0], &w[0], n_points);
+
+      Assert (p_quad.distance(p_array) < 1e-12, ExcInternalError());
+      Assert (p_quad.distance(new_points[r]) < 1e-12, ExcInternalError());
+    }
+
+  deallog << name << " dim=" << dim << ", spacedim=" << spacedim
+          << ": OK" << std::endl;
+}
+
+
+
+template <int spacedim>
+std::vector<Point<spacedim> > get_points ()
+{
+  std::vector<Point<spacedim> > points (4);
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      const double angle = 0.1 + 0.3*i;
+      points[i][0] = (1.+0.1*i) * std::cos(angle);
+      points[i][1] = (1.+0.1*i) * std::sin(angle);
+      if (spacedim == 3)
+        points[i][spacedim-1] = 0.2*i;
+    }
+  return points;
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test (FlatManifold<2,2>(), get_points<2>(), "FlatManifold");
+  test (FlatManifold<3,3>(), get_points<3>(), "FlatManifold");
+  test (SphericalManifold<2,2>(), get_points<2>(), "SphericalManifold");
+  test (SphericalManifold<3,3>(), get_points<3>(), "SphericalManifold");
+  test (CylindricalManifold<3,3>(2), get_points<3>(), "CylindricalManifold");
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// the midpoints of the lines that are refined are computed in parallel
+// if all manifolds involved are thread safe, and one after the other
+// otherwise. refine curved meshes, described by a Boundary and a manifold
+// of the library and a manifold derived from ChartManifold in this test
+// (which is not thread safe), as well as by StraightBoundary,
+// SphericalManifold and FlatManifold (which all are), once with the
+// default number of threads and once on a thread whose task scheduler
+// only allows one thread, and check that the vertices are the same
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_boundary_lib.h>
+#include <deal.II/grid/manifold_lib.h>
+
+#ifdef DEAL_II_WITH_THREADS
+#  include <tbb/task_scheduler_init.h>
+#endif
+
+#include <fstream>
+#include <cmath>
+
+
+// a manifold that maps the x-axis onto a sine wave
+template <int dim>
+class WavyManifold : public ChartManifold<dim,dim,dim>
+{
+public:
+  virtual Point<dim>
+  pull_back (const Point<dim> &space_point) const
+  {
+    Point<dim> p = space_point;
+    p[1] -= 0.1 * std::sin (3 * space_point[0]);
+    return p;
+  }
+
+  virtual Point<dim>
+  push_forward (const Point<dim> &chart_point) const
+  {
+    Point<dim> p = chart_point;
+    p[1] += 0.1 * std::sin (3 * chart_point[0]);
+    return p;
+  }
+};
+
+
+
+template <int dim>
+void make_mesh (Triangulation<dim>   &tria,
+                const Boundary<dim>  &boundary,
+                const Manifold<dim>  &manifold,
+                const Manifold<dim>  &wavy_manifold)
+{
+  GridGenerator::hyper_ball (tria);
+
+  // the boundary is described by the Boundary object, the cells at the
+  // boundary by the spherical manifold of the library, and the central
+  // cell by the manifold above
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (cell->at_boundary())
+      {
+        cell->set_all_manifold_ids (1);
+        for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+          if (cell->face(f)->at_boundary())
+            cell->face(f)->set_all_manifold_ids (numbers::invalid_manifold_id);
+      }
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (cell->at_boundary() == false)
+      cell->set_all_manifold_ids (2);
+
+  tria.set_boundary (0, boundary);
+  tria.set_manifold (1, manifold);
+  tria.set_manifold (2, wavy_manifold);
+}
+
+
+
+template <int dim>
+void refine (Triangulation<dim> &tria,
+             const bool          single_thread)
+{
+#ifdef DEAL_II_WITH_THREADS
+  // the tasks spawned by this thread only run on this thread
+  tbb::task_scheduler_init init (single_thread ? 1 :
+                                 tbb::task_scheduler_init::automatic);
+#else
+  (void)single_thread;
+#endif
+
+  tria.refine_global (1);
+  for (unsigned int step=0; step<(dim == 2 ? 3 : 1); ++step)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+        if (index % 3 == 0)
+          cell->set_refine_flag ();
+      tria.execute_coarsening_and_refinement ();
+    }
+}
+
+
+
+template <int dim>
+void test (const Boundary<dim> &boundary,
+           const Manifold<dim> &manifold,
+           const Manifold<dim> &wavy_manifold)
+{
+  deallog << "thread safe: " << boundary.is_thread_safe()
+          << manifold.is_thread_safe()
+          << wavy_manifold.is_thread_safe() << std::endl;
+
+  Triangulation<dim> tria, tria_1;
+  make_mesh (tria, boundary, manifold, wavy_manifold);
+  make_mesh (tria_1, boundary, manifold, wavy_manifold);
+
+  refine (tria, false);
+  Threads::Thread<> thread
+    = Threads::new_thread (&refine<dim>, tria_1, true);
+  thread.join ();
+
+  double max_distance = 0, sum_norms = 0;
+  for (unsigned int v=0; v<tria.n_vertices(); ++v)
+    if (tria.vertex_used (v))
+      {
+        max_distance = std::max (max_distance,
+                                 tria.get_vertices()[v].distance (tria_1.get_vertices()[v]));
+        sum_norms += tria.get_vertices()[v].norm();
+      }
+
+  deallog << dim << "d: " << tria.n_active_cells() << " cells, "
+          << tria.n_used_vertices() << " vertices, sum of norms "
+          << sum_norms << ", largest distance with one thread "
+          << max_distance << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  const HyperBallBoundary<dim>     boundary;
+  const SphericalManifold<dim,dim> manifold;
+  WavyManifold<dim>                wavy_manifold;
+  test (boundary, manifold, wavy_manifold);
+
+  const StraightBoundary<dim>      straight_boundary;
+  const FlatManifold<dim>          flat_manifold;
+  test (straight_boundary, manifold, flat_manifold);
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<2> ();
+  test<3> ();
+}
@@ -0,0 +1,90 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests DoFRenumbering::matrix_free_data_locality: after renumbering, the
+// degrees of freedom must be numbered in the order in which the cell loop of
+// MatrixFree first touches them. Then check that the matrix-vector product
+// on the renumbered DoFHandler still gives the same result as the sparse
+// matrix. The mesh contains hanging nodes.
+
+#include "../tests.h"
+#include <deal.II/dofs/dof_renumbering.h>
+
+std::ofstream logfile("output");
+
+#include "matrix_vector_common.h"
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global(1);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.refine_global(3-dim);
+
+  FE_Q<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs(fe);
+
+  {
+    ConstraintMatrix constraints;
+    constraints.close();
+    MatrixFree<dim,double> mf_data;
+    typename MatrixFree<dim,double>::AdditionalData data;
+    data.tasks_parallel_scheme =
+      MatrixFree<dim,double>::AdditionalData::partition_color;
+    data.tasks_block_size = 3;
+    mf_data.reinit (dof, constraints, QGauss<1>(fe_degree+1), data);
+
+    DoFRenumbering::matrix_free_data_locality (dof, mf_data);
+
+    // go through the cells in the same order again and check that the
+    // first touch of each degree of freedom gives the next number
+    std::vector<bool> touched (dof.n_dofs(), false);
+    std::vector<types::global_dof_index> dof_indices (fe.dofs_per_cell);
+    types::global_dof_index next = 0;
+    bool ordered = true;
+    for (unsigned int macro=0; macro<mf_data.n_macro_cells(); ++macro)
+      for (unsigned int v=0; v<mf_data.n_components_filled(macro); ++v)
+        {
+          typename DoFHandler<dim>::cell_iterator
+          cell = mf_data.get_cell_iterator(macro, v);
+          cell->get_dof_indices (dof_indices);
+          for (unsigned int i=0; i<dof_indices.size(); ++i)
+            if (touched[dof_indices[i]] == false)
+              {
+                touched[dof_indices[i]] = true;
+                if (dof_indices[i] != next)
+                  ordered = false;
+                ++next;
+              }
+        }
+    deallog << "Number of DoFs: " << dof.n_dofs() << std::endl;
+    deallog << "Numbered in cell loop order: "
+            << (ordered && next == dof.n_dofs() ? "yes" : "no") << std::endl;
+  }
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  constraints.close();
+
+  do_test<dim, fe_degree, double> (dof, constraints);
+}
@@ -0,0 +1,108 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that parallel::distributed::Triangulation::cell_weight is used to
+// partition the mesh, both when refining the mesh and when calling
+// repartition()
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/std_cxx1x/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <fstream>
+
+
+// cells in the upper half of the domain are twice as expensive as the
+// others
+template <int dim>
+unsigned int
+cell_weight (const typename parallel::distributed::Triangulation<dim>::cell_iterator &cell,
+             const typename parallel::distributed::Triangulation<dim>::CellStatus)
+{
+  return (cell->center()[dim-1] < 0.5 ? 1 : 2);
+}
+
+
+
+template <int dim>
+void print_partition (const parallel::distributed::Triangulation<dim> &tr,
+                      const std::string &label)
+{
+  const std::vector<unsigned int> n_cells
+    = tr.n_locally_owned_active_cells_per_processor ();
+  if (Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) == 0)
+    {
+      deallog << label << ":";
+      for (unsigned int p=0; p<n_cells.size(); ++p)
+        deallog << ' ' << n_cells[p];
+      deallog << std::endl;
+    }
+}
+
+
+
+template<int dim>
+void test()
+{
+  parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global (3);
+  print_partition (tr, "without weights");
+
+  // repartition with weights
+  tr.cell_weight.connect (std_cxx1x::bind (&cell_weight<dim>,
+                                           std_cxx1x::_1,
+                                           std_cxx1x::_2));
+  tr.repartition ();
+  print_partition (tr, "after repartition()");
+
+  // refining all cells keeps the relative weights
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tr.begin_active(); cell != tr.end(); ++cell)
+    if (cell->is_locally_owned())
+      cell->set_refine_flag ();
+  tr.execute_coarsening_and_refinement ();
+  print_partition (tr, "after refinement");
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  if (Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-10);
+
+      deallog.push("2d");
+      test<2>();
+      deallog.pop();
+    }
+  else
+    test<2>();
+}
@@ -0,0 +1,197 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+
+// check that DataOutFaces and DataOutRotation only create patches for
+// locally owned cells of a parallel::distributed::Triangulation, that they
+// look up cell data for the right cells although ghost and artificial cells
+// are interspersed with the locally owned ones, and that their output can
+// be written with write_vtu_in_parallel()
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out_faces.h>
+#include <deal.II/numerics/data_out_rotation.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+
+// give access to the patches
+template <class DataOutType>
+class Test : public DataOutType
+{
+public:
+  Test () {}
+
+  Test (const bool surface_only)
+    :
+    DataOutType (surface_only)
+  {}
+
+  const std::vector<typename DataOutType::Patch> &
+  patches () const
+  {
+    return this->get_patches();
+  }
+};
+
+
+
+// return the total number of cells in a VTU file
+unsigned int n_vtu_cells (const std::string &filename)
+{
+  std::ifstream in (filename.c_str());
+  std::stringstream s;
+  s << in.rdbuf();
+  const std::string vtu = s.str();
+
+  unsigned int n_cells = 0;
+  for (std::string::size_type p = vtu.find ("NumberOfCells=\""); p != std::string::npos;
+       p = vtu.find ("NumberOfCells=\"", p+1))
+    n_cells += std::atoi (vtu.c_str() + p + 15);
+  return n_cells;
+}
+
+
+
+// check that the cell data value on each patch, which is the radial
+// coordinate of the center of the cell, is within half a cell width of the
+// radial coordinate of the vertices of the patch. the radial coordinate of
+// a vertex is the norm of its coordinates first_component to
+// last_component
+template <int dim, int spacedim>
+bool check_cell_data (const std::vector<DataOutBase::Patch<dim,spacedim> > &patches,
+                      const unsigned int first_component,
+                      const unsigned int last_component,
+                      const double h)
+{
+  for (unsigned int p=0; p<patches.size(); ++p)
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      {
+        const Point<spacedim> &x = patches[p].vertices[v];
+        double r = 0;
+        for (unsigned int d=first_component; d<=last_component; ++d)
+          r += x[d] * x[d];
+        if (std::fabs (std::sqrt(r) - patches[p].data(1,0)) > h/2 + 1e-6)
+          return false;
+      }
+  return true;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  const MPI_Comm comm = MPI_COMM_WORLD;
+
+  parallel::distributed::Triangulation<dim> tria (comm);
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (3);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  solution = 1;
+
+  Vector<double> cell_data (tria.n_active_cells());
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+    cell_data(index) = cell->center()[0];
+
+  const double h = 1./8;
+
+  for (unsigned int i=0; i<2; ++i)
+    {
+      const bool surface_only = (i == 0);
+      Test<DataOutFaces<dim> > data_out_faces (surface_only);
+      data_out_faces.attach_dof_handler (dof_handler);
+      data_out_faces.add_data_vector (solution, "solution");
+      data_out_faces.add_data_vector (cell_data, "cell_data");
+      data_out_faces.build_patches ();
+
+      const unsigned int n_patches
+        = Utilities::MPI::sum (static_cast<unsigned int>(data_out_faces.patches().size()),
+                              comm);
+      const unsigned int n_wrong
+        = Utilities::MPI::sum (check_cell_data (data_out_faces.patches(), 0, 0, h) ? 0U : 1U,
+                               comm);
+
+      data_out_faces.write_vtu_in_parallel ("faces.vtu", comm);
+      if (Utilities::MPI::this_mpi_process (comm) == 0)
+        deallog << (surface_only ? "boundary faces: " : "all faces: ")
+                << n_patches << " patches, "
+                << n_vtu_cells ("faces.vtu") << " cells in VTU file, cell data "
+                << (n_wrong == 0 ? "correct" : "wrong")
+                << std::endl;
+    }
+
+  Test<DataOutRotation<dim> > data_out_rotation;
+  data_out_rotation.attach_dof_handler (dof_handler);
+  data_out_rotation.add_data_vector (solution, "solution");
+  data_out_rotation.add_data_vector (cell_data, "cell_data");
+  data_out_rotation.build_patches (4);
+
+  const unsigned int n_patches
+    = Utilities::MPI::sum (static_cast<unsigned int>(data_out_rotation.patches().size()),
+                          comm);
+  const unsigned int n_wrong
+    = Utilities::MPI::sum (check_cell_data (data_out_rotation.patches(), 1, 2, h) ? 0U : 1U,
+                           comm);
+
+  data_out_rotation.write_vtu_in_parallel ("rotation.vtu", comm);
+  if (Utilities::MPI::this_mpi_process (comm) == 0)
+    deallog << "rotation: " << n_patches << " patches, "
+            << n_vtu_cells ("rotation.vtu") << " cells in VTU file, cell data "
+            << (n_wrong == 0 ? "correct" : "wrong")
+            << std::endl;
+}
+
+
+
+int main (int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  if (Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) == 0)
+    {
+      std::ofstream logfile ("output");
+      deallog.attach (logfile);
+      deallog.depth_console (0);
+      deallog.threshold_double (1.e-10);
+
+      test<2>();
+    }
+  else
+    test<2>();
+}
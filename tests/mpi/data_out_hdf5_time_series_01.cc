@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests XDMFTimeSeries: the mesh must only be written to the HDF5 file
+// when it has changed, and every entry of the XDMF file must reference
+// the mesh that was current at its time step
+
+#include "../tests.h"
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+
+
+void
+write_step (const Triangulation<2> &tria,
+            const double            time,
+            XDMFTimeSeries<2>      &time_series)
+{
+  FE_Q<2> fe(1);
+  DoFHandler<2> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  Vector<double> v(dof_handler.n_dofs());
+  for (unsigned int i=0; i<v.size(); ++i)
+    v(i) = i*time;
+
+  DataOut<2> data_out;
+  data_out.add_data_vector (dof_handler, v, "linear");
+  data_out.build_patches ();
+
+  time_series.write_time_step (data_out, time);
+
+  deallog << "time=" << time
+          << ", time steps: " << time_series.n_time_steps()
+          << ", meshes: " << time_series.n_meshes()
+          << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll log;
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global (1);
+
+  XDMFTimeSeries<2> time_series ("out.h5", "out.xdmf", MPI_COMM_WORLD, 6);
+  write_step (tria, 0., time_series);
+  write_step (tria, 0.5, time_series);
+  tria.refine_global (1);
+  write_step (tria, 1., time_series);
+
+  // the HDF5 file is binary, so only print the datasets the XDMF file
+  // references
+  if (Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) == 0)
+    {
+      std::ifstream xdmf ("out.xdmf");
+      std::string line;
+      while (std::getline (xdmf, line))
+        if (line.find ("out.h5:") != std::string::npos)
+          deallog << line.substr (line.find ("out.h5:")) << std::endl;
+    }
+}
@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write_vtu_in_parallel writes the pieces of all processors with one
+// collective call at offsets computed by a prefix sum. check that the
+// file is the concatenation of the header, the pieces of all processors
+// in the order of their ranks, and the footer, with and without asking
+// for a number of aggregators. the pieces of the processors have
+// different sizes
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/function_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+
+
+template<int dim>
+void test()
+{
+  const unsigned int myid  = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int nproc = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  // every processor writes its own mesh, shifted by its rank and
+  // refined according to it
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube (tr);
+  tr.refine_global (1 + myid%2);
+  Point<dim> shift;
+  shift[0] = myid;
+  GridTools::shift (shift, tr);
+
+  FE_Q<dim> fe(1);
+  DoFHandler<dim> dof_handler (tr);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> x (dof_handler.n_dofs());
+  VectorTools::interpolate (dof_handler, Functions::CosineFunction<dim>(), x);
+
+  DataOutBase::VtkFlags flags;
+  flags.print_date_and_time = false;
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (x, "x");
+  data_out.build_patches ();
+  data_out.set_flags (flags);
+
+  // the expected contents of the file: the first processor contributes
+  // the header, the last one the footer, and all of them what lies in
+  // between when they write a file of their own
+  std::ostringstream whole, header, footer;
+  data_out.write_vtu (whole);
+  DataOutBase::write_vtu_header (header, flags);
+  DataOutBase::write_vtu_footer (footer);
+
+  std::string my_piece = whole.str();
+  AssertThrow (my_piece.compare (0, header.str().size(), header.str()) == 0,
+               ExcInternalError());
+  if (myid != nproc-1)
+    my_piece.erase (my_piece.size() - footer.str().size());
+  if (myid != 0)
+    my_piece.erase (0, header.str().size());
+
+  int my_size = my_piece.size();
+  std::vector<int> sizes (nproc), offsets (nproc);
+  MPI_Gather (&my_size, 1, MPI_INT, &sizes[0], 1, MPI_INT, 0, MPI_COMM_WORLD);
+  for (unsigned int p=1; p<nproc; ++p)
+    offsets[p] = offsets[p-1] + sizes[p-1];
+  std::vector<char> expected (offsets[nproc-1] + sizes[nproc-1]);
+  MPI_Gatherv (const_cast<char *>(my_piece.c_str()), my_size, MPI_CHAR,
+               &expected[0], &sizes[0], &offsets[0], MPI_CHAR,
+               0, MPI_COMM_WORLD);
+
+  for (unsigned int n_aggregators=0; n_aggregators<3; n_aggregators+=2)
+    {
+      data_out.write_vtu_in_parallel ("output.vtu", MPI_COMM_WORLD,
+                                      n_aggregators);
+      MPI_Barrier (MPI_COMM_WORLD);
+
+      if (myid == 0)
+        {
+          std::ifstream in ("output.vtu");
+          const std::string file ((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+          deallog << n_aggregators << " aggregators: "
+                  << (file == std::string (expected.begin(), expected.end())
+                      ?
+                      "file is the concatenation of all pieces"
+                      :
+                      "file differs from the concatenation of all pieces")
+                  << std::endl;
+        }
+      MPI_Barrier (MPI_COMM_WORLD);
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  if (Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-10);
+
+      test<2>();
+    }
+  else
+    test<2>();
+}
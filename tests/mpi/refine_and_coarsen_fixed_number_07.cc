@@ -0,0 +1,212 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compare the number of cells flagged by
+// parallel::distributed::GridRefinement::refine_and_coarsen_fixed_number
+// with a reference that computes the thresholds by sorting all
+// indicators. test indicators with many ties, fractions of 0 and 1, and
+// a mesh with a single cell, so that all but one processor own no
+// cells at all
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/distributed/grid_refinement.h>
+
+#include <fstream>
+#include <algorithm>
+#include <limits>
+
+
+// the indicator of a cell. with n_values>0, only this many
+// different values appear, so that there are many ties
+template <int dim>
+float indicator (const Point<dim>  &center,
+                 const unsigned int n_values)
+{
+  const double x = center[0] + 0.3*center[dim-1]*center[dim-1];
+  if (n_values > 0)
+    return 1 + std::floor (n_values * x / 1.3);
+  else
+    return 1 + 100*x;
+}
+
+
+
+// split the sorted list of all indicators the same way as the
+// library function is supposed to, and count the cells that are
+// flagged for refinement and coarsening, respectively
+void reference (std::vector<float> values,
+                const double       top_fraction,
+                const double       bottom_fraction,
+                unsigned int      &n_refined,
+                unsigned int      &n_coarsened)
+{
+  std::sort (values.begin(), values.end());
+
+  const unsigned int n_cells  = values.size(),
+                     n_refine = static_cast<unsigned int>(top_fraction * n_cells),
+                     n_keep   = static_cast<unsigned int>((1-bottom_fraction) * n_cells);
+
+  double top_threshold = std::numeric_limits<double>::max();
+  if (n_refine == n_cells)
+    top_threshold = values[0];
+  else if (n_refine > 0)
+    {
+      const float lower = values[n_cells-n_refine-1],
+                  upper = values[n_cells-n_refine];
+      top_threshold = (lower < upper ? (lower+upper)/2. : upper);
+    }
+
+  double bottom_threshold = -std::numeric_limits<double>::max();
+  if (n_keep == 0)
+    bottom_threshold = values[n_cells-1];
+  else if ((n_keep < n_cells) && (bottom_fraction > 0))
+    {
+      const float lower = values[n_cells-n_keep-1],
+                  upper = values[n_cells-n_keep];
+      bottom_threshold = (lower < upper ? (lower+upper)/2. : upper);
+    }
+
+  n_refined   = 0;
+  n_coarsened = 0;
+  for (unsigned int i=0; i<n_cells; ++i)
+    if (values[i] >= top_threshold)
+      ++n_refined;
+    else if (values[i] <= bottom_threshold)
+      ++n_coarsened;
+}
+
+
+
+template <int dim>
+void check (const unsigned int n_refinements,
+            const unsigned int n_values,
+            const double       top_fraction,
+            const double       bottom_fraction)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+
+  parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube (tr);
+  tr.refine_global (n_refinements);
+
+  Vector<float> indicators (tr.dealii::Triangulation<dim>::n_active_cells());
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tr.begin_active(); cell != tr.end(); ++cell, ++index)
+    if (cell->is_locally_owned())
+      indicators(index) = indicator (cell->center(), n_values);
+
+  parallel::distributed::GridRefinement
+  ::refine_and_coarsen_fixed_number (tr, indicators,
+                                     top_fraction, bottom_fraction);
+
+  unsigned int my_refined   = 0,
+               my_coarsened = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tr.begin_active(); cell != tr.end(); ++cell)
+    if (cell->refine_flag_set())
+      ++my_refined;
+    else if (cell->coarsen_flag_set())
+      ++my_coarsened;
+
+  const unsigned int
+  n_refined   = Utilities::MPI::sum (my_refined, MPI_COMM_WORLD),
+  n_coarsened = Utilities::MPI::sum (my_coarsened, MPI_COMM_WORLD);
+
+  // every processor builds the same sequential mesh to get at all
+  // indicators
+  Triangulation<dim> serial_tr;
+  GridGenerator::hyper_cube (serial_tr);
+  serial_tr.refine_global (n_refinements);
+
+  std::vector<float> all_indicators;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = serial_tr.begin_active(); cell != serial_tr.end(); ++cell)
+    all_indicators.push_back (indicator (cell->center(), n_values));
+
+  unsigned int n_refined_reference, n_coarsened_reference;
+  reference (all_indicators, top_fraction, bottom_fraction,
+             n_refined_reference, n_coarsened_reference);
+
+  if (myid == 0)
+    deallog << dim << "d, " << all_indicators.size() << " cells, "
+            << (n_values > 0 ? n_values : all_indicators.size())
+            << " values, fractions " << top_fraction << ' ' << bottom_fraction
+            << ": refined " << n_refined << " (" << n_refined_reference
+            << "), coarsened " << n_coarsened << " ("
+            << n_coarsened_reference << ")" << std::endl;
+}
+
+
+
+void test()
+{
+  // distinct indicators
+  check<2> (3, 0, 0.3, 0.1);
+  check<3> (2, 0, 0.3, 0.1);
+
+  // ties
+  check<2> (3, 5, 0.3, 0.1);
+  check<2> (3, 5, 0.5, 0.5);
+  check<3> (2, 3, 0.2, 0.2);
+  check<2> (4, 1, 0.3, 0.3);
+
+  // nothing or everything
+  check<2> (3, 0, 0, 0);
+  check<2> (3, 0, 1, 0);
+  check<2> (3, 0, 0, 1);
+  check<2> (3, 5, 1, 0);
+  check<2> (3, 5, 0, 1);
+
+  // a single cell, owned by only one processor
+  check<2> (0, 0, 0.3, 0.1);
+  check<2> (0, 0, 1, 0);
+  check<2> (0, 0, 0, 1);
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+
+
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-10);
+
+      test();
+    }
+  else
+    test();
+
+}
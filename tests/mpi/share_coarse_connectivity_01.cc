@@ -0,0 +1,127 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that parallel::distributed::Triangulation gives the same mesh with
+// and without the share_coarse_connectivity_within_node flag
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <fstream>
+
+
+template<int dim>
+void test()
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+
+  std::vector<unsigned int> repetitions (dim, 3);
+  Point<dim> p1, p2;
+  for (unsigned int d=0; d<dim; ++d)
+    p2[d] = 1.+d;
+
+  parallel::distributed::Triangulation<dim> tr_1 (MPI_COMM_WORLD);
+  parallel::distributed::Triangulation<dim>
+  tr_2 (MPI_COMM_WORLD,
+        Triangulation<dim>::none,
+        parallel::distributed::Triangulation<dim>::share_coarse_connectivity_within_node);
+
+  GridGenerator::subdivided_hyper_rectangle (tr_1, repetitions, p1, p2);
+  GridGenerator::subdivided_hyper_rectangle (tr_2, repetitions, p1, p2);
+
+  tr_1.refine_global (2);
+  tr_2.refine_global (2);
+  {
+    const unsigned int checksum_1 = tr_1.get_checksum ();
+    const unsigned int checksum_2 = tr_2.get_checksum ();
+    if (myid == 0)
+      deallog << "cells: " << tr_2.n_global_active_cells()
+              << ", checksums "
+              << (checksum_1 == checksum_2 ? "match" : "differ")
+              << std::endl;
+  }
+
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+
+      // refine the cells close to the origin once more
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tr_1.begin_active(); cell != tr_1.end(); ++cell)
+        if (cell->is_locally_owned() && cell->center().norm() < 0.5)
+          cell->set_refine_flag ();
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tr_2.begin_active(); cell != tr_2.end(); ++cell)
+        if (cell->is_locally_owned() && cell->center().norm() < 0.5)
+          cell->set_refine_flag ();
+      tr_1.execute_coarsening_and_refinement ();
+      tr_2.execute_coarsening_and_refinement ();
+
+      Assert (tr_1.n_locally_owned_active_cells() ==
+              tr_2.n_locally_owned_active_cells(),
+              ExcInternalError());
+
+      const unsigned int checksum_1 = tr_1.get_checksum ();
+      const unsigned int checksum_2 = tr_2.get_checksum ();
+      if (myid == 0)
+        deallog << "cycle " << cycle << ": checksums "
+                << (checksum_1 == checksum_2 ? "match" : "differ")
+                << std::endl;
+    }
+
+  // the triangulations must also be usable after clearing and recreating
+  tr_2.clear ();
+  GridGenerator::subdivided_hyper_rectangle (tr_2, repetitions, p1, p2);
+  if (myid == 0)
+    deallog << "cells after recreation: " << tr_2.n_global_active_cells()
+            << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+
+  if (myid == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-10);
+
+      deallog.push("2d");
+      test<2>();
+      deallog.pop();
+
+      deallog.push("3d");
+      test<3>();
+      deallog.pop();
+    }
+  else
+    {
+      test<2>();
+      test<3>();
+    }
+}
@@ -0,0 +1,229 @@
+// ---------------------------------------------------------------------
+// $Id$
+//
+// Copyright (C) 2014 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check Triangulation::save_snapshot/load_snapshot and the corresponding
+// functions of DoFHandler
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace dealii
+{
+  template <int dim, int spacedim>
+  bool operator == (const Triangulation<dim,spacedim> &t1,
+                    const Triangulation<dim,spacedim> &t2)
+  {
+    // test a few attributes, though we can't
+    // test everything unfortunately...
+    if (t1.n_active_cells() != t2.n_active_cells())
+      return false;
+
+    if (t1.n_cells() != t2.n_cells())
+      return false;
+
+    if (t1.n_faces() != t2.n_faces())
+      return false;
+
+    typename Triangulation<dim,spacedim>::cell_iterator
+    c1 = t1.begin(),
+    c2 = t2.begin();
+    for (; (c1 != t1.end()) && (c2 != t2.end()); ++c1, ++c2)
+      {
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            if (c1->vertex(v) != c2->vertex(v))
+              return false;
+            if (c1->vertex_index(v) != c2->vertex_index(v))
+              return false;
+          }
+
+        for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            if (c1->face(f)->at_boundary() != c2->face(f)->at_boundary())
+              return false;
+
+            if (c1->face(f)->manifold_id() != c2->face(f)->manifold_id())
+              return false;
+
+            if (c1->face(f)->at_boundary())
+              {
+                if (c1->face(f)->boundary_indicator() !=
+                    c2->face(f)->boundary_indicator())
+                  return false;
+              }
+            else
+              {
+                if (c1->neighbor(f)->level() != c2->neighbor(f)->level())
+                  return false;
+                if (c1->neighbor(f)->index() != c2->neighbor(f)->index())
+                  return false;
+              }
+          }
+
+        if (c1->active() && c2->active()
+            && (c1->subdomain_id() != c2->subdomain_id()))
+          return false;
+
+        if (c1->level_subdomain_id() != c2->level_subdomain_id())
+          return false;
+
+        if (c1->material_id() != c2->material_id())
+          return false;
+
+        if (c1->user_index() != c2->user_index())
+          return false;
+
+        if (c1->user_flag_set() != c2->user_flag_set())
+          return false;
+
+        if (c1->manifold_id() != c2->manifold_id())
+          return false;
+      }
+
+    // also check the order of raw iterators as they contain
+    // something about the history of the triangulation
+    typename Triangulation<dim,spacedim>::cell_iterator
+    r1 = t1.begin(),
+    r2 = t2.begin();
+    for (; (r1 != t1.end()) && (r2 != t2.end()); ++r1, ++r2)
+      {
+        if (r1->level() != r2->level())
+          return false;
+        if (r1->index() != r2->index())
+          return false;
+      }
+
+    return true;
+  }
+}
+
+
+template <int dim, int spacedim>
+void do_boundary (Triangulation<dim,spacedim> &t1)
+{
+  typename Triangulation<dim,spacedim>::cell_iterator
+  c1 = t1.begin();
+  for (; c1 != t1.end(); ++c1)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      if (c1->at_boundary(f))
+        {
+          c1->face(f)->set_boundary_indicator (42);
+          c1->face(f)->set_manifold_id (43);
+        }
+}
+
+
+template <int spacedim>
+void do_boundary (Triangulation<1,spacedim> &)
+{}
+
+
+template <int dim, int spacedim>
+void test ()
+{
+  Triangulation<dim,spacedim> tria_1, tria_2;
+
+  GridGenerator::hyper_cube (tria_1);
+  tria_1.refine_global (2);
+  tria_1.begin_active()->set_subdomain_id (1);
+  tria_1.begin_active()->set_level_subdomain_id (4);
+  tria_1.begin_active()->set_material_id (2);
+  tria_1.begin_active()->set_user_index (3);
+  tria_1.begin_active()->set_user_flag ();
+  tria_1.begin_active()->set_refine_flag (RefinementCase<dim>::cut_x);
+  tria_1.last_active()->set_manifold_id (5);
+
+  do_boundary (tria_1);
+
+  std::ostringstream tria_snapshot;
+  tria_1.save_snapshot (tria_snapshot);
+
+  std::istringstream tria_in (tria_snapshot.str());
+  tria_2.load_snapshot (tria_in);
+  Assert (tria_1 == tria_2, ExcInternalError());
+  Assert (tria_2.last_active()->manifold_id() == 5, ExcInternalError());
+
+  // save a renumbered DoFHandler and read the numbering back into a
+  // second one on the loaded triangulation
+  FE_Q<dim,spacedim> fe (2);
+  DoFHandler<dim,spacedim> dof_1 (tria_1);
+  DoFHandler<dim,spacedim> dof_2 (tria_2);
+  dof_1.distribute_dofs (fe);
+  dof_2.distribute_dofs (fe);
+  DoFRenumbering::Cuthill_McKee (dof_1);
+
+  std::ostringstream dof_snapshot;
+  dof_1.save_snapshot (dof_snapshot);
+  std::istringstream dof_in (dof_snapshot.str());
+  dof_2.load_snapshot (dof_in);
+
+  std::vector<types::global_dof_index> indices_1 (fe.dofs_per_cell);
+  std::vector<types::global_dof_index> indices_2 (fe.dofs_per_cell);
+  typename DoFHandler<dim,spacedim>::active_cell_iterator
+  c1 = dof_1.begin_active(),
+  c2 = dof_2.begin_active();
+  for (; c1 != dof_1.end(); ++c1, ++c2)
+    {
+      c1->get_dof_indices (indices_1);
+      c2->get_dof_indices (indices_2);
+      Assert (indices_1 == indices_2, ExcInternalError());
+    }
+
+  // a triangulation snapshot must not be accepted by a DoFHandler
+  std::istringstream wrong_in (tria_snapshot.str());
+  try
+    {
+      dof_2.load_snapshot (wrong_in);
+    }
+  catch (const ExceptionBase &)
+    {
+      deallog << "rejected triangulation snapshot" << std::endl;
+    }
+
+  deallog << "dim=" << dim << ", spacedim=" << spacedim
+          << ": " << dof_2.n_dofs() << " dofs" << std::endl;
+}
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog << std::setprecision(3);
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test<1,1> ();
+  test<1,2> ();
+  test<2,2> ();
+  test<2,3> ();
+  test<3,3> ();
+
+  deallog << "OK" << std::endl;
+}